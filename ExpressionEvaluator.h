@@ -13,109 +13,92 @@
 #include <cctype>     // 字符类型判断
 #include <memory>     // 智能指针
 #include <stdexcept>  // 标准异常
+#include "error_type.h"           // 错误类型枚举
+#include "expression_type.h"      // 表达式类型枚举
+#include "char_table.h"           // 共享的字符分类与优先级表
+#include "expression_compiler.h"  // 共享的运算实现
 
 using namespace std;  // 使用标准命名空间
 
-// 数学常量定义
-const double PI = 3.14159265358979323846;    // 圆周率
-const double E = 2.71828182845904523536;     // 自然对数的底
+/*求值器框架：中缀、前缀、后缀三个求值器共用同一个基类模板（CRTP），
+基类提供逐字符调用的工具方法（字符分类、执行运算、显示步骤），都是普通成员函数，在编译期绑定、可以内联，
+每个字符不需要一次虚函数调用；子类需要不同行为时（如中缀还要显示运算符栈）直接定义同名方法，
+基类通过 static_cast<Derived*> 调用。
+运行时按表达式类型选择求值器的地方（ExpressionController）通过 AnyEvaluator 接口调用，
+每个表达式只有一次虚函数调用。
+数学常量见 ExpressionCompiler::isConstantName，运算符优先级见 CharTable::precedence。*/
 
-// 运算符优先级定义
-enum Priority {
-    LOW = 1,        // 低优先级 (+, -, &, |)
-    MEDIUM = 2,     // 中优先级 (*, /, %)
-    HIGH = 3,       // 高优先级 (^)
-    VERY_HIGH = 4   // 最高优先级 (函数: sin, cos, tan, log)
-};
+// 基础表达式求值类（Derived 为具体的求值器）
+template<typename Derived>
+class ExpressionEvaluator {
+protected:
+    stack<double, vector<double>> numberStack;    // 数字栈（连续内存）
+    bool verbose = true;                          // 是否显示求值过程
 
-// 表达式类型枚举
-enum ExpressionType {
-    INFIX,      // 中缀表达式（例如：3 + 4）
-    PREFIX,     // 前缀表达式（例如：+ 3 4）
-    POSTFIX     // 后缀表达式（例如：3 4 +）
-};
+    Derived& derived() { return static_cast<Derived&>(*this); }
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
 
-// 错误类型枚举
-enum ErrorType {
-    NO_ERROR,                // 无错误
-    MISMATCHED_PARENTHESES, // 括号不匹配
-    INVALID_CHARACTER,      // 非法字符
-    CONSECUTIVE_OPERATORS,  // 连续运算符
-    DIVISION_BY_ZERO,      // 除零错误
-    INVALID_EXPRESSION,    // 非法表达式
-    EMPTY_EXPRESSION,      // 空表达式
-    INVALID_NEGATIVE_NUMBER, // 无效的负数格式
-    INSUFFICIENT_OPERANDS,   // 操作数不足
-    FUNCTION_ARGUMENT_ERROR, // 函数参数错误
-    MISSING_OPERATOR        // 缺少运算符
-};
+    // 工具方法（静态绑定）
+    bool isOperator(char c) const { return CharTable::isOperator(c); }    // 判断是否为运算符
+    bool isNumber(char c) const { return CharTable::isNumber(c); }        // 判断是否为数字
+    bool isFunction(char c) const { return CharTable::isFunction(c); }    // 判断是否为函数
+    int precedence(char op) const { return CharTable::precedence(op); }   // 获取运算符优先级
+
+    double evaluateOperation(double a, double b, char op) const {    // 执行运算操作（函数只用 b）
+        if (isFunction(op)) return CompiledExpression::evaluateUnary(op, b);
+        return CompiledExpression::evaluateOperation(a, b, op);
+    }
+
+    void clearStack() {    // 清空数字栈
+        while (!numberStack.empty()) numberStack.pop();
+    }
 
-// 基础表达式求值类
-class ExpressionEvaluator {
-protected:
-    stack<double> numberStack;    // 数字栈
-    string remainingExpr;         // 剩余表达式
-    
-public:
-    virtual ~ExpressionEvaluator() = default;  // 虚析构函数
-    
-    // 纯虚函数，由子类实现具体的求值逻辑
-    virtual double evaluate(const string& expr) = 0;  // 表达式求值接口
-    virtual bool validateExpression(const string& expr) const = 0;  // 验证表达式合法性
-    
-protected:
-    // 工具方法
-    virtual bool isOperator(char c) const;    // 判断是否为运算符
-    virtual bool isNumber(char c) const;      // 判断是否为数字
-    virtual bool isFunction(char c) const;    // 判断是否为函数
-    virtual double evaluateOperation(double a, double b, char op) const;  // 执行运算操作
-    
     // 显示方法
-    virtual void displayStack(const string& remainingExpr) const;   // 显示栈状态
-    virtual void displayStep(const string& remainingExpr, const string& operation);  // 显示计算步骤
-    
-    // 数字解析方法
-    virtual bool isValidNumber(const string& numStr) const;  // 验证数字格式
-    virtual double parseNumber(const string& numStr) const;  // 解析数字字符串
-};
+    void displayNumberStack() const {    // 从栈顶到栈底显示数字栈
+        cout << "数字栈（Number stack）: " << endl;
+        stack<double, vector<double>> tempNum = numberStack;
+        while (!tempNum.empty()) {
+            cout << "|" << fixed << setprecision(2) << tempNum.top() << "|" << endl;
+            tempNum.pop();
+        }
+        cout << endl;
+    }
+
+    void displayStacks(const string& remainingExpr) const {    // 显示栈状态（子类可以定义同名方法替换）
+        cout << "剩余表达式（Remaining expression）: " << remainingExpr << endl;
+        displayNumberStack();
+        cout << "----------------------------------------" << endl;
+    }
+
+    void displayStep(const string& remainingExpr, const string& operation) {    // 显示计算步骤
+        if (!verbose) return;
+        cout << "执行操作 (Operation)：" << operation << endl;
+        derived().displayStacks(remainingExpr);
+    }
 
-// 中缀表达式求值类
-class InfixEvaluator : public ExpressionEvaluator {
-private:
-    stack<char> operatorStack;    // 运算符栈
-    
 public:
-    double evaluate(const string& expr) override;  // 中缀表达式求值
-    bool validateExpression(const string& expr) const override;  // 验证中缀表达式合法性
-    
-private:
-    int precedence(char op) const;    // 获取运算符优先级
-    void displayStacks(const string& remainingExpr) const;  // 显示双栈状态
-    bool isConstant(const string& expr, size_t& pos) const;  // 检查是否为常量
-    bool isFunctionCall(const string& expr, size_t& pos) const;  // 检查是否为函数调用
-    void processFunction(char func);  // 处理函数调用
+    void setVerbose(bool enabled) { verbose = enabled; }    // 设置是否显示求值过程（批量和测试时关闭）
+    bool isVerbose() const { return verbose; }               // 是否显示求值过程
 };
 
-// 前缀表达式求值类
-class PrefixEvaluator : public ExpressionEvaluator {
+// 运行时选择求值器的统一接口：每个表达式一次虚函数调用
+class AnyEvaluator {
 public:
-    double evaluate(const string& expr) override;  // 前缀表达式求值
-    bool validateExpression(const string& expr) const override;  // 验证前缀表达式合法性
-    
-private:
-    string joinTokens(const vector<string>& tokens, int begin, int end) const;  // 连接tokens
-    vector<string> tokenize(const string& expr) const;  // 分割表达式为tokens
-    bool isValidToken(const string& token) const;  // 验证token有效性
+    virtual ~AnyEvaluator() = default;
+    virtual double evaluate(const string& expr) = 0;                  // 表达式求值
+    virtual bool validateExpression(const string& expr) const = 0;    // 验证表达式合法性
+    virtual void setVerbose(bool enabled) = 0;                        // 设置是否显示求值过程
 };
 
-// 后缀表达式求值类
-class PostfixEvaluator : public ExpressionEvaluator {
-public:
-    double evaluate(const string& expr) override;  // 后缀表达式求值
-    bool validateExpression(const string& expr) const override;  // 验证后缀表达式合法性
-    
+template<typename Evaluator>
+class EvaluatorAdapter : public AnyEvaluator {    // 把具体求值器包装成 AnyEvaluator
 private:
-    bool parseNumberFromExpression(const string& expr, size_t& pos, double& num) const;  // 从表达式中解析数字
+    Evaluator evaluator;
+
+public:
+    double evaluate(const string& expr) override { return evaluator.evaluate(expr); }
+    bool validateExpression(const string& expr) const override { return evaluator.validateExpression(expr); }
+    void setVerbose(bool enabled) override { evaluator.setVerbose(enabled); }
 };
 
 // 表达式类型检测器
@@ -125,71 +108,13 @@ public:
     static bool isInfixExpression(const string& expr);            // 判断是否为中缀表达式
     static bool isPrefixExpression(const string& expr);           // 判断是否为前缀表达式
     static bool isPostfixExpression(const string& expr);          // 判断是否为后缀表达式
-    
-private:
-    static bool containsOperators(const string& expr);            // 检查是否包含运算符
-    static bool hasBalancedParentheses(const string& expr);       // 检查括号是否平衡
-    static bool startsWithOperator(const string& expr);           // 检查是否以运算符开始
-};
-
-// 表达式验证器
-class ExpressionValidator {
-public:
-    static bool validateInfixExpression(const string& expr);      // 验证中缀表达式
-    static bool validatePrefixExpression(const string& expr);     // 验证前缀表达式
-    static bool validatePostfixExpression(const string& expr);    // 验证后缀表达式
-    
-private:
-    static bool hasMismatchedParentheses(const string& expr);     // 检查括号不匹配
-    static bool hasConsecutiveOperators(const string& expr);      // 检查连续运算符
-    static bool hasMissingOperator(const string& expr);           // 检查缺少运算符
-    static bool hasInvalidCharacters(const string& expr);         // 检查非法字符
-    static bool hasValidNumberFormat(const string& expr);         // 检查数字格式
-};
-
-// 表达式转换器
-class ExpressionConverter {
-public:
-    static string infixToPostfix(const string& infix);           // 中缀转后缀
-    static string infixToPrefix(const string& infix);            // 中缀转前缀
-    static string postfixToInfix(const string& postfix);         // 后缀转中缀
-    static string prefixToInfix(const string& prefix);           // 前缀转中缀
-    
-private:
-    static int getPrecedence(char op);                           // 获取运算符优先级
-    static bool isOperator(char c);                              // 判断是否为运算符
-    static bool isNumber(char c);                                // 判断是否为数字
-    static bool isLeftAssociative(char op);                      // 判断运算符左结合性
-};
-
-// 数学函数管理器
-class MathFunctionManager {
-public:
-    static double evaluateFunction(char func, double arg);       // 计算函数值
-    static bool isValidFunction(char func);                      // 验证函数有效性
-    static string getFunctionName(char func);                    // 获取函数名称
-    static int getFunctionArity(char func);                      // 获取函数参数个数
-    
-private:
-    static const map<char, string> functionNames;                // 函数名称映射
-    static const map<char, int> functionArity;                   // 函数参数个数映射
-};
-
-// 常量管理器
-class ConstantManager {
-public:
-    static double getConstant(const string& name);               // 获取常量值
-    static bool isValidConstant(const string& name);             // 验证常量有效性
-    static vector<string> getAllConstants();                     // 获取所有常量名称
-    
-private:
-    static const map<string, double> constants;                  // 常量映射
+    static bool hasTypeTag(const string& line);                   // 行首的 1 / 2 / 3 是否为类型标记（只有整行本身才是合法表达式时不是）
 };
 
 // 主控制器类
 class ExpressionController {
 private:
-    unique_ptr<ExpressionEvaluator> evaluator;  // 表达式求值器指针
+    unique_ptr<AnyEvaluator> evaluator;         // 当前类型的求值器
     ExpressionType currentType;                 // 当前表达式类型
     
 public:
@@ -220,27 +145,4 @@ private:
     void displayError(const string& error);         // 显示错误
 };
 
-// 工具函数
-namespace ExpressionUtils {
-    // 字符串处理
-    string trim(const string& str);                    // 去除首尾空格
-    string toLowerCase(const string& str);             // 转换为小写
-    vector<string> split(const string& str, char delimiter);  // 分割字符串
-    
-    // 数字处理
-    bool isInteger(const string& str);                 // 判断是否为整数
-    bool isDecimal(const string& str);                 // 判断是否为小数
-    bool isScientificNotation(const string& str);      // 判断是否为科学计数法
-    bool isNegativeNumber(const string& str);          // 判断是否为负数
-    
-    // 表达式处理
-    string removeSpaces(const string& expr);           // 移除空格
-    string standardizeBrackets(const string& expr);    // 标准化括号
-    bool hasBalancedBrackets(const string& expr);      // 检查括号平衡
-    
-    // 格式化输出
-    string formatNumber(double num, int precision = 2);  // 格式化数字
-    string formatExpression(const string& expr);         // 格式化表达式
-}
-
 #endif // EXPRESSION_EVALUATOR_H    // 结束头文件保护
\ No newline at end of file
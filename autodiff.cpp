@@ -0,0 +1,146 @@
+#include "autodiff.h"    // 包含自动微分头文件
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+// 二元运算对两个操作数的偏导数 (da, db)，value 为运算结果
+void partials(double a, double b, double value, char op, double& da, double& db) {
+    switch (op) {
+        case '+': da = 1; db = 1; break;
+        case '-': da = 1; db = -1; break;
+        case '*': da = b; db = a; break;
+        case '/': da = 1 / b; db = -a / (b * b); break;
+        case '%': da = 1; db = -trunc(a / b); break;
+        case '^':
+            da = (b == 0) ? 0 : b * pow(a, b - 1);
+            db = (a > 0) ? value * log(a) : 0;
+            break;
+        case '&':
+        case '|': da = 0; db = 0; break;
+        default: throw runtime_error("未知运算符 (Unknown operator)");
+    }
+}
+
+// 一元运算的导数
+double unaryPartial(char op, double b) {
+    switch (op) {
+        case '-': return -1;
+        case 's': return cos(b);
+        case 'c': return -sin(b);
+        case 't': { double c = cos(b); return 1 / (c * c); }
+        case 'l': return 1 / b;
+        default: throw runtime_error("未知运算符 (Unknown operator)");
+    }
+}
+
+void checkArguments(const CompiledExpression& expr, const vector<double>& values) {
+    if (!expr.isComplete()) throw runtime_error("表达式不完整 (Incomplete expression)");
+    if (values.size() < expr.getVariables().size()) throw runtime_error("变量取值不足 (Missing variable values)");
+}
+
+}  // namespace
+
+Dual AutoDiff::applyOperation(const Dual& a, const Dual& b, char op) {    // 对偶数二元运算
+    double value = CompiledExpression::evaluateOperation(a.value, b.value, op);    // 复用同一运算，保证值和报错一致
+    double da = 0, db = 0;
+    partials(a.value, b.value, value, op, da, db);
+    return {value, da * a.derivative + db * b.derivative};
+}
+
+Dual AutoDiff::applyUnary(char op, const Dual& b) {    // 对偶数一元运算
+    double value = CompiledExpression::evaluateUnary(op, b.value);
+    return {value, unaryPartial(op, b.value) * b.derivative};
+}
+
+Dual AutoDiff::evaluateDual(const CompiledExpression& expr, const vector<double>& values,
+                            const vector<double>& direction) {    // 前向模式求值
+    checkArguments(expr, values);
+    const vector<double>& constants = expr.getConstants();
+    vector<Dual> stack(expr.getMaxStackDepth());
+    size_t top = 0;
+    for (const Instruction& ins : expr.getCode()) {
+        switch (ins.code) {
+            case OpCode::PUSH_CONST: stack[top++] = {constants[ins.index], 0}; break;
+            case OpCode::LOAD_VAR: {
+                double seed = (static_cast<size_t>(ins.index) < direction.size()) ? direction[ins.index] : 0;
+                stack[top++] = {values[ins.index], seed};
+                break;
+            }
+            case OpCode::BINARY:
+                top--;
+                stack[top - 1] = applyOperation(stack[top - 1], stack[top], ins.op);
+                break;
+            case OpCode::UNARY:
+                stack[top - 1] = applyUnary(ins.op, stack[top - 1]);
+                break;
+        }
+    }
+    return stack[0];
+}
+
+Dual AutoDiff::derivative(const CompiledExpression& expr, const vector<double>& values, int variable) {    // 对单个变量求导
+    vector<double> direction(expr.getVariables().size(), 0.0);
+    if (variable >= 0 && static_cast<size_t>(variable) < direction.size()) direction[variable] = 1;
+    return evaluateDual(expr, values, direction);
+}
+
+/*反向模式：正向扫描时记录每条指令的结果和操作数来自哪条指令，
+然后从最后一条指令开始反向传播伴随值（adjoint），
+遇到 LOAD_VAR 时把伴随值累加到对应变量的偏导数上。*/
+double AutoDiff::gradient(const CompiledExpression& expr, const vector<double>& values,
+                          vector<double>& grad) {    // 反向模式求梯度
+    checkArguments(expr, values);
+    const vector<Instruction>& code = expr.getCode();
+    const vector<double>& constants = expr.getConstants();
+    size_t n = code.size();
+
+    vector<double> result(n);          // 每条指令的结果
+    vector<int> argA(n, -1), argB(n, -1);    // 操作数来源指令
+    vector<int> stack(expr.getMaxStackDepth());
+    size_t top = 0;
+    for (size_t i = 0; i < n; i++) {
+        const Instruction& ins = code[i];
+        switch (ins.code) {
+            case OpCode::PUSH_CONST: result[i] = constants[ins.index]; stack[top++] = static_cast<int>(i); break;
+            case OpCode::LOAD_VAR:   result[i] = values[ins.index];    stack[top++] = static_cast<int>(i); break;
+            case OpCode::BINARY:
+                argB[i] = stack[--top];
+                argA[i] = stack[top - 1];
+                result[i] = CompiledExpression::evaluateOperation(result[argA[i]], result[argB[i]], ins.op);
+                stack[top - 1] = static_cast<int>(i);
+                break;
+            case OpCode::UNARY:
+                argA[i] = stack[top - 1];
+                result[i] = CompiledExpression::evaluateUnary(ins.op, result[argA[i]]);
+                stack[top - 1] = static_cast<int>(i);
+                break;
+        }
+    }
+
+    grad.assign(expr.getVariables().size(), 0.0);
+    vector<double> adjoint(n, 0.0);
+    adjoint[n - 1] = 1;
+    for (size_t k = n; k-- > 0;) {
+        const Instruction& ins = code[k];
+        double adj = adjoint[k];
+        if (adj == 0) continue;
+        switch (ins.code) {
+            case OpCode::PUSH_CONST: break;
+            case OpCode::LOAD_VAR: grad[ins.index] += adj; break;
+            case OpCode::BINARY: {
+                double da = 0, db = 0;
+                partials(result[argA[k]], result[argB[k]], result[k], ins.op, da, db);
+                adjoint[argA[k]] += adj * da;
+                adjoint[argB[k]] += adj * db;
+                break;
+            }
+            case OpCode::UNARY:
+                adjoint[argA[k]] += adj * unaryPartial(ins.op, result[argA[k]]);
+                break;
+        }
+    }
+    return result[n - 1];
+}
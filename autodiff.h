@@ -0,0 +1,37 @@
+#ifndef AUTODIFF_H    // 防止头文件重复包含
+#define AUTODIFF_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include <vector>                   // 包含向量容器
+using namespace std;                // 使用标准命名空间
+
+/*自动微分：在编译后的指令序列上同时计算函数值和导数。
+前向模式使用对偶数 (value, derivative)，一次求值得到一个方向上的导数；
+反向模式先正向记录每条指令的结果，再反向累加伴随值，一次得到全部偏导数。
+
+不可导运算的约定：
+  %：a % b = a - trunc(a/b)*b，取 d/da = 1，d/db = -trunc(a/b)（跳变点处取右侧导数）
+  &, |：分段常数，导数恒为 0
+  ^：d/db 在 a <= 0 时取 0（a^b*log(a) 无定义）；b == 0 时 d/da 取 0*/
+
+struct Dual {    // 对偶数
+    double value;        // 函数值
+    double derivative;   // 导数
+};
+
+class AutoDiff {    // 自动微分
+public:
+    // 前向模式
+    static Dual applyOperation(const Dual& a, const Dual& b, char op);    // 对偶数二元运算
+    static Dual applyUnary(char op, const Dual& b);                       // 对偶数一元运算
+    static Dual evaluateDual(const CompiledExpression& expr, const vector<double>& values,
+                             const vector<double>& direction);            // 沿 direction 方向求导
+    static Dual derivative(const CompiledExpression& expr, const vector<double>& values,
+                           int variable);                                 // 对单个变量求导
+
+    // 反向模式
+    static double gradient(const CompiledExpression& expr, const vector<double>& values,
+                           vector<double>& grad);                         // 返回函数值，grad 为全部偏导数
+};
+
+#endif // AUTODIFF_H    // 结束头文件保护
@@ -0,0 +1,322 @@
+#include "batch_evaluator.h"    // 包含批量求值器头文件
+#include "error_type.h"         // 错误类型
+#include <cmath>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t MIN_POLYNOMIAL_DEGREE = 2;  // 至少乘两次 x 才融合
+constexpr uint8_t NULL_ROW = 0xFF;           // 逐行状态：输入为空
+
+struct NullLanes {            // 有效位图的一个字节展开成 8 个状态字节：位为 0 的行为 NULL_ROW，否则为 0
+    uint8_t lanes[256][8];
+    constexpr NullLanes() : lanes() {
+        for (unsigned byte = 0; byte < 256; byte++) {
+            for (unsigned j = 0; j < 8; j++) lanes[byte][j] = ((byte >> j) & 1) ? 0 : NULL_ROW;
+        }
+    }
+};
+constexpr NullLanes NULL_LANES;
+
+void markNulls(uint8_t* status, const uint8_t* bits, size_t rows) {    // 按字节查表，每次合并 8 行
+    size_t k = 0;
+    for (; k + 8 <= rows; k += 8) {
+        uint64_t current, lanes;
+        memcpy(&current, status + k, 8);
+        memcpy(&lanes, NULL_LANES.lanes[bits[k >> 3]], 8);
+        current |= lanes;
+        memcpy(status + k, &current, 8);
+    }
+    for (size_t j = 0; k + j < rows; j++) status[k + j] |= NULL_LANES.lanes[bits[k >> 3]][j];
+}
+
+template <typename Bad>
+void markRows(uint8_t* status, size_t rows, ErrorType type, Bad bad) {    // 尚无状态且 bad(i) 的行记为 type（无分支）
+    for (size_t i = 0; i < rows; i++) {
+        uint8_t hit = static_cast<uint8_t>((status[i] == 0) & bad(i));
+        status[i] |= static_cast<uint8_t>(-hit) & static_cast<uint8_t>(type);
+    }
+}
+
+bool inBitwiseRange(double value) {    // 与 CompiledExpression::toBitwiseOperand 的检查相同（NaN 不在范围内）
+    return value > INT_MIN - 1.0 && value < INT_MAX + 1.0;
+}
+
+struct PolynomialStep {    // Horner 的一步：p = p * x，add 时再加 value
+    bool add;
+    double value;
+};
+
+struct PolynomialRun {     // 一段 Horner 指令
+    size_t variable;                // 变量下标
+    double leading;                 // 首项系数
+    vector<PolynomialStep> steps;   // 每步乘一次 x
+    size_t end;                     // 段后第一条指令
+};
+
+/*识别从 pos 开始的 Horner 指令段（ExpressionSimplifier 输出的多项式形式）：
+c LOAD x * [d +] LOAD x * [d +] ...，或以 LOAD x 开头（首项系数为 1）。
+这段指令净压入一个值，中间值都立即被消耗，所以可以整段替换成一次融合计算。返回段内乘以 x 的次数。*/
+size_t matchPolynomial(const vector<Instruction>& code, const vector<double>& constants, size_t pos, PolynomialRun& run) {
+    run.steps.clear();
+    const Instruction& first = code[pos];
+    size_t variable;
+    if (first.code == OpCode::LOAD_VAR) {
+        variable = first.index;
+        run.leading = 1.0;
+        run.steps.push_back({false, 0.0});    // 1 * x == x
+    } else if (first.code == OpCode::PUSH_CONST) {
+        variable = SIZE_MAX;
+        run.leading = constants[first.index];
+    } else {
+        return 0;
+    }
+    size_t i = pos + 1;
+    while (i + 1 < code.size() && code[i].code == OpCode::LOAD_VAR && (variable == SIZE_MAX || static_cast<size_t>(code[i].index) == variable)
+           && code[i + 1].code == OpCode::BINARY && code[i + 1].op == '*') {
+        variable = code[i].index;
+        i += 2;
+        PolynomialStep step{false, 0.0};
+        if (i + 1 < code.size() && code[i].code == OpCode::PUSH_CONST && code[i + 1].code == OpCode::BINARY && code[i + 1].op == '+') {
+            step = {true, constants[code[i].index]};
+            i += 2;
+        }
+        run.steps.push_back(step);
+    }
+    run.variable = variable;
+    run.end = i;
+    return run.steps.size();
+}
+
+void hornerColumn(const PolynomialRun& run, const double* x, double* p, size_t rows) {    // 与指令逐条执行的运算顺序相同，结果逐位一致
+    for (size_t i = 0; i < rows; i++) p[i] = run.leading;
+    for (const PolynomialStep& step : run.steps) {
+        if (step.add) {
+            double c = step.value;
+            for (size_t i = 0; i < rows; i++) p[i] = p[i] * x[i] + c;
+        } else {
+            for (size_t i = 0; i < rows; i++) p[i] *= x[i];
+        }
+    }
+}
+
+}  // namespace
+
+BatchEvaluator::BatchEvaluator(PrecisionMode mode) : mode(mode) {}
+
+void BatchEvaluator::binaryColumn(double* a, const double* b, size_t rows, char op, PrecisionMode mode) {    // a[i] = a[i] op b[i]
+    switch (op) {
+        case '+': for (size_t i = 0; i < rows; i++) a[i] += b[i]; return;
+        case '-': for (size_t i = 0; i < rows; i++) a[i] -= b[i]; return;
+        case '*': for (size_t i = 0; i < rows; i++) a[i] *= b[i]; return;
+        case '/':
+        case '%': {
+            bool zero = false;
+            for (size_t i = 0; i < rows; i++) zero |= (b[i] == 0);
+            if (zero) throw EvaluationError(DIVISION_BY_ZERO, "除数不能为零 (Division by zero)");
+            if (op == '/') {
+                for (size_t i = 0; i < rows; i++) a[i] /= b[i];
+            } else {
+                for (size_t i = 0; i < rows; i++) a[i] = fmod(a[i], b[i]);
+            }
+            return;
+        }
+        case '^':
+            if (mode == PrecisionMode::FAST) {
+                FastMath::pow(a, b, a, rows);
+            } else {
+                for (size_t i = 0; i < rows; i++) a[i] = pow(a[i], b[i]);
+            }
+            return;
+        default:    // & | 以及未知运算符，逐个检查
+            for (size_t i = 0; i < rows; i++) a[i] = CompiledExpression::evaluateOperation(a[i], b[i], op);
+            return;
+    }
+}
+
+void BatchEvaluator::unaryColumn(double* a, size_t rows, char op, PrecisionMode mode) {    // a[i] = op(a[i])
+    bool fast = (mode == PrecisionMode::FAST);
+    switch (op) {
+        case '-': for (size_t i = 0; i < rows; i++) a[i] = -a[i]; return;
+        case 's':
+            if (fast) FastMath::sin(a, a, rows); else for (size_t i = 0; i < rows; i++) a[i] = sin(a[i]);
+            return;
+        case 'c':
+            if (fast) FastMath::cos(a, a, rows); else for (size_t i = 0; i < rows; i++) a[i] = cos(a[i]);
+            return;
+        case 't':
+            if (fast) FastMath::tan(a, a, rows); else for (size_t i = 0; i < rows; i++) a[i] = tan(a[i]);
+            return;
+        case 'l': {
+            bool invalid = false;
+            for (size_t i = 0; i < rows; i++) invalid |= (a[i] <= 0);
+            if (invalid) throw EvaluationError(FUNCTION_ARGUMENT_ERROR, "对数函数的参数必须大于零 (Logarithm argument must be positive)");
+            if (fast) FastMath::log(a, a, rows); else for (size_t i = 0; i < rows; i++) a[i] = log(a[i]);
+            return;
+        }
+        default:
+            for (size_t i = 0; i < rows; i++) a[i] = CompiledExpression::evaluateUnary(op, a[i]);
+            return;
+    }
+}
+
+void BatchEvaluator::binaryColumn(double* a, const double* b, size_t rows, char op, PrecisionMode mode, uint8_t* status) {    // 按行记录错误
+    switch (op) {
+        case '/':    // 除数为零的行照常算出 inf / NaN，结果随后被丢弃
+            markRows(status, rows, DIVISION_BY_ZERO, [b](size_t i) { return b[i] == 0; });
+            for (size_t i = 0; i < rows; i++) a[i] /= b[i];
+            return;
+        case '%':
+            markRows(status, rows, DIVISION_BY_ZERO, [b](size_t i) { return b[i] == 0; });
+            for (size_t i = 0; i < rows; i++) a[i] = fmod(a[i], b[i]);
+            return;
+        case '&':
+        case '|': {    // 越界的操作数换成 0 再转换，避免未定义行为
+            markRows(status, rows, INVALID_EXPRESSION, [a, b](size_t i) { return !(inBitwiseRange(a[i]) & inBitwiseRange(b[i])); });
+            for (size_t i = 0; i < rows; i++) {
+                int x = static_cast<int>(inBitwiseRange(a[i]) ? a[i] : 0.0);
+                int y = static_cast<int>(inBitwiseRange(b[i]) ? b[i] : 0.0);
+                a[i] = op == '&' ? (x & y) : (x | y);
+            }
+            return;
+        }
+        default:
+            binaryColumn(a, b, rows, op, mode);
+            return;
+    }
+}
+
+void BatchEvaluator::unaryColumn(double* a, size_t rows, char op, PrecisionMode mode, uint8_t* status) {    // 按行记录错误
+    if (op != 'l') {
+        unaryColumn(a, rows, op, mode);
+        return;
+    }
+    markRows(status, rows, FUNCTION_ARGUMENT_ERROR, [a](size_t i) { return a[i] <= 0; });
+    for (size_t i = 0; i < rows; i++) a[i] = a[i] <= 0 ? 1.0 : a[i];    // 非正的参数换成 1，NaN 保持不变
+    if (mode == PrecisionMode::FAST) FastMath::log(a, a, rows); else for (size_t i = 0; i < rows; i++) a[i] = log(a[i]);
+}
+
+void BatchEvaluator::evaluate(const CompiledExpression& expr, const vector<const double*>& columns, size_t rows, double* out) {    // 分块求值
+    run(expr, columns, nullptr, rows, out, nullptr, nullptr);
+}
+
+void BatchEvaluator::evaluate(const CompiledExpression& expr, const vector<const double*>& columns, const vector<const uint8_t*>& validity,
+                              size_t rows, double* out, uint8_t* outValidity, BatchStatus& status) {    // 带有效位图求值
+    run(expr, columns, &validity, rows, out, outValidity, &status);
+}
+
+void BatchEvaluator::run(const CompiledExpression& expr, const vector<const double*>& columns, const vector<const uint8_t*>* validity,
+                         size_t rows, double* out, uint8_t* outValidity, BatchStatus* status) {    // 分块执行
+    if (!expr.isComplete()) throw EvaluationError(INVALID_EXPRESSION, "表达式不完整 (Incomplete expression)");
+    if (columns.size() < expr.getVariables().size()) throw EvaluationError(INVALID_EXPRESSION, "变量取值不足 (Missing variable values)");
+    if (rows == 0) return;
+
+    const vector<double>& constants = expr.getConstants();
+    const vector<Instruction>& code = expr.getCode();
+    vector<PolynomialRun> runs(code.size());    // 每条指令开始的多项式段（不足 MIN_POLYNOMIAL_DEGREE 的不用），各块共用
+    for (size_t pc = 0; pc < code.size(); pc++) {
+        if (code[pc].code == OpCode::PUSH_CONST || code[pc].code == OpCode::LOAD_VAR) matchPolynomial(code, constants, pc, runs[pc]);
+    }
+    stack.resize(expr.getMaxStackDepth() * TILE_ROWS);
+    uint8_t* rowState = nullptr;
+    size_t tally[256] = {};    // 各状态的行数，按状态下标计数不需要分支，最后汇入 status
+    if (status) {
+        rowStatus.resize(TILE_ROWS);
+        rowState = rowStatus.data();
+    }
+
+    for (size_t base = 0; base < rows; base += TILE_ROWS) {    // 整个指令序列在一块上执行完，再处理下一块
+        size_t count = min(TILE_ROWS, rows - base);
+        size_t top = 0;
+        if (rowState) {    // 任一输入为空的行先记为空（base 是 8 的倍数，位图按字节对齐）
+            fill_n(rowState, count, 0);
+            for (size_t v = 0; v < validity->size() && v < columns.size(); v++) {
+                if ((*validity)[v]) markNulls(rowState, (*validity)[v] + (base >> 3), count);
+            }
+        }
+        for (size_t pc = 0; pc < code.size(); pc++) {
+            const Instruction& ins = code[pc];
+            if (runs[pc].steps.size() >= MIN_POLYNOMIAL_DEGREE) {    // 整段多项式一次算完
+                hornerColumn(runs[pc], columns[runs[pc].variable] + base, tile(top++), count);
+                pc = runs[pc].end - 1;
+                continue;
+            }
+            switch (ins.code) {
+                case OpCode::PUSH_CONST:
+                    fill_n(tile(top++), count, constants[ins.index]);
+                    break;
+                case OpCode::LOAD_VAR:
+                    copy_n(columns[ins.index] + base, count, tile(top++));
+                    break;
+                case OpCode::BINARY:
+                    top--;
+                    if (rowState) binaryColumn(tile(top - 1), tile(top), count, ins.op, mode, rowState);
+                    else binaryColumn(tile(top - 1), tile(top), count, ins.op, mode);
+                    break;
+                case OpCode::UNARY:
+                    if (rowState) unaryColumn(tile(top - 1), count, ins.op, mode, rowState);
+                    else unaryColumn(tile(top - 1), count, ins.op, mode);
+                    break;
+            }
+        }
+        if (!rowState) {
+            copy_n(tile(0), count, out + base);
+            continue;
+        }
+
+        copy_n(tile(0), count, out + base);
+        uint8_t any = 0;
+        for (size_t i = 0; i < count; i++) any |= rowState[i];
+        if (outValidity) {    // base 是 8 的倍数，每块写整字节，末字节超出行数的位为 0
+            size_t k = 0;
+            for (; k + 8 <= count; k += 8) {
+                uint8_t byte = 0;
+                for (size_t j = 0; j < 8; j++) byte |= static_cast<uint8_t>((rowState[k + j] == 0) << j);
+                outValidity[(base + k) >> 3] = byte;
+            }
+            if (k < count) {
+                uint8_t byte = 0;
+                for (size_t j = 0; k + j < count; j++) byte |= static_cast<uint8_t>((rowState[k + j] == 0) << j);
+                outValidity[(base + k) >> 3] = byte;
+            }
+        }
+        if (any) {    // 只有含空值或出错行的块才走这里：这些行的结果改为 NaN，并按状态计数
+            for (size_t i = 0; i < count; i++) {
+                if (rowState[i]) out[base + i] = NAN;
+                tally[rowState[i]]++;
+            }
+        }
+    }
+    if (status) {
+        status->nullCount += tally[NULL_ROW];
+        for (size_t e = 1; e <= IO_ERROR; e++) status->errorCounts[e] += tally[e];
+    }
+}
+
+size_t BatchStatus::errorTotal() const {    // 出错行总数
+    size_t total = 0;
+    for (size_t count : errorCounts) total += count;
+    return total;
+}
+
+void BatchStatus::merge(const BatchStatus& other) {    // 累加另一份汇总
+    nullCount += other.nullCount;
+    for (size_t e = 0; e <= IO_ERROR; e++) errorCounts[e] += other.errorCounts[e];
+}
+
+vector<double> BatchEvaluator::evaluate(const CompiledExpression& expr, const vector<vector<double>>& columns) {    // 按列求值
+    size_t rows = columns.empty() ? 1 : columns[0].size();
+    vector<const double*> pointers;
+    for (const vector<double>& column : columns) {
+        if (column.size() != rows) throw EvaluationError(INVALID_EXPRESSION, "各变量的取值列长度不一致 (Column lengths differ)");
+        pointers.push_back(column.data());
+    }
+    vector<double> out(rows);
+    evaluate(expr, pointers, rows, out.data());
+    return out;
+}
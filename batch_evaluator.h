@@ -0,0 +1,68 @@
+#ifndef BATCH_EVALUATOR_H    // 防止头文件重复包含
+#define BATCH_EVALUATOR_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include "fast_math.h"              // 精度模式与批量超越函数
+#include "error_type.h"             // 错误类型
+#include <vector>                   // 包含向量容器
+#include <cstdint>                  // 定长整数类型
+using namespace std;                // 使用标准命名空间
+
+/*按列批量求值：同一个公式在多行数据上求值时，每条指令一次处理一列，
+指令分派的开销由所有行分摊，+ - * 等简单运算和 FAST 模式下的超越函数都是可向量化的循环。
+按 TILE_ROWS 行分块：整个指令序列在一块上执行完再处理下一块，栈上每个位置只有一块大小，
+中间结果一直留在 L1 / L2 缓存里，工作区是最大栈深 × TILE_ROWS 个 double，与行数无关；
+输入每块读一次，结果每块写一次。
+ExpressionSimplifier 输出的 Horner 形式多项式（SimplifyOptions::horner）整段融合：块内逐步 p = p * x + c，
+不再为每个 x 和系数各走一遍；运算顺序不变，结果与逐条执行逐位一致。
+（各行互不依赖，块内循环本身就是向量化的并行，Estrin 形式缩短单行依赖链的好处在这里用不上，实测反而更慢。）
+栈在多次调用之间复用。任意一行出错（除零、对数参数非正、位运算越界）时整批抛出 EvaluationError。
+带有效位图的 evaluate 不抛出：每块有一个逐行状态字节（0 正常，否则为该行第一个错误的 ErrorType，或表示输入为空），
+出错检查是与运算本身一样的无分支循环（出错的行照常算出 inf / NaN，最后丢弃），
+结果的有效位图（Arrow 布局）按状态生成，无效的行结果为 NaN，出错和空值按种类计数，
+所以个别坏行既不会中止整批，也不会让其余的行变慢。任一输入为空的行结果为空，不再报告该行的错误。*/
+
+struct BatchStatus {                        // 逐行求值的汇总（多次求值累加）
+    size_t nullCount = 0;                   // 因输入为空而为空的行数
+    size_t errorCounts[IO_ERROR + 1] = {};  // 按 ErrorType 分类的出错行数
+    size_t errorTotal() const;              // 出错行总数
+    void merge(const BatchStatus& other);   // 累加另一份汇总
+};
+
+class BatchEvaluator {    // 按列批量求值器
+public:
+    static constexpr size_t TILE_ROWS = 512;    // 每块行数（栈上每个位置 4 KB）
+
+private:
+    PrecisionMode mode;      // 精度模式
+    vector<double> stack;    // 块栈，第 i 个位置是 stack[i * TILE_ROWS ...]
+    vector<uint8_t> rowStatus;    // 当前块的逐行状态（带有效位图求值时）
+
+    double* tile(size_t slot) { return stack.data() + slot * TILE_ROWS; }    // 栈上第 slot 个位置
+    // 分块执行；status 为 nullptr 时出错抛出，否则按行记录（validity / outValidity 见带位图的 evaluate）
+    void run(const CompiledExpression& expr, const vector<const double*>& columns, const vector<const uint8_t*>* validity,
+             size_t rows, double* out, uint8_t* outValidity, BatchStatus* status);
+
+public:
+    explicit BatchEvaluator(PrecisionMode mode = PrecisionMode::EXACT);    // 构造函数
+
+    // columns[v] 指向第 v 个变量的 rows 个取值，结果写入 out（rows 个）
+    void evaluate(const CompiledExpression& expr, const vector<const double*>& columns, size_t rows, double* out);
+    // columns[v] 为第 v 个变量的取值列，各列等长（没有变量时按 1 行求值）
+    vector<double> evaluate(const CompiledExpression& expr, const vector<vector<double>>& columns);
+    // 带有效位图求值，不因个别行出错而抛出：validity[v] 为第 v 个变量的有效位图（从第 0 行开始，nullptr 或缺省表示全部有值），
+    // outValidity 接收 (rows + 7) / 8 字节的结果有效位图（可为 nullptr），空值和出错的行数累加到 status
+    void evaluate(const CompiledExpression& expr, const vector<const double*>& columns, const vector<const uint8_t*>& validity,
+                  size_t rows, double* out, uint8_t* outValidity, BatchStatus& status);
+
+    static void binaryColumn(double* a, const double* b, size_t rows, char op, PrecisionMode mode);    // a[i] = a[i] op b[i]，任一行出错时抛出 EvaluationError
+    static void unaryColumn(double* a, size_t rows, char op, PrecisionMode mode);                      // a[i] = op(a[i])
+    // 同上，但不抛出：出错的行在 status 中记下 ErrorType（已有状态的行保持不变）
+    static void binaryColumn(double* a, const double* b, size_t rows, char op, PrecisionMode mode, uint8_t* status);
+    static void unaryColumn(double* a, size_t rows, char op, PrecisionMode mode, uint8_t* status);
+
+    PrecisionMode getMode() const { return mode; }           // 获取精度模式
+    void setMode(PrecisionMode newMode) { mode = newMode; }  // 设置精度模式
+};
+
+#endif // BATCH_EVALUATOR_H    // 结束头文件保护
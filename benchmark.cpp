@@ -0,0 +1,334 @@
+#include "fast_math.h"           // 快速超越函数
+#include "batch_evaluator.h"     // 按列批量求值
+#include "expression_compiler.h" // 表达式编译器
+#include "expression_simplifier.h" // 化简与强度削减
+#include "fused_batch_evaluator.h" // 多公式融合求值
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*快速超越函数的精度与速度基准：
+1. 精度：在随机输入上比较 FastMath 与标准库，输出最大相对误差和最大绝对误差；
+2. 速度：标准库逐个调用、FastMath 逐个调用、FastMath 批量版本，每个元素的耗时（纳秒）；
+3. 公式级：同一公式在多行数据上按 EXACT / FAST 模式逐行求值与按列批量求值的耗时和最大相对差异；
+4. 化简：同一公式化简前后逐行求值的耗时、指令数和最大相对差异；
+5. 多公式：一组共享输入的公式逐个按列求值与融合求值的耗时；
+6. 有效位图：按列求值（出错即抛出）与带有效位图求值在没有坏行、有一定比例空值和出错行时的耗时。
+用法：./benchmark [元素个数]*/
+
+namespace {
+
+double nowSeconds() {    // 当前时间（秒）
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct ErrorStats {    // 误差统计
+    double maxRelative = 0;
+    double maxAbsolute = 0;
+};
+
+ErrorStats compare(const vector<double>& expected, const vector<double>& actual) {    // 比较两组结果
+    ErrorStats stats;
+    for (size_t i = 0; i < expected.size(); i++) {
+        double absolute = fabs(expected[i] - actual[i]);
+        if (isnan(expected[i]) && isnan(actual[i])) continue;
+        if (expected[i] == actual[i]) continue;
+        stats.maxAbsolute = max(stats.maxAbsolute, absolute);
+        if (expected[i] != 0) stats.maxRelative = max(stats.maxRelative, absolute / fabs(expected[i]));
+    }
+    return stats;
+}
+
+volatile double sink;    // 防止计时循环被优化掉
+
+struct UnaryCase {    // 一元函数测试项
+    const char* name;
+    function<double()> generate;
+    double (*exact)(double);
+    double (*fast)(double);
+    void (*batch)(const double*, double*, size_t);
+};
+
+void benchmarkUnary(const UnaryCase& test, size_t n) {    // 一元函数的精度与速度
+    vector<double> input(n), expected(n), scalar(n), batch(n);
+    for (double& x : input) x = test.generate();
+
+    double start = nowSeconds();
+    for (size_t i = 0; i < n; i++) expected[i] = test.exact(input[i]);
+    double exactTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    for (size_t i = 0; i < n; i++) scalar[i] = test.fast(input[i]);
+    double scalarTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    test.batch(input.data(), batch.data(), n);
+    double batchTime = nowSeconds() - start;
+
+    ErrorStats stats = compare(expected, batch);
+    ErrorStats scalarStats = compare(scalar, batch);
+    sink = expected[n / 2] + scalar[n / 2] + batch[n / 2];
+    printf("%-18s %10.2e %10.2e %9.2f %9.2f %9.2f %8.2fx%s\n", test.name, stats.maxRelative, stats.maxAbsolute,
+           exactTime * 1e9 / n, scalarTime * 1e9 / n, batchTime * 1e9 / n, exactTime / batchTime,
+           scalarStats.maxAbsolute == 0 ? "" : "  (标量与批量结果不一致)");
+}
+
+void benchmarkPow(mt19937_64& rng, size_t n) {    // pow 的精度与速度
+    uniform_real_distribution<double> exponentOf(-3, 3), power(-20, 20);
+    vector<double> a(n), b(n), expected(n), scalar(n), batch(n);
+    for (size_t i = 0; i < n; i++) { a[i] = pow(10.0, exponentOf(rng)); b[i] = power(rng); }
+
+    double start = nowSeconds();
+    for (size_t i = 0; i < n; i++) expected[i] = std::pow(a[i], b[i]);
+    double exactTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    for (size_t i = 0; i < n; i++) scalar[i] = FastMath::pow(a[i], b[i]);
+    double scalarTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    FastMath::pow(a.data(), b.data(), batch.data(), n);
+    double batchTime = nowSeconds() - start;
+
+    ErrorStats stats = compare(expected, batch);
+    sink = expected[n / 2] + scalar[n / 2] + batch[n / 2];
+    printf("%-18s %10.2e %10.2e %9.2f %9.2f %9.2f %8.2fx\n", "pow [1e-3,1e3]^b", stats.maxRelative, stats.maxAbsolute,
+           exactTime * 1e9 / n, scalarTime * 1e9 / n, batchTime * 1e9 / n, exactTime / batchTime);
+}
+
+void benchmarkFormula(const string& formula, mt19937_64& rng, size_t rows) {    // 公式级比较
+    CompiledExpression expr = ExpressionCompiler::compileInfix(formula);
+    uniform_real_distribution<double> value(0.5, 5);
+    vector<vector<double>> columns(expr.getVariables().size(), vector<double>(rows));
+    for (vector<double>& column : columns) for (double& x : column) x = value(rng);
+
+    vector<double> row(columns.size()), exactRows(rows);
+    double start = nowSeconds();
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t v = 0; v < columns.size(); v++) row[v] = columns[v][i];
+        exactRows[i] = expr.evaluate(row, PrecisionMode::EXACT);
+    }
+    double exactRowTime = nowSeconds() - start;
+
+    vector<double> fastRows(rows);
+    start = nowSeconds();
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t v = 0; v < columns.size(); v++) row[v] = columns[v][i];
+        fastRows[i] = expr.evaluate(row, PrecisionMode::FAST);
+    }
+    double fastRowTime = nowSeconds() - start;
+
+    BatchEvaluator exact(PrecisionMode::EXACT), fast(PrecisionMode::FAST);
+    start = nowSeconds();
+    vector<double> exactBatch = exact.evaluate(expr, columns);
+    double exactBatchTime = nowSeconds() - start;
+    start = nowSeconds();
+    vector<double> fastBatch = fast.evaluate(expr, columns);
+    double fastBatchTime = nowSeconds() - start;
+
+    printf("%s\n", formula.c_str());
+    printf("  逐行 EXACT %8.2f ns/行  逐行 FAST %8.2f ns/行  批量 EXACT %8.2f ns/行  批量 FAST %8.2f ns/行\n",
+           exactRowTime * 1e9 / rows, fastRowTime * 1e9 / rows, exactBatchTime * 1e9 / rows, fastBatchTime * 1e9 / rows);
+    printf("  FAST 与 EXACT 的最大相对差异：逐行 %.2e，批量 %.2e；批量 EXACT 与逐行 EXACT：%.2e\n",
+           compare(exactRows, fastRows).maxRelative, compare(exactRows, fastBatch).maxRelative,
+           compare(exactRows, exactBatch).maxRelative);
+}
+
+void benchmarkSimplify(const string& formula, const SimplifyOptions& options, mt19937_64& rng, size_t rows) {    // 化简前后比较
+    CompiledExpression expr = ExpressionCompiler::compileInfix(formula);
+    CompiledExpression simplified = ExpressionSimplifier::simplify(expr, options);
+    uniform_real_distribution<double> value(0.5, 5);
+    vector<double> inputs(rows * expr.getVariables().size());
+    for (double& x : inputs) x = value(rng);
+
+    vector<double> before(rows), after(rows);
+    size_t width = expr.getVariables().size();
+    vector<double> row(width);
+    double start = nowSeconds();
+    for (size_t i = 0; i < rows; i++) {
+        row.assign(inputs.begin() + i * width, inputs.begin() + (i + 1) * width);
+        before[i] = expr.evaluate(row);
+    }
+    double beforeTime = nowSeconds() - start;
+    start = nowSeconds();
+    for (size_t i = 0; i < rows; i++) {
+        row.assign(inputs.begin() + i * width, inputs.begin() + (i + 1) * width);
+        after[i] = simplified.evaluate(row);
+    }
+    double afterTime = nowSeconds() - start;
+
+    vector<vector<double>> columns(width, vector<double>(rows));    // 按列批量求值，去掉逐行调用的开销后运算本身的差别
+    for (size_t i = 0; i < rows; i++) for (size_t v = 0; v < width; v++) columns[v][i] = inputs[i * width + v];
+    BatchEvaluator batch;
+    batch.evaluate(simplified, columns);    // 先分配好列栈，两次计时都不含缺页
+    start = nowSeconds();
+    batch.evaluate(expr, columns);
+    double beforeBatchTime = nowSeconds() - start;
+    start = nowSeconds();
+    vector<double> afterBatch = batch.evaluate(simplified, columns);
+    double afterBatchTime = nowSeconds() - start;
+
+    printf("%s（%zu -> %zu 条指令）\n", formula.c_str(), expr.getCode().size(), simplified.getCode().size());
+    printf("  逐行 %8.2f -> %8.2f ns/行 %5.2fx  批量 %8.2f -> %8.2f ns/行 %5.2fx  最大相对差异 %.2e\n",
+           beforeTime * 1e9 / rows, afterTime * 1e9 / rows, beforeTime / afterTime,
+           beforeBatchTime * 1e9 / rows, afterBatchTime * 1e9 / rows, beforeBatchTime / afterBatchTime,
+           max(compare(before, after).maxRelative, compare(before, afterBatch).maxRelative));
+}
+
+void benchmarkFused(size_t formulas, mt19937_64& rng, size_t rows) {    // 多公式：逐个按列求值与融合求值
+    const string names[] = {"a", "b", "c", "d"};
+    FusedBatchEvaluator fused;
+    vector<CompiledExpression> exprs;
+    size_t instructions = 0;
+    for (size_t i = 0; i < formulas; i++) {    // 相邻公式共享 (x-y)、(x+y)、x^2 等子表达式
+        const string& x = names[i % 4];
+        const string& y = names[(i + 1) % 4];
+        const string& z = names[(i / 4 + 2) % 4];
+        string formula = "(" + x + "-" + y + ")*(" + x + "+" + y + ")/" + to_string(i + 3) + "+" + z + "*" + x + "^2";
+        exprs.push_back(ExpressionSimplifier::simplify(ExpressionCompiler::compileInfix(formula)));
+        instructions += exprs.back().getCode().size();
+        fused.addFormula(exprs.back());
+    }
+    uniform_real_distribution<double> value(0.5, 5);
+    vector<vector<double>> data(fused.getVariables().size(), vector<double>(rows));
+    for (vector<double>& column : data) for (double& x : column) x = value(rng);
+    vector<const double*> columns;
+    for (const vector<double>& column : data) columns.push_back(column.data());
+
+    vector<vector<double>> separate(formulas, vector<double>(rows)), together(formulas, vector<double>(rows));
+    BatchEvaluator batch;
+    double start = nowSeconds();
+    for (size_t f = 0; f < formulas; f++) {
+        vector<const double*> own;    // 按公式自己的变量顺序
+        for (const string& name : exprs[f].getVariables()) {
+            own.push_back(columns[find(fused.getVariables().begin(), fused.getVariables().end(), name) - fused.getVariables().begin()]);
+        }
+        batch.evaluate(exprs[f], own, rows, separate[f].data());
+    }
+    double separateTime = nowSeconds() - start;
+
+    vector<double*> outputs;
+    for (vector<double>& output : together) outputs.push_back(output.data());
+    start = nowSeconds();
+    fused.evaluate(columns, rows, outputs);
+    double fusedTime = nowSeconds() - start;
+
+    double difference = 0;
+    for (size_t f = 0; f < formulas; f++) difference = max(difference, compare(separate[f], together[f]).maxRelative);
+    printf("%zu 个公式（%zu 条指令 -> %zu 个节点，%zu 个寄存器 = %zu KB 工作区）\n", formulas, instructions, fused.nodeCount(),
+           fused.getRegisterCount(), fused.getRegisterCount() * FusedBatchEvaluator::TILE_ROWS * sizeof(double) / 1024);
+    printf("  逐个按列 %8.2f ns/行  融合 %8.2f ns/行 %5.2fx  最大相对差异 %.2e\n",
+           separateTime * 1e9 / rows, fusedTime * 1e9 / rows, separateTime / fusedTime, difference);
+}
+
+template <typename T>
+vector<const T*> pointers(const vector<vector<T>>& columns) {    // 各列的首地址
+    vector<const T*> result;
+    for (const vector<T>& column : columns) result.push_back(column.data());
+    return result;
+}
+
+void benchmarkMasked(const string& formula, double badFraction, mt19937_64& rng, size_t rows) {    // 带有效位图求值的开销
+    CompiledExpression expr = ExpressionSimplifier::simplify(ExpressionCompiler::compileInfix(formula));
+    size_t width = expr.getVariables().size();
+    uniform_real_distribution<double> value(0.5, 5), chance(0, 1);
+    vector<vector<double>> clean(width, vector<double>(rows)), dirty(width, vector<double>(rows));
+    vector<vector<uint8_t>> allValid(width, vector<uint8_t>((rows + 7) / 8, 0xFF)), someNull = allValid;
+    for (size_t v = 0; v < width; v++) {
+        for (size_t i = 0; i < rows; i++) {
+            clean[v][i] = value(rng);
+            dirty[v][i] = chance(rng) < badFraction / 2 ? 0.0 : clean[v][i];    // 作除数或对数参数时出错
+            if (chance(rng) < badFraction / 2 / width) someNull[v][i / 8] &= static_cast<uint8_t>(~(1u << (i % 8)));
+        }
+    }
+    BatchEvaluator batch;
+    vector<double> out(rows);
+    vector<uint8_t> validity((rows + 7) / 8);
+    BatchStatus status;
+    batch.evaluate(expr, pointers(clean), rows, out.data());    // 先分配好列栈
+    double start = nowSeconds();
+    batch.evaluate(expr, pointers(clean), rows, out.data());
+    double throwingTime = nowSeconds() - start;
+    start = nowSeconds();
+    batch.evaluate(expr, pointers(clean), pointers(allValid), rows, out.data(), validity.data(), status);
+    double cleanTime = nowSeconds() - start;
+    status = BatchStatus();
+    start = nowSeconds();
+    batch.evaluate(expr, pointers(dirty), pointers(someNull), rows, out.data(), validity.data(), status);
+    double dirtyTime = nowSeconds() - start;
+
+    printf("%s\n", formula.c_str());
+    printf("  按列 %8.2f ns/行  带位图 %8.2f ns/行  含 %.0f%% 坏行 %8.2f ns/行（空值 %zu 行，出错 %zu 行）\n",
+           throwingTime * 1e9 / rows, cleanTime * 1e9 / rows, badFraction * 100, dirtyTime * 1e9 / rows,
+           status.nullCount, status.errorTotal());
+}
+
+double exactSin(double x) { return std::sin(x); }
+double exactCos(double x) { return std::cos(x); }
+double exactTan(double x) { return std::tan(x); }
+double exactLog(double x) { return std::log(x); }
+double fastSin(double x) { return FastMath::sin(x); }
+double fastCos(double x) { return FastMath::cos(x); }
+double fastTan(double x) { return FastMath::tan(x); }
+double fastLog(double x) { return FastMath::log(x); }
+void batchSin(const double* x, double* out, size_t n) { FastMath::sin(x, out, n); }
+void batchCos(const double* x, double* out, size_t n) { FastMath::cos(x, out, n); }
+void batchTan(const double* x, double* out, size_t n) { FastMath::tan(x, out, n); }
+void batchLog(const double* x, double* out, size_t n) { FastMath::log(x, out, n); }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1 << 20;
+    if (n == 0) n = 1;
+    mt19937_64 rng(20240601);
+    uniform_real_distribution<double> small(-10, 10), large(-1e6, 1e6), exponentOf(-300, 300);
+
+    printf("%-18s %10s %10s %9s %9s %9s %9s\n", "函数 (function)", "max rel", "max abs", "std ns", "fast ns", "batch ns", "speedup");
+    vector<UnaryCase> cases = {
+        {"sin [-10,10]", [&] { return small(rng); }, exactSin, fastSin, batchSin},
+        {"sin [-1e6,1e6]", [&] { return large(rng); }, exactSin, fastSin, batchSin},
+        {"cos [-10,10]", [&] { return small(rng); }, exactCos, fastCos, batchCos},
+        {"cos [-1e6,1e6]", [&] { return large(rng); }, exactCos, fastCos, batchCos},
+        {"tan [-10,10]", [&] { return small(rng); }, exactTan, fastTan, batchTan},
+        {"log [1e-300,1e300]", [&] { return pow(10.0, exponentOf(rng)); }, exactLog, fastLog, batchLog},
+        {"log [0.5,2]", [&] { return 0.5 + 1.5 * (small(rng) + 10) / 20; }, exactLog, fastLog, batchLog},
+    };
+    for (const UnaryCase& test : cases) benchmarkUnary(test, n);
+    benchmarkPow(rng, n);
+
+    printf("\n");
+    benchmarkFormula("s(x)*c(y)+l(x+y)^0.5", rng, n);
+    benchmarkFormula("x^2.5+y^1.5-t(x/y)", rng, n);
+
+    printf("\n");
+    SimplifyOptions reciprocal;
+    reciprocal.reciprocalDivision = true;
+    SimplifyOptions horner;
+    horner.horner = true;
+    benchmarkSimplify("a*x^2+b*x+c", SimplifyOptions(), rng, n);
+    benchmarkSimplify("(x-1)^2/4+(y+1)^2/9*l(e)", SimplifyOptions(), rng, n);
+    benchmarkSimplify("(x-1)^2/4+(y+1)^2/9*l(e)", reciprocal, rng, n);
+    benchmarkSimplify("x^3+3*x^2*y+3*x*y^2+y^3", SimplifyOptions(), rng, n);
+
+    benchmarkSimplify("3*x^3 + 2*x^2 + x + 7", SimplifyOptions(), rng, n);
+    benchmarkSimplify("3*x^3 + 2*x^2 + x + 7", horner, rng, n);
+    benchmarkSimplify("1 + x + x^2/2 + x^3/6 + x^4/24 + x^5/120 + x^6/720 + x^7/5040 + x^8/40320 + x^9/362880 + x^10/3628800 + x^11/39916800 + x^12/479001600", horner, rng, n);
+
+    printf("\n");
+    benchmarkFused(8, rng, n);
+    benchmarkFused(40, rng, n);
+
+    printf("\n");
+    benchmarkMasked("x*y + 3*x - y", 0.02, rng, n);
+    benchmarkMasked("x/y + l(x)", 0.02, rng, n);
+    benchmarkMasked("(x+y)*(x-y)/(x*y+1)", 0.02, rng, n);
+    return 0;
+}
@@ -0,0 +1,753 @@
+#include "big_number.h"    // 包含任意精度数值头文件
+#include <cmath>
+#include <cctype>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+// ==================== BigInt ====================
+
+namespace {
+
+const uint32_t POW10[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+// 绝对值乘以一个小于 BASE 的数
+vector<uint32_t> mulSmall(const vector<uint32_t>& a, uint32_t m) {
+    vector<uint32_t> r;
+    if (m == 0 || a.empty()) return r;
+    r.reserve(a.size() + 1);
+    uint64_t carry = 0;
+    for (uint32_t limb : a) {
+        uint64_t cur = static_cast<uint64_t>(limb) * m + carry;
+        r.push_back(static_cast<uint32_t>(cur % BigInt::BASE));
+        carry = cur / BigInt::BASE;
+    }
+    if (carry) r.push_back(static_cast<uint32_t>(carry));
+    return r;
+}
+
+// 用最高的三个 limb 近似绝对值：返回值 × BASE^scale ≈ |a|
+double leadingApprox(const vector<uint32_t>& a, int& scale) {
+    double v = 0;
+    size_t n = a.size();
+    size_t used = min<size_t>(3, n);
+    for (size_t i = 0; i < used; i++) v = v * BigInt::BASE + a[n - 1 - i];
+    scale = static_cast<int>(n - used);
+    return v;
+}
+
+}  // namespace
+
+BigInt::BigInt() : negative(false) {}
+
+BigInt::BigInt(int64_t value) : negative(value < 0) {
+    uint64_t mag = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    while (mag) {
+        limbs.push_back(static_cast<uint32_t>(mag % BASE));
+        mag /= BASE;
+    }
+}
+
+void BigInt::trim() {    // 去掉高位的 0
+    while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+    if (limbs.empty()) negative = false;
+}
+
+BigInt BigInt::fromString(const string& digits) {    // 由十进制数字串构造
+    BigInt r;
+    size_t start = 0;
+    bool neg = false;
+    if (start < digits.size() && (digits[start] == '-' || digits[start] == '+')) {
+        neg = digits[start] == '-';
+        start++;
+    }
+    if (start >= digits.size()) throw runtime_error("无效的整数格式 (Invalid integer format): " + digits);
+    for (size_t i = start; i < digits.size(); i++) {
+        if (!isdigit(static_cast<unsigned char>(digits[i]))) {
+            throw runtime_error("无效的整数格式 (Invalid integer format): " + digits);
+        }
+    }
+    for (size_t end = digits.size(); end > start;) {    // 从低位开始每 9 位一组
+        size_t begin = (end - start > 9) ? end - 9 : start;
+        r.limbs.push_back(static_cast<uint32_t>(stoul(digits.substr(begin, end - begin))));
+        end = begin;
+    }
+    r.negative = neg;
+    r.trim();
+    return r;
+}
+
+int BigInt::compareMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b) {    // 比较绝对值
+    if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+vector<uint32_t> BigInt::addMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+    vector<uint32_t> r;
+    r.reserve(max(a.size(), b.size()) + 1);
+    uint32_t carry = 0;
+    for (size_t i = 0; i < max(a.size(), b.size()); i++) {
+        uint32_t cur = carry + (i < a.size() ? a[i] : 0) + (i < b.size() ? b[i] : 0);
+        carry = cur >= BASE;
+        r.push_back(carry ? cur - BASE : cur);
+    }
+    if (carry) r.push_back(carry);
+    return r;
+}
+
+vector<uint32_t> BigInt::subMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+    vector<uint32_t> r(a);
+    int64_t borrow = 0;
+    for (size_t i = 0; i < r.size(); i++) {
+        int64_t cur = static_cast<int64_t>(r[i]) - borrow - (i < b.size() ? b[i] : 0);
+        borrow = cur < 0;
+        r[i] = static_cast<uint32_t>(borrow ? cur + BASE : cur);
+    }
+    while (!r.empty() && r.back() == 0) r.pop_back();
+    return r;
+}
+
+bool BigInt::fitsInt64() const {    // 是否在 int64 范围内
+    static const BigInt maxValue(INT64_MAX);
+    static const BigInt minValue(INT64_MIN);
+    return compare(maxValue) <= 0 && compare(minValue) >= 0;
+}
+
+int64_t BigInt::toInt64() const {    // 转为 int64
+    uint64_t mag = 0;
+    for (size_t i = limbs.size(); i-- > 0;) mag = mag * BASE + limbs[i];
+    return negative ? static_cast<int64_t>(0 - mag) : static_cast<int64_t>(mag);
+}
+
+double BigInt::toDouble() const {    // 转为 double（近似）
+    double v = 0;
+    for (size_t i = limbs.size(); i-- > 0;) v = v * BASE + limbs[i];
+    return negative ? -v : v;
+}
+
+size_t BigInt::digitCount() const {    // 十进制位数
+    if (limbs.empty()) return 0;
+    size_t count = (limbs.size() - 1) * 9;
+    uint32_t top = limbs.back();
+    while (top) { count++; top /= 10; }
+    return count;
+}
+
+string BigInt::toString() const {    // 十进制字符串
+    if (limbs.empty()) return "0";
+    string s = negative ? "-" : "";
+    s += to_string(limbs.back());
+    for (size_t i = limbs.size() - 1; i-- > 0;) {
+        string part = to_string(limbs[i]);
+        s += string(9 - part.size(), '0') + part;
+    }
+    return s;
+}
+
+BigInt BigInt::operator-() const {
+    BigInt r(*this);
+    if (!r.limbs.empty()) r.negative = !r.negative;
+    return r;
+}
+
+BigInt BigInt::operator+(const BigInt& other) const {
+    BigInt r;
+    if (negative == other.negative) {
+        r.limbs = addMagnitude(limbs, other.limbs);
+        r.negative = negative;
+    } else if (compareMagnitude(limbs, other.limbs) >= 0) {
+        r.limbs = subMagnitude(limbs, other.limbs);
+        r.negative = negative;
+    } else {
+        r.limbs = subMagnitude(other.limbs, limbs);
+        r.negative = other.negative;
+    }
+    r.trim();
+    return r;
+}
+
+BigInt BigInt::operator-(const BigInt& other) const {
+    return *this + (-other);
+}
+
+BigInt BigInt::operator*(const BigInt& other) const {    // 逐位相乘
+    BigInt r;
+    if (limbs.empty() || other.limbs.empty()) return r;
+    vector<uint64_t> acc(limbs.size() + other.limbs.size() + 1, 0);
+    for (size_t i = 0; i < limbs.size(); i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < other.limbs.size(); j++) {
+            uint64_t cur = acc[i + j] + static_cast<uint64_t>(limbs[i]) * other.limbs[j] + carry;
+            acc[i + j] = cur % BASE;
+            carry = cur / BASE;
+        }
+        size_t k = i + other.limbs.size();
+        while (carry) {
+            uint64_t cur = acc[k] + carry;
+            acc[k++] = cur % BASE;
+            carry = cur / BASE;
+        }
+    }
+    r.limbs.assign(acc.begin(), acc.end());
+    r.negative = negative != other.negative;
+    r.trim();
+    return r;
+}
+
+/*长除法：从高位到低位，每次把被除数的一个 limb 移入余数，
+用最高三个 limb 的浮点近似估计商的这一位，再用加减法修正估计误差。*/
+void BigInt::divMod(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder) {
+    if (b.isZero()) throw runtime_error("除数不能为零 (Division by zero)");
+    if (compareMagnitude(a.limbs, b.limbs) < 0) {
+        quotient = BigInt();
+        remainder = a;
+        return;
+    }
+    vector<uint32_t> q(a.limbs.size(), 0);
+    vector<uint32_t> rem;
+    if (b.limbs.size() == 1) {    // 除数只有一个 limb：短除法
+        uint64_t r = 0, d = b.limbs[0];
+        for (size_t i = a.limbs.size(); i-- > 0;) {
+            uint64_t cur = r * BASE + a.limbs[i];
+            q[i] = static_cast<uint32_t>(cur / d);
+            r = cur % d;
+        }
+        if (r) rem.push_back(static_cast<uint32_t>(r));
+    } else {
+        int divisorScale = 0;
+        double divisorTop = leadingApprox(b.limbs, divisorScale);
+        for (size_t i = a.limbs.size(); i-- > 0;) {
+            rem.insert(rem.begin(), a.limbs[i]);    // 余数左移一个 limb 并移入新的一位
+            while (!rem.empty() && rem.back() == 0) rem.pop_back();
+            if (compareMagnitude(rem, b.limbs) < 0) continue;
+            int remScale = 0;
+            double estimate = leadingApprox(rem, remScale) / divisorTop;
+            estimate *= std::pow(static_cast<double>(BASE), remScale - divisorScale);
+            uint32_t digit = static_cast<uint32_t>(min(max(estimate, 0.0), static_cast<double>(BASE - 1)));
+            vector<uint32_t> product = mulSmall(b.limbs, digit);
+            while (compareMagnitude(product, rem) > 0) {    // 估计偏大
+                digit--;
+                product = subMagnitude(product, b.limbs);
+            }
+            rem = subMagnitude(rem, product);
+            while (compareMagnitude(rem, b.limbs) >= 0) {   // 估计偏小
+                digit++;
+                rem = subMagnitude(rem, b.limbs);
+            }
+            q[i] = digit;
+        }
+    }
+    quotient.limbs = q;
+    quotient.negative = a.negative != b.negative;
+    quotient.trim();
+    remainder.limbs = rem;
+    remainder.negative = a.negative;
+    remainder.trim();
+}
+
+BigInt BigInt::operator/(const BigInt& other) const {
+    BigInt q, r;
+    divMod(*this, other, q, r);
+    return q;
+}
+
+BigInt BigInt::operator%(const BigInt& other) const {
+    BigInt q, r;
+    divMod(*this, other, q, r);
+    return r;
+}
+
+BigInt BigInt::multiplyPow10(size_t k) const {    // 乘以 10^k
+    if (limbs.empty() || k == 0) return *this;
+    BigInt r;
+    r.limbs.assign(k / 9, 0);
+    vector<uint32_t> scaled = mulSmall(limbs, POW10[k % 9]);
+    r.limbs.insert(r.limbs.end(), scaled.begin(), scaled.end());
+    r.negative = negative;
+    r.trim();
+    return r;
+}
+
+BigInt BigInt::dividePow10(size_t k, bool roundHalfEven) const {    // 除以 10^k
+    if (limbs.empty() || k == 0) return *this;
+    if (k > digitCount() + 1) return BigInt();    // 商和舍入结果都是 0
+    BigInt divisor = BigInt(1).multiplyPow10(k);
+    BigInt q, r;
+    divMod(*this, divisor, q, r);
+    if (roundHalfEven && !r.isZero()) {
+        int cmp = compareMagnitude(mulSmall(r.limbs, 2), divisor.limbs);
+        bool odd = !q.limbs.empty() && (q.limbs[0] % 2 == 1);
+        if (cmp > 0 || (cmp == 0 && odd)) q = q + BigInt(negative ? -1 : 1);    // 远离 0 进位
+    }
+    return q;
+}
+
+BigInt BigInt::abs() const {
+    BigInt r(*this);
+    r.negative = false;
+    return r;
+}
+
+int BigInt::compare(const BigInt& other) const {    // 比较大小
+    if (negative != other.negative) return negative ? -1 : 1;
+    int cmp = compareMagnitude(limbs, other.limbs);
+    return negative ? -cmp : cmp;
+}
+
+BigInt BigInt::gcd(BigInt a, BigInt b) {    // 辗转相除
+    a = a.abs();
+    b = b.abs();
+    while (!b.isZero()) {
+        BigInt t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/*按位运算采用无限长二进制补码语义：负数 x 表示为 ~(|x| - 1)，
+高位无限延伸符号位。结果为负时再转换回来。*/
+BigInt BigInt::bitwise(const BigInt& a, const BigInt& b, char op) {
+    if (a.fitsInt64() && b.fitsInt64()) {
+        int64_t x = a.toInt64(), y = b.toInt64();
+        return BigInt(op == '&' ? (x & y) : (x | y));
+    }
+    static const BigInt WORD(static_cast<int64_t>(1) << 32);
+    auto toWords = [](const BigInt& v) {    // 补码形式的 32 位字（低位在前）
+        BigInt mag = v.negative ? v.abs() - BigInt(1) : v;
+        vector<uint32_t> words;
+        while (!mag.isZero()) {
+            BigInt q, r;
+            divMod(mag, WORD, q, r);
+            words.push_back(static_cast<uint32_t>(r.toInt64()));
+            mag = q;
+        }
+        if (v.negative) for (uint32_t& w : words) w = ~w;
+        return words;
+    };
+    vector<uint32_t> x = toWords(a), y = toWords(b);
+    uint32_t xFill = a.negative ? 0xFFFFFFFFu : 0, yFill = b.negative ? 0xFFFFFFFFu : 0;
+    size_t n = max(x.size(), y.size());
+    vector<uint32_t> words(n);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t xw = i < x.size() ? x[i] : xFill, yw = i < y.size() ? y[i] : yFill;
+        words[i] = (op == '&') ? (xw & yw) : (xw | yw);
+    }
+    bool resultNegative = (op == '&') ? (a.negative && b.negative) : (a.negative || b.negative);
+    if (resultNegative) for (uint32_t& w : words) w = ~w;
+    BigInt r;
+    for (size_t i = n; i-- > 0;) r = r * WORD + BigInt(static_cast<int64_t>(words[i]));
+    return resultNegative ? -(r + BigInt(1)) : r;
+}
+
+// ==================== BigRational ====================
+
+namespace {
+
+// 解析数字字面量为 digits × 10^exponent（digits 可带负号）
+void parseDecimalLiteral(const string& text, BigInt& digits, int64_t& exponent) {
+    size_t i = 0;
+    bool neg = false;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) { neg = text[i] == '-'; i++; }
+    string body;
+    int64_t fraction = 0;
+    bool seenDot = false;
+    for (; i < text.size() && (isdigit(static_cast<unsigned char>(text[i])) || text[i] == '.'); i++) {
+        if (text[i] == '.') {
+            if (seenDot) throw runtime_error("无效的数字格式 (Invalid number format): " + text);
+            seenDot = true;
+        } else {
+            body += text[i];
+            if (seenDot) fraction++;
+        }
+    }
+    if (body.empty()) throw runtime_error("无效的数字格式 (Invalid number format): " + text);
+    int64_t exp10 = 0;
+    if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+        string e = text.substr(i + 1);
+        char* end = nullptr;
+        exp10 = strtoll(e.c_str(), &end, 10);
+        if (e.empty() || *end != '\0') throw runtime_error("无效的数字格式 (Invalid number format): " + text);
+        i = text.size();
+    }
+    if (i != text.size()) throw runtime_error("无效的数字格式 (Invalid number format): " + text);
+    if (exp10 > 100000 || exp10 < -100000) throw runtime_error("指数过大 (Exponent too large): " + text);
+    digits = BigInt::fromString((neg ? "-" : "") + body);
+    exponent = exp10 - fraction;
+}
+
+}  // namespace
+
+BigRational::BigRational() : num(0), den(1) {}
+
+BigRational::BigRational(const BigInt& numerator, const BigInt& denominator) : num(numerator), den(denominator) {
+    normalize();
+}
+
+void BigRational::normalize() {    // 约分并保证分母为正
+    if (den.isZero()) throw runtime_error("除数不能为零 (Division by zero)");
+    if (den.isNegative()) { num = -num; den = -den; }
+    BigInt g = BigInt::gcd(num, den);
+    if (g != BigInt(1) && !g.isZero()) {
+        num = num / g;
+        den = den / g;
+    }
+}
+
+BigRational BigRational::fromLiteral(const string& text) {    // 由数字字面量精确构造
+    if (text == "pi" || text == "e") {
+        throw runtime_error("常量 " + text + " 不是有理数 (Constant " + text + " is not rational)");
+    }
+    BigInt digits;
+    int64_t exponent = 0;
+    parseDecimalLiteral(text, digits, exponent);
+    if (exponent >= 0) return BigRational(digits.multiplyPow10(static_cast<size_t>(exponent)));
+    return BigRational(digits, BigInt(1).multiplyPow10(static_cast<size_t>(-exponent)));
+}
+
+double BigRational::toDouble() const {    // 保留约 20 位有效数字后交给 strtod
+    if (num.isZero()) return 0;
+    int64_t k = 20 - (static_cast<int64_t>(num.digitCount()) - static_cast<int64_t>(den.digitCount()));
+    BigInt q = (k >= 0) ? num.multiplyPow10(static_cast<size_t>(k)) / den
+                        : num / den.multiplyPow10(static_cast<size_t>(-k));
+    return strtod((q.toString() + "e" + to_string(-k)).c_str(), nullptr);
+}
+
+string BigRational::toString() const {
+    return isInteger() ? num.toString() : num.toString() + "/" + den.toString();
+}
+
+BigRational BigRational::operator-() const { return BigRational(-num, den); }
+BigRational BigRational::operator+(const BigRational& o) const { return BigRational(num * o.den + o.num * den, den * o.den); }
+BigRational BigRational::operator-(const BigRational& o) const { return BigRational(num * o.den - o.num * den, den * o.den); }
+BigRational BigRational::operator*(const BigRational& o) const { return BigRational(num * o.num, den * o.den); }
+
+BigRational BigRational::operator/(const BigRational& o) const {
+    if (o.num.isZero()) throw runtime_error("除数不能为零 (Division by zero)");
+    return BigRational(num * o.den, den * o.num);
+}
+
+BigInt BigRational::truncate() const { return num / den; }
+
+// ==================== BigFloat ====================
+
+thread_local size_t BigFloat::precision = 50;
+
+namespace {
+
+// 临时提高工作精度，离开作用域时恢复
+class PrecisionScope {
+private:
+    size_t saved;
+public:
+    explicit PrecisionScope(size_t digits) : saved(BigFloat::getPrecision()) { BigFloat::setPrecision(digits); }
+    ~PrecisionScope() { BigFloat::setPrecision(saved); }
+};
+
+}  // namespace
+
+BigFloat::BigFloat() : mantissa(0), exponent(0) {}
+
+BigFloat::BigFloat(const BigInt& m, int64_t e, size_t digits) : mantissa(m), exponent(e) {
+    round(digits ? digits : precision);
+}
+
+void BigFloat::round(size_t digits) {    // 舍入到 digits 位有效数字
+    if (mantissa.isZero()) { exponent = 0; return; }
+    size_t count = mantissa.digitCount();
+    if (count > digits) {
+        mantissa = mantissa.dividePow10(count - digits, true);
+        exponent += static_cast<int64_t>(count - digits);
+    }
+}
+
+void BigFloat::setPrecision(size_t digits) {
+    precision = max<size_t>(digits, 1);
+}
+
+BigFloat BigFloat::fromLiteral(const string& text) {    // 由数字字面量构造
+    if (text == "pi") return pi();
+    if (text == "e") return exp(BigFloat(BigInt(1), 0));
+    BigInt digits;
+    int64_t e = 0;
+    parseDecimalLiteral(text, digits, e);
+    return BigFloat(digits, e);
+}
+
+BigFloat BigFloat::fromInteger(const BigInt& value) {
+    return BigFloat(value, 0);
+}
+
+bool BigFloat::isInteger() const {    // 是否为整数
+    if (mantissa.isZero() || exponent >= 0) return true;
+    if (static_cast<size_t>(-exponent) > mantissa.digitCount()) return false;
+    return (mantissa % BigInt(1).multiplyPow10(static_cast<size_t>(-exponent))).isZero();
+}
+
+BigInt BigFloat::truncate() const {    // 向零取整
+    if (exponent >= 0) return mantissa.multiplyPow10(static_cast<size_t>(exponent));
+    return mantissa.dividePow10(static_cast<size_t>(-exponent), false);
+}
+
+double BigFloat::toDouble() const {
+    return strtod((mantissa.toString() + "e" + to_string(exponent)).c_str(), nullptr);
+}
+
+string BigFloat::toString() const {    // 十进制字符串
+    if (mantissa.isZero()) return "0";
+    string digits = mantissa.abs().toString();
+    int64_t e = exponent;
+    while (digits.size() > 1 && digits.back() == '0') { digits.pop_back(); e++; }    // 去掉末尾的 0
+    string sign = mantissa.isNegative() ? "-" : "";
+    int64_t point = static_cast<int64_t>(digits.size()) + e;    // 小数点前的位数
+    int64_t limit = static_cast<int64_t>(precision) + 10;
+    if (e >= 0 && point <= limit) return sign + digits + string(static_cast<size_t>(e), '0');
+    if (e < 0 && point > 0) return sign + digits.substr(0, point) + "." + digits.substr(point);
+    if (point <= 0 && point > -10) return sign + "0." + string(static_cast<size_t>(-point), '0') + digits;
+    string r = sign + digits.substr(0, 1);
+    if (digits.size() > 1) r += "." + digits.substr(1);
+    return r + "e" + to_string(point - 1);
+}
+
+int BigFloat::compare(const BigFloat& other) const {
+    BigFloat diff = *this - other;
+    if (diff.isZero()) return 0;
+    return diff.isNegative() ? -1 : 1;
+}
+
+BigFloat BigFloat::operator-() const {
+    BigFloat r(*this);
+    r.mantissa = -r.mantissa;
+    return r;
+}
+
+BigFloat BigFloat::operator+(const BigFloat& other) const {
+    if (mantissa.isZero()) return BigFloat(other.mantissa, other.exponent);
+    if (other.mantissa.isZero()) return BigFloat(mantissa, exponent);
+    // 数量级相差超过精度时，较小的数可以忽略
+    int64_t top = exponent + static_cast<int64_t>(mantissa.digitCount());
+    int64_t otherTop = other.exponent + static_cast<int64_t>(other.mantissa.digitCount());
+    int64_t margin = static_cast<int64_t>(precision) + 2;
+    if (top - otherTop > margin) return BigFloat(mantissa, exponent);
+    if (otherTop - top > margin) return BigFloat(other.mantissa, other.exponent);
+    if (exponent >= other.exponent) {
+        return BigFloat(mantissa.multiplyPow10(static_cast<size_t>(exponent - other.exponent)) + other.mantissa,
+                        other.exponent);
+    }
+    return BigFloat(mantissa + other.mantissa.multiplyPow10(static_cast<size_t>(other.exponent - exponent)), exponent);
+}
+
+BigFloat BigFloat::operator-(const BigFloat& other) const {
+    return *this + (-other);
+}
+
+BigFloat BigFloat::operator*(const BigFloat& other) const {
+    return BigFloat(mantissa * other.mantissa, exponent + other.exponent);
+}
+
+BigFloat BigFloat::operator/(const BigFloat& other) const {
+    if (other.isZero()) throw runtime_error("除数不能为零 (Division by zero)");
+    if (isZero()) return BigFloat();
+    int64_t shift = static_cast<int64_t>(precision) + 2 + static_cast<int64_t>(other.mantissa.digitCount()) -
+                    static_cast<int64_t>(mantissa.digitCount());
+    if (shift < 0) shift = 0;
+    return BigFloat(mantissa.multiplyPow10(static_cast<size_t>(shift)) / other.mantissa,
+                    exponent - other.exponent - shift);
+}
+
+BigFloat BigFloat::fmod(const BigFloat& other) const {    // 对齐指数后做整数取余，结果精确
+    if (other.isZero()) throw runtime_error("除数不能为零 (Division by zero)");
+    if (isZero()) return BigFloat();
+    int64_t e = min(exponent, other.exponent);
+    if (max(exponent, other.exponent) - e > 100000) throw runtime_error("数量级相差过大 (Magnitude difference too large)");
+    BigInt a = mantissa.multiplyPow10(static_cast<size_t>(exponent - e));
+    BigInt b = other.mantissa.multiplyPow10(static_cast<size_t>(other.exponent - e));
+    return BigFloat(a % b, e);
+}
+
+/*π 使用 Machin 公式：π = 16·atan(1/5) - 4·atan(1/239)，
+atan(1/n) 的级数用 10^wp 定点整数计算，结果按精度缓存。*/
+BigFloat BigFloat::pi() {
+    thread_local size_t cachedPrecision = 0;
+    thread_local BigFloat cached;
+    if (cachedPrecision >= precision) return BigFloat(cached.mantissa, cached.exponent);
+    size_t wp = precision + 10;
+    BigInt scale = BigInt(1).multiplyPow10(wp);
+    auto atanInverse = [&](int64_t n) {
+        BigInt n2(n * n);
+        BigInt term = scale / BigInt(n);
+        BigInt sum = term;
+        for (int64_t k = 1; !term.isZero(); k++) {
+            term = term / n2;
+            BigInt part = term / BigInt(2 * k + 1);
+            sum = (k % 2) ? sum - part : sum + part;
+        }
+        return sum;
+    };
+    BigInt value = atanInverse(5) * BigInt(16) - atanInverse(239) * BigInt(4);
+    cached = BigFloat(value, -static_cast<int64_t>(wp), wp);
+    cachedPrecision = precision;
+    return BigFloat(cached.mantissa, cached.exponent);
+}
+
+namespace {
+
+// 数量级：mantissa × 10^exponent 约为 10^order
+int64_t orderOf(const BigInt& mantissa, int64_t exponent) {
+    return exponent + static_cast<int64_t>(mantissa.digitCount()) - 1;
+}
+
+}  // namespace
+
+/*exp：先把 x 除以 2^m 使其足够小，用泰勒级数求和，再平方 m 次。*/
+BigFloat BigFloat::exp(const BigFloat& x) {
+    size_t target = precision;
+    if (x.isZero()) return BigFloat(BigInt(1), 0);
+    double approx = x.toDouble();
+    if (fabs(approx) > 1e9) throw runtime_error("数值溢出 (Overflow)");
+    int m = 0;
+    while (ldexp(fabs(approx), -m) > 1e-3) m++;
+    BigFloat result;
+    {
+        PrecisionScope scope(target + 15 + m / 3);
+        BigFloat r(x.mantissa, x.exponent);
+        for (int i = 0; i < m; i++) r = r / BigFloat(BigInt(2), 0);
+        BigFloat term(BigInt(1), 0), sum(BigInt(1), 0);
+        int64_t limit = -static_cast<int64_t>(precision) - 2;
+        for (int64_t n = 1; n < 10000; n++) {
+            term = term * r / BigFloat(BigInt(n), 0);
+            sum = sum + term;
+            if (term.isZero() || orderOf(term.mantissa, term.exponent) < limit) break;
+        }
+        for (int i = 0; i < m; i++) sum = sum * sum;
+        result = sum;
+    }
+    return BigFloat(result.mantissa, result.exponent);
+}
+
+/*log：用 double 给出初值，再用 Halley 迭代 y ← y + 2(x - e^y)/(x + e^y)，每次迭代有效位数约增至三倍。*/
+BigFloat BigFloat::log(const BigFloat& x) {
+    if (x.isZero() || x.isNegative()) {
+        throw runtime_error("对数函数的参数必须大于零 (Logarithm argument must be positive)");
+    }
+    size_t target = precision;
+    int64_t digits = static_cast<int64_t>(x.mantissa.digitCount());
+    int64_t keep = min<int64_t>(digits, 17);
+    double lead = x.mantissa.dividePow10(static_cast<size_t>(digits - keep), false).toDouble();
+    double guess = std::log(lead) + static_cast<double>(x.exponent + digits - keep) * std::log(10.0);
+    BigFloat result;
+    {
+        PrecisionScope scope(target + 10);
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.17e", guess);
+        BigFloat y = fromLiteral(buffer);
+        BigFloat two(BigInt(2), 0);
+        int64_t limit = orderOf(y.mantissa, y.exponent) - static_cast<int64_t>(precision);
+        for (int iter = 0; iter < 20; iter++) {
+            BigFloat ey = exp(y);
+            BigFloat delta = two * (x - ey) / (x + ey);
+            y = y + delta;
+            if (delta.isZero() || orderOf(delta.mantissa, delta.exponent) < min<int64_t>(limit, -static_cast<int64_t>(precision))) break;
+        }
+        result = y;
+    }
+    return BigFloat(result.mantissa, result.exponent);
+}
+
+/*sin / cos：先按 2π 取余（π 的精度随 |x| 的整数位数增加），再用泰勒级数。*/
+BigFloat BigFloat::sin(const BigFloat& x) {
+    size_t target = precision;
+    if (x.isZero()) return BigFloat();
+    int64_t order = max<int64_t>(0, orderOf(x.mantissa, x.exponent));
+    BigFloat result;
+    {
+        PrecisionScope scope(target + 15 + static_cast<size_t>(order));
+        BigFloat twoPi = pi() * BigFloat(BigInt(2), 0);
+        BigFloat r = x - BigFloat::fromInteger((x / twoPi).truncate()) * twoPi;
+        BigFloat r2 = r * r;
+        BigFloat term = r, sum = r;
+        int64_t limit = -static_cast<int64_t>(precision) - 2;
+        for (int64_t n = 1; n < 10000; n++) {
+            term = -(term * r2) / BigFloat(BigInt((2 * n) * (2 * n + 1)), 0);
+            sum = sum + term;
+            if (term.isZero() || orderOf(term.mantissa, term.exponent) < limit) break;
+        }
+        result = sum;
+    }
+    return BigFloat(result.mantissa, result.exponent);
+}
+
+BigFloat BigFloat::cos(const BigFloat& x) {
+    size_t target = precision;
+    int64_t order = x.isZero() ? 0 : max<int64_t>(0, orderOf(x.mantissa, x.exponent));
+    BigFloat result;
+    {
+        PrecisionScope scope(target + 15 + static_cast<size_t>(order));
+        BigFloat twoPi = pi() * BigFloat(BigInt(2), 0);
+        BigFloat r = x - BigFloat::fromInteger((x / twoPi).truncate()) * twoPi;
+        BigFloat r2 = r * r;
+        BigFloat term(BigInt(1), 0), sum(BigInt(1), 0);
+        int64_t limit = -static_cast<int64_t>(precision) - 2;
+        for (int64_t n = 1; n < 10000; n++) {
+            term = -(term * r2) / BigFloat(BigInt((2 * n - 1) * (2 * n)), 0);
+            sum = sum + term;
+            if (term.isZero() || orderOf(term.mantissa, term.exponent) < limit) break;
+        }
+        result = sum;
+    }
+    return BigFloat(result.mantissa, result.exponent);
+}
+
+BigFloat BigFloat::tan(const BigFloat& x) {
+    size_t target = precision;
+    BigFloat result;
+    {
+        PrecisionScope scope(target + 5);
+        result = sin(x) / cos(x);
+    }
+    return BigFloat(result.mantissa, result.exponent);
+}
+
+/*pow：整数指数用快速幂；非整数指数要求底数为正，按 exp(b·log a) 计算。*/
+BigFloat BigFloat::pow(const BigFloat& a, const BigFloat& b) {
+    size_t target = precision;
+    if (b.isZero()) return BigFloat(BigInt(1), 0);
+    BigFloat result;
+    if (b.isInteger()) {
+        BigInt n = b.truncate();
+        if (!n.fitsInt64()) throw runtime_error("指数过大 (Exponent too large)");
+        int64_t e = n.toInt64();
+        if (a.isZero()) {
+            if (e < 0) throw runtime_error("除数不能为零 (Division by zero)");
+            return BigFloat();
+        }
+        uint64_t k = e < 0 ? 0 - static_cast<uint64_t>(e) : static_cast<uint64_t>(e);
+        {
+            PrecisionScope scope(target + 10 + 20);
+            BigFloat base = a, acc(BigInt(1), 0);
+            while (k) {
+                if (k & 1) acc = acc * base;
+                k >>= 1;
+                if (k) base = base * base;
+            }
+            result = e < 0 ? BigFloat(BigInt(1), 0) / acc : acc;
+        }
+        return BigFloat(result.mantissa, result.exponent);
+    }
+    if (a.isZero()) {
+        if (b.isNegative()) throw runtime_error("除数不能为零 (Division by zero)");
+        return BigFloat();
+    }
+    if (a.isNegative()) throw runtime_error("负数不能取非整数次幂 (Negative base with non-integer exponent)");
+    {
+        PrecisionScope scope(target + 10);
+        result = exp(b * log(a));
+    }
+    return BigFloat(result.mantissa, result.exponent);
+}
@@ -0,0 +1,128 @@
+#ifndef BIG_NUMBER_H    // 防止头文件重复包含
+#define BIG_NUMBER_H    // 定义头文件宏
+
+#include <string>     // 包含字符串处理
+#include <vector>     // 包含向量容器
+#include <cstdint>    // 定长整数类型
+using namespace std;  // 使用标准命名空间
+
+/*任意精度数值类型：
+BigInt       任意长度整数（以 10^9 为基的limb，小端存放）
+BigRational  精确有理数（分子 / 分母，始终约分，分母为正）
+BigFloat     十进制多精度浮点数（mantissa × 10^exponent，保留 getPrecision() 位有效数字）*/
+
+class BigInt {    // 任意长度整数
+private:
+    bool negative;               // 符号
+    vector<uint32_t> limbs;      // 绝对值，每个 limb 存 9 位十进制数，低位在前
+
+    void trim();                 // 去掉高位的 0
+    static int compareMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b);  // 比较绝对值
+    static vector<uint32_t> addMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b);
+    static vector<uint32_t> subMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b);  // 要求 |a| >= |b|
+
+public:
+    static const uint32_t BASE = 1000000000;    // limb 的基数
+
+    BigInt();                        // 构造 0
+    BigInt(int64_t value);           // 由 64 位整数构造
+    static BigInt fromString(const string& digits);    // 由十进制数字串构造（可带负号）
+
+    bool isZero() const { return limbs.empty(); }     // 是否为 0
+    bool isNegative() const { return negative; }      // 是否为负
+    bool fitsInt64() const;                           // 是否在 int64 范围内
+    int64_t toInt64() const;                          // 转为 int64（调用前检查 fitsInt64）
+    double toDouble() const;                          // 转为 double（近似）
+    size_t digitCount() const;                        // 十进制位数（0 的位数为 0）
+    string toString() const;                          // 十进制字符串
+
+    BigInt operator-() const;
+    BigInt operator+(const BigInt& other) const;
+    BigInt operator-(const BigInt& other) const;
+    BigInt operator*(const BigInt& other) const;
+    static void divMod(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder);  // 向零截断除法
+    BigInt operator/(const BigInt& other) const;
+    BigInt operator%(const BigInt& other) const;     // 余数与被除数同号
+    BigInt multiplyPow10(size_t k) const;            // 乘以 10^k
+    BigInt dividePow10(size_t k, bool roundHalfEven) const;    // 除以 10^k（截断或四舍六入五成双）
+    BigInt abs() const;
+
+    int compare(const BigInt& other) const;           // 比较大小，返回 -1 / 0 / 1
+    bool operator==(const BigInt& other) const { return compare(other) == 0; }
+    bool operator!=(const BigInt& other) const { return compare(other) != 0; }
+    bool operator<(const BigInt& other) const { return compare(other) < 0; }
+
+    static BigInt gcd(BigInt a, BigInt b);            // 最大公约数（非负）
+    static BigInt bitwise(const BigInt& a, const BigInt& b, char op);    // 按位与 / 或（二进制补码语义）
+};
+
+class BigRational {    // 精确有理数
+private:
+    BigInt num;    // 分子
+    BigInt den;    // 分母（> 0）
+
+    void normalize();    // 约分并保证分母为正
+
+public:
+    BigRational();                                   // 构造 0
+    BigRational(const BigInt& numerator, const BigInt& denominator = BigInt(1));
+    static BigRational fromLiteral(const string& text);    // 由数字字面量（如 1.5e-3）精确构造
+
+    const BigInt& numerator() const { return num; }
+    const BigInt& denominator() const { return den; }
+    bool isInteger() const { return den == BigInt(1); }
+    bool isZero() const { return num.isZero(); }
+    double toDouble() const;
+    string toString() const;    // 形如 "7/3"，整数时只输出分子
+
+    BigRational operator-() const;
+    BigRational operator+(const BigRational& other) const;
+    BigRational operator-(const BigRational& other) const;
+    BigRational operator*(const BigRational& other) const;
+    BigRational operator/(const BigRational& other) const;
+    BigInt truncate() const;    // 向零取整
+};
+
+class BigFloat {    // 十进制多精度浮点数
+private:
+    BigInt mantissa;    // 尾数
+    int64_t exponent;   // 十进制指数：值 = mantissa × 10^exponent
+
+    static thread_local size_t precision;    // 有效数字位数（每个线程独立）
+
+    void round(size_t digits);    // 舍入到 digits 位有效数字
+
+public:
+    BigFloat();                                            // 构造 0
+    BigFloat(const BigInt& m, int64_t e, size_t digits = 0);    // 由尾数和指数构造（digits 为 0 时使用全局精度）
+    static BigFloat fromLiteral(const string& text);       // 由数字字面量构造
+    static BigFloat fromInteger(const BigInt& value);      // 由整数构造
+
+    static void setPrecision(size_t digits);               // 设置有效数字位数
+    static size_t getPrecision() { return precision; }     // 获取有效数字位数
+
+    bool isZero() const { return mantissa.isZero(); }
+    bool isNegative() const { return mantissa.isNegative(); }
+    bool isInteger() const;                                // 是否为整数
+    BigInt truncate() const;                               // 向零取整
+    double toDouble() const;
+    string toString() const;                               // 按当前精度输出十进制字符串
+    int compare(const BigFloat& other) const;
+
+    BigFloat operator-() const;
+    BigFloat operator+(const BigFloat& other) const;
+    BigFloat operator-(const BigFloat& other) const;
+    BigFloat operator*(const BigFloat& other) const;
+    BigFloat operator/(const BigFloat& other) const;
+    BigFloat fmod(const BigFloat& other) const;            // 余数与被除数同号（精确）
+
+    static BigFloat pi();                                  // 当前精度下的 π
+    static BigFloat exp(const BigFloat& x);
+    static BigFloat log(const BigFloat& x);
+    static BigFloat sin(const BigFloat& x);
+    static BigFloat cos(const BigFloat& x);
+    static BigFloat tan(const BigFloat& x);
+    static BigFloat pow(const BigFloat& a, const BigFloat& b);
+};
+
+#endif // BIG_NUMBER_H    // 结束头文件保护
@@ -1,4 +1,5 @@
 #include "calculator.h"    // 包含计算器头文件
+#include "char_table.h"       // 共享的字符分类与优先级表
 #include <iostream>      
 #include <iomanip>      
 #include <sstream>       
@@ -8,25 +9,14 @@
 using namespace std;     
 
 Calculator::Calculator() {   
-    initPrecedence();      
     initConstants();         
-    initPriorityTable();     
     clearError();           
+    infixEvaluator.setMaxDepth(limits.maxDepth);
 }
 
-void Calculator::initPrecedence() {    
-    precedence['+'] = 1;    
-    precedence['-'] = 1;    
-    precedence['*'] = 2;    
-    precedence['/'] = 2;    
-    precedence['%'] = 2;    
-    precedence['^'] = 3;    
-    precedence['&'] = 1;   
-    precedence['|'] = 1;   
-    precedence['s'] = 4;    
-    precedence['c'] = 4;    
-    precedence['t'] = 4;    
-    precedence['l'] = 4;    
+void Calculator::setLimits(const EvaluationLimits& newLimits) {    // 设置限制
+    limits = newLimits;
+    infixEvaluator.setMaxDepth(limits.maxDepth);
 }
 
 void Calculator::initConstants() {    // 初始化数学常量
@@ -34,100 +24,8 @@ void Calculator::initConstants() {    // 初始化数学常量
     constants["e"] = 2.71828182845904523536;    
 }
 
-void Calculator::initPriorityTable() {    // 初始化优先级表（无使用）
-    // 设置运算符优先级关系
-    // '>' 表示优先级高，'<' 表示优先级低，'=' 表示优先级相等
-    vector<char> ops = {'+', '-', '*', '/', '%', '^', '(', ')', '&', '|'};    // 所有运算符
-    for (char op1 : ops) {   
-        for (char op2 : ops) {    
-            if (op1 == '(' && op2 == ')') {    
-                priorityTable[{op1, op2}] = '=';
-            } else if (op1 == '(' || op2 == '(') {    
-                priorityTable[{op1, op2}] = '<';
-            } else if (op1 == ')' || op2 == ')') {    
-                priorityTable[{op1, op2}] = '>';
-            } else {    
-                if (precedence[op1] > precedence[op2]) {
-                    priorityTable[{op1, op2}] = '>';
-                } else if (precedence[op1] < precedence[op2]) {
-                    priorityTable[{op1, op2}] = '<';
-                } else {
-                    priorityTable[{op1, op2}] = '=';
-                }
-            }
-        }
-    }
-}
-
 bool Calculator::isOperator(char c) const {    
-    return c == '+' || c == '-' || c == '*' || c == '/' || c == '%' || 
-           c == '^' || c == '&' || c == '|' || c == 's' || c == 'c' || 
-           c == 't' || c == 'l';
-}
-
-bool Calculator::isNumber(char c) const {   
-    return (c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E';
-}
-
-bool Calculator::isFunction(char c) const {   
-    return c == 's' || c == 'c' || c == 't' || c == 'l';
-}
-
-double Calculator::evaluateOperation(double a, double b, char op) {    // 执行运算操作
-    switch (op) {
-        case '+': return a + b;               
-        case '-': return a - b;                
-        case '*': return a * b;                
-        case '/':                            
-            if (b == 0) throw runtime_error("除数不可为零。Division by zero");    
-            return a / b;
-        case '%': return fmod(a, b);           
-        case '^': return pow(a, b);          
-        case '&': return static_cast<int>(a) & static_cast<int>(b);   
-        case '|': return static_cast<int>(a) | static_cast<int>(b);   
-        case 's': return sin(b);              
-        case 'c': return cos(b);            
-        case 't': return tan(b);               
-        case 'l': return log(b);             
-        default: throw runtime_error("未知运算符。Unknown operator");  
-    }
-}
-
-void Calculator::displayStacks(const string& remainingExpr) const {    // 显示栈的状态
-    cout << "\n当前状态 (Current State):" << endl;
-    cout << "剩余表达式 (Remaining): " << remainingExpr << endl;   
-    
-    // 显示数字栈
-    cout << "数字栈 (Numbers): |";
-    stack<double> tempNum = numberStack;
-    vector<double> nums;
-    while (!tempNum.empty()) {    // 将栈中元素复制到向量中
-        nums.push_back(tempNum.top());
-        tempNum.pop();
-    }
-    for (auto it = nums.rbegin(); it != nums.rend(); ++it) {    // 按原始顺序显示
-        cout << fixed << setprecision(2) << *it << "|";
-    }
-    cout << endl;
-    
-    // 显示运算符栈
-    cout << "运算符栈 (Operators): |";
-    stack<char> tempOp = operatorStack;
-    vector<char> ops;
-    while (!tempOp.empty()) {    // 将栈中元素复制到向量中
-        ops.push_back(tempOp.top());
-        tempOp.pop();
-    }
-    for (auto it = ops.rbegin(); it != ops.rend(); ++it) {    // 按原始顺序显示
-        cout << *it << "|";
-    }
-    cout << endl;
-    cout << "----------------------------------------" << endl;
-}
-
-void Calculator::displayStep(const string& remainingExpr, const string& operation) {    // 显示计算步骤
-    cout << "\n执行操作 (Operation): " << operation << endl;
-    displayStacks(remainingExpr);
+    return CharTable::isOperator(c);
 }
 
 void Calculator::setError(const string& message) {    // 设置错误信息
@@ -145,24 +43,33 @@ double Calculator::evaluate(const string& expression, ExpressionType type) {
     clearError();    // 清除之前的错误状态
     
     try {
+        // 先做 O(n) 的向量化预扫描：长度、嵌套深度、非法字符、括号匹配，在完整解析前拒绝病态输入
+        PrescanResult scan = HardenedEvaluator::checkLimits(expression, limits);
+
         // 按表达式类型分别验证
         bool valid = false;
         string errorType = "";
         
         switch (type) {
             case ExpressionType::INFIX:
+                if (scan.illegalPos != PrescanResult::npos) {
+                    setError(string("非法字符 (Invalid character): ") + expression[scan.illegalPos]);
+                    return 0.0;
+                }
+                if (!scan.bracketsMatch()) {
+                    setError("括号不匹配错误 (Mismatched parentheses error)");
+                    return 0.0;
+                }
                 valid = infixEvaluator.validateExpression(expression);
                 if (!valid) {
-                    // 检查具体的错误类型
-                    if (hasConsecutiveOperators(expression)) {
-                        setError("连续运算符错误 (Consecutive operators error)");
-                    } else if (hasMismatchedParentheses(expression)) {
-                        setError("括号不匹配错误 (Mismatched parentheses error)");
-                    } else if (hasMissingOperator(expression)) {
-                        setError("缺少运算符错误 (Missing operator error)");
-                    } else {
-                        setError("无效的表达式格式 (Invalid expression format)");
+                    // 具体的错误类型由编译器（Pratt 解析器）报告，与其他入口一致
+                    try {
+                        ExpressionCompiler::compileInfix(expression, limits.maxDepth);
+                    } catch (const EvaluationError& e) {
+                        setError(e.what());
+                        return 0.0;
                     }
+                    setError("无效的表达式格式 (Invalid expression format)");
                     return 0.0;
                 }
                 return infixEvaluator.evaluate(expression);
@@ -197,153 +104,96 @@ double Calculator::evaluate(const string& expression) {    // 默认求值中缀
     return evaluate(expression, ExpressionType::INFIX);
 }
 
-bool Calculator::validateExpression(const string& expr) const {
-    int parentheses = 0;
-    bool lastWasOperator = true;
-    bool lastWasNumber = false;
-    bool hasOperator = false;
-    bool hasNumber = false;
-    bool hasDecimalPoint = false;
-    
-    for (size_t i = 0; i < expr.length(); i++) {
-        char c = expr[i];
-        
-        if (isspace(c)) continue;
-        
-        if (c == '(') {
-            if (lastWasNumber) {
-                return false;
-            }
-            parentheses++;
-            lastWasOperator = true;
-            lastWasNumber = false;
-            hasDecimalPoint = false;
-        }
-        else if (c == ')') {
-            if (lastWasOperator) {
-                return false;
-            }
-            parentheses--;
-            if (parentheses < 0) return false;
-            lastWasOperator = false;
-            lastWasNumber = true;
-            hasDecimalPoint = false;
-        }
-        else if (isOperator(c)) {
-            if (lastWasOperator && c != '-') {
-                return false;
-            }
-            hasOperator = true;
-            lastWasOperator = true;
-            lastWasNumber = false;
-            hasDecimalPoint = false;
+CompiledExpression Calculator::compile(const string& expression, ExpressionType type) const {    // 按类型编译表达式
+    HardenedEvaluator::checkLimits(expression, limits);
+    return ExpressionCompiler::compile(expression, type, limits.maxDepth);
+}
+
+string Calculator::evaluateWithMode(const string& expression, ExpressionType type, NumericMode mode, size_t digits) {    // 按数值模式求值
+    clearError();
+    try {
+        CompiledExpression compiled = compile(expression, type);
+        if (!compiled.getVariables().empty()) {
+            setError("表达式包含未赋值的变量 (Expression contains unbound variables): " + compiled.getVariables()[0]);
+            return "";
         }
-        else if (isdigit(c)) {
-            if (c == '.' && hasDecimalPoint) {
-                return false;
-            }
-            if (c == '.') {
-                hasDecimalPoint = true;
+        switch (mode) {
+            case NumericMode::DOUBLE: {
+                ostringstream out;
+                out << fixed << setprecision(10) << NumericEngine<double>::evaluate(compiled);
+                return out.str();
             }
-            hasNumber = true;
-            lastWasOperator = false;
-            lastWasNumber = true;
-        }
-        else if (isFunction(c)) {
-            if (lastWasNumber) {
-                return false;
+            case NumericMode::INT64:
+                return NumericTraits<int64_t>::toString(NumericEngine<int64_t>::evaluate(compiled));
+            case NumericMode::RATIONAL:
+                return NumericTraits<BigRational>::toString(NumericEngine<BigRational>::evaluate(compiled));
+            case NumericMode::DECIMAL: {
+                if (digits == 0 || digits > MAX_DECIMAL_DIGITS) {
+                    setError("位数必须是 1 到 " + to_string(MAX_DECIMAL_DIGITS) + " 之间的整数 (Digits must be an integer between 1 and "
+                             + to_string(MAX_DECIMAL_DIGITS) + ")");
+                    return "";
+                }
+                size_t saved = BigFloat::getPrecision();
+                BigFloat::setPrecision(digits);
+                string result;
+                try {
+                    result = NumericTraits<BigFloat>::toString(NumericEngine<BigFloat>::evaluate(compiled));
+                } catch (...) {
+                    BigFloat::setPrecision(saved);
+                    throw;
+                }
+                BigFloat::setPrecision(saved);
+                return result;
             }
-            hasOperator = true;
-            lastWasOperator = true;
-            lastWasNumber = false;
-            hasDecimalPoint = false;
-        }
-        else if (c == 'p' && i + 1 < expr.length() && expr[i + 1] == 'i') {
-            hasNumber = true;
-            lastWasOperator = false;
-            lastWasNumber = true;
-            i++; // 跳过'i'
-            hasDecimalPoint = false;
-        }
-        else if (c == 'e' && (i == 0 || !isdigit(expr[i-1]))) {
-            hasNumber = true;
-            lastWasOperator = false;
-            lastWasNumber = true;
-            hasDecimalPoint = false;
-        }
-        else {
-            return false;
         }
+        setError("未知的数值模式 (Unknown numeric mode)");
+        return "";
+    } catch (const runtime_error& e) {
+        setError(e.what());
+        return "";
     }
-    
-    return parentheses == 0 && !lastWasOperator && hasNumber;
 }
 
-const map<string, double>& Calculator::getConstants() const {    // 获取数学常量映射
-    return constants;
+EvaluationService& Calculator::getService() {    // 首次使用时按当前限制创建服务
+    lock_guard<mutex> guard(serviceLock);
+    if (!service) {
+        ServiceOptions options;
+        options.limits = limits;
+        service = make_unique<EvaluationService>(options);
+    }
+    return *service;
 }
 
-const map<char, int>& Calculator::getPrecedence() const {    // 获取运算符优先级映射
-    return precedence;
+void Calculator::setServiceOptions(const ServiceOptions& options) {    // 原地重新配置服务，已交出的引用不会悬空
+    lock_guard<mutex> guard(serviceLock);
+    if (service) service->reconfigure(options);
+    else service = make_unique<EvaluationService>(options);
 }
 
-// 检查是否有连续运算符
-bool Calculator::hasConsecutiveOperators(const string& expr) const {
-    bool lastWasOperator = true;
-    for (size_t i = 0; i < expr.length(); i++) {
-        char c = expr[i];
-        if (isspace(c)) continue;
-        // 如果是函数名且后面是'('，不算连续运算符
-        if (isFunction(c) && i + 1 < expr.length() && expr[i + 1] == '(') {
-            lastWasOperator = false;
-            continue;
-        }
-        if (isOperator(c)) {
-            if (lastWasOperator && c != '-') {
-                return true;
-            }
-            lastWasOperator = true;
-        } else if (isdigit(c) || c == '.' || c == '(' || c == 'p' || c == 'e') {
-            lastWasOperator = false;
-        }
-    }
-    return false;
+future<EvaluationResult> Calculator::submit(const string& expression, ExpressionType type, const CancellationToken& token) {    // 异步求值
+    return getService().submit(expression, type, token);
 }
 
-// 检查括号是否匹配
-bool Calculator::hasMismatchedParentheses(const string& expr) const {
-    int parentheses = 0;
-    for (char c : expr) {
-        if (c == '(') parentheses++;
-        else if (c == ')') parentheses--;
-        if (parentheses < 0) return true;
-    }
-    return parentheses != 0;
+void Calculator::submit(const string& expression, ExpressionType type, EvaluationService::Callback callback, const CancellationToken& token) {    // 异步求值（回调）
+    getService().submit(expression, type, move(callback), token);
 }
 
-// 检查是否缺少运算符
-bool Calculator::hasMissingOperator(const string& expr) const {
-    bool hasOperator = false;
-    bool hasNumber = false;
-    bool lastWasNumber = false;
-    
-    for (size_t i = 0; i < expr.length(); i++) {
-        char c = expr[i];
-        if (isspace(c)) continue;
-        
-        if (isdigit(c) || c == '.' || c == 'p' || c == 'e') {
-            hasNumber = true;
-            if (lastWasNumber) {
-                return true; // 两个数字之间没有运算符
-            }
-            lastWasNumber = true;
-        } else if (isOperator(c)) {
-            hasOperator = true;
-            lastWasNumber = false;
-        } else if (c == '(' || c == ')') {
-            lastWasNumber = false;
+double Calculator::evaluateParallel(const string& expression, ExpressionType type, const ParallelOptions& options) {    // 多线程求值
+    clearError();
+    try {
+        CompiledExpression compiled = compile(expression, type);
+        if (!compiled.getVariables().empty()) {
+            setError("表达式包含未赋值的变量 (Expression contains unbound variables): " + compiled.getVariables()[0]);
+            return 0.0;
         }
+        ParallelEvaluator evaluator(options);
+        return evaluator.evaluate(compiled);
+    } catch (const runtime_error& e) {
+        setError(e.what());
+        return 0.0;
     }
-    
-    return hasNumber && !hasOperator;
-}
\ No newline at end of file
+}
+
+const map<string, double>& Calculator::getConstants() const {    // 获取数学常量映射
+    return constants;
+}
@@ -4,57 +4,41 @@
 #include "infix_evaluator.h"     // 包含中缀表达式求值器
 #include "prefix_evaluator.h"    // 包含前缀表达式求值器
 #include "postfix_evaluator.h"   // 包含后缀表达式求值器
+#include "expression_compiler.h" // 包含表达式编译器
+#include "numeric_engine.h"      // 包含多数值类型求值引擎
+#include "hardened_evaluator.h"  // 包含长度与深度限制
+#include "parallel_evaluator.h"  // 包含超大表达式的并行求值
+#include "evaluation_service.h"  // 包含异步求值服务
+#include "expression_type.h"     // 包含表达式类型
 #include <string>               // 包含字符串处理
-#include <stack>               // 包含栈数据结构
 #include <map>                // 包含映射数据结构
-#include <vector>             // 包含向量数据结构
-#include <cmath>              // 包含数学函数
+#include <memory>             // 包含智能指针
+#include <mutex>              // 包含互斥锁
 
 using namespace std;          // 使用标准命名空间
 
-enum class ExpressionType {   // 表达式类型枚举类
-    INFIX = 1,               // 中缀表达式
-    PREFIX = 2,              // 前缀表达式
-    POSTFIX = 3              // 后缀表达式
-};
-
 class Calculator {           // 计算器类
 private:
     InfixEvaluator infixEvaluator;        // 中缀表达式求值器
     PrefixEvaluator prefixEvaluator;      // 前缀表达式求值器
     PostfixEvaluator postfixEvaluator;    // 后缀表达式求值器
-    
-    // 数字和运算符的栈
-    stack<double> numberStack;    // 数字栈
-    stack<char> operatorStack;    // 运算符栈
-    
-    // 运算符优先级和常量的映射
-    map<char, int> precedence;           // 运算符优先级映射
-    map<string, double> constants;       // 数学常量映射
-    map<pair<char, char>, char> priorityTable;  // 运算符优先级表
+
+    map<string, double> constants;        // 数学常量映射
+
+    EvaluationLimits limits;              // 表达式长度与嵌套深度限制
+
+    unique_ptr<EvaluationService> service;  // 异步求值服务（首次使用时创建）
+    mutex serviceLock;                      // 保护 service 的创建与替换
 
     // 错误处理相关
     string errorMessage;                  // 错误信息
     bool hasError;                        // 是否有错误
 
-    // 辅助函数
-    void initPrecedence();      // 初始化运算符优先级
     void initConstants();       // 初始化数学常量
-    void initPriorityTable();   // 初始化优先级表
-    bool isNumber(char c) const;      // 判断是否为数字
-    bool isFunction(char c) const;    // 判断是否为函数
-    double evaluateOperation(double a, double b, char op);  // 执行运算操作
-    void displayStacks(const string& remainingExpr) const;  // 显示栈的状态
-    bool validateExpression(const string& expr) const;      // 验证表达式合法性
     
     // 错误处理函数
     void setError(const string& message);  // 设置错误信息
     void clearError();                     // 清除错误状态
-    
-    // 具体错误检查函数
-    bool hasConsecutiveOperators(const string& expr) const;  // 检查连续运算符
-    bool hasMismatchedParentheses(const string& expr) const; // 检查括号不匹配
-    bool hasMissingOperator(const string& expr) const;       // 检查缺少运算符
 
 public:
     Calculator();    // 构造函数
@@ -62,14 +46,25 @@ public:
     // 表达式求值函数
     double evaluate(const string& expression, ExpressionType type);  // 根据类型求值表达式
     double evaluate(const string& expression);  // 默认使用中缀表达式求值
-    void displayStep(const string& remainingExpr, const string& operation);  // 显示求值步骤
+    CompiledExpression compile(const string& expression, ExpressionType type) const;  // 编译表达式，供反复求值和求导
+    string evaluateWithMode(const string& expression, ExpressionType type, NumericMode mode, size_t digits = 50);  // 按数值模式求值，返回结果文本
+    double evaluateParallel(const string& expression, ExpressionType type, const ParallelOptions& options = ParallelOptions());  // 多线程求值超大表达式
+
+    // 异步求值：请求进入有界队列，由工作线程成批求值；队列满时阻塞（背压）
+    future<EvaluationResult> submit(const string& expression, ExpressionType type, const CancellationToken& token = CancellationToken::none());
+    void submit(const string& expression, ExpressionType type, EvaluationService::Callback callback, const CancellationToken& token = CancellationToken::none());
+    EvaluationService& getService();                             // 获取异步求值服务，trySubmit、队列状态、协程接口都在其上
+    void setServiceOptions(const ServiceOptions& options);      // 按新选项原地重新配置服务（getService 返回的引用仍然有效）
     
     // 辅助函数
     bool isOperator(char c) const;    // 判断是否为运算符
     
-    // 获取支持的数学常量和运算符优先级
+    // 长度与嵌套深度限制
+    void setLimits(const EvaluationLimits& newLimits);                          // 设置限制（同时作用于中缀求值）
+    const EvaluationLimits& getLimits() const { return limits; }             // 获取限制
+
+    // 获取支持的数学常量
     const map<string, double>& getConstants() const;    // 获取数学常量映射
-    const map<char, int>& getPrecedence() const;        // 获取运算符优先级映射
 
     // 错误处理相关函数
     bool hasErrorOccurred() const { return hasError; }  // 检查是否有错误
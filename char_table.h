@@ -0,0 +1,133 @@
+#ifndef CHAR_TABLE_H    // 防止头文件重复包含
+#define CHAR_TABLE_H    // 定义头文件宏
+
+#include <array>      // 编译期查找表
+#include <cstdint>    // 定长整数类型
+#include <cstddef>    // size_t
+#include <string>     // 包含字符串处理
+#if defined(__SSE2__)
+#include <emmintrin.h>    // SSE2 指令（x86-64 默认可用）
+#endif
+using namespace std;  // 使用标准命名空间
+
+/*所有模块共享的字符分类与优先级表：
+以字符（按 unsigned char）为下标的 256 项编译期常量表，替代各个类中 c == '+' || c == '-' || ... 的比较链、
+switch 和 map 查找；中缀解析用的左右结合力也在这里，新增运算符只需在这几张表和 evaluateOperation 中各加一项。分类用位标志组合，一个字符可以同时属于多类（如 'e' 既是数字的一部分也是常量名首字母）。
+词法分析中跳过空白和数字串时，按 16 字节一块用 SSE2 批量判断，没有 SSE2 时退回逐字符查表。*/
+
+namespace CharTable {
+
+enum CharClass : uint8_t {    // 字符类别（位标志）
+    DIGIT         = 1 << 0,   // 0-9
+    DOT           = 1 << 1,   // 小数点
+    EXPONENT      = 1 << 2,   // 科学计数法的 e / E
+    BINARY_OP     = 1 << 3,   // 二元运算符 + - * / % ^ & |
+    FUNCTION      = 1 << 4,   // 单字母函数 s c t l
+    SPACE         = 1 << 5,   // 空白字符
+    OPEN_BRACKET  = 1 << 6,   // ( [ {
+    CLOSE_BRACKET = 1 << 7    // ) ] }
+};
+
+constexpr array<uint8_t, 256> buildClassTable() {    // 生成分类表
+    array<uint8_t, 256> table{};
+    for (int c = '0'; c <= '9'; c++) table[c] |= DIGIT;
+    table['.'] |= DOT;
+    table['e'] |= EXPONENT;
+    table['E'] |= EXPONENT;
+    for (char c : {'+', '-', '*', '/', '%', '^', '&', '|'}) table[static_cast<unsigned char>(c)] |= BINARY_OP;
+    for (char c : {'s', 'c', 't', 'l'}) table[static_cast<unsigned char>(c)] |= FUNCTION;
+    for (char c : {' ', '\t', '\n', '\r', '\v', '\f'}) table[static_cast<unsigned char>(c)] |= SPACE;
+    for (char c : {'(', '[', '{'}) table[static_cast<unsigned char>(c)] |= OPEN_BRACKET;
+    for (char c : {')', ']', '}'}) table[static_cast<unsigned char>(c)] |= CLOSE_BRACKET;
+    return table;
+}
+
+constexpr array<int8_t, 256> buildPrecedenceTable() {    // 生成优先级表（非运算符为 0）
+    array<int8_t, 256> table{};
+    table['+'] = 1; table['-'] = 1;
+    table['*'] = 2; table['/'] = 2; table['%'] = 2;
+    table['^'] = 3;
+    table['&'] = 1; table['|'] = 1;
+    table['s'] = 4; table['c'] = 4; table['t'] = 4; table['l'] = 4;    // 函数（sin, cos, tan, log）
+    return table;
+}
+
+struct BindingPower {    // Pratt 解析的结合力：left 决定能否从左边抢到操作数，right 是右操作数的最小结合力
+    int8_t left;
+    int8_t right;
+};
+
+constexpr array<BindingPower, 256> buildBindingPowerTable(const array<int8_t, 256>& precedence) {    // 生成结合力表（非二元运算符为 0）
+    array<BindingPower, 256> table{};
+    for (char c : {'+', '-', '*', '/', '%', '^', '&', '|'}) {    // 优先级 p 的左结合运算符为 (2p, 2p+1)
+        int8_t p = precedence[static_cast<unsigned char>(c)];
+        table[static_cast<unsigned char>(c)] = {static_cast<int8_t>(2 * p), static_cast<int8_t>(2 * p + 1)};
+    }
+    for (char c : {'^'}) {    // 右结合运算符为 (2p+1, 2p)：2^3^2 = 2^(3^2)
+        int8_t p = precedence[static_cast<unsigned char>(c)];
+        table[static_cast<unsigned char>(c)] = {static_cast<int8_t>(2 * p + 1), static_cast<int8_t>(2 * p)};
+    }
+    return table;
+}
+
+inline constexpr array<uint8_t, 256> CLASS = buildClassTable();            // 字符分类表
+inline constexpr array<int8_t, 256> PRECEDENCE = buildPrecedenceTable();   // 运算符优先级表
+inline constexpr array<BindingPower, 256> BINDING_POWER = buildBindingPowerTable(PRECEDENCE);    // 二元运算符结合力表
+// 一元负号的右结合力：介于乘除 (4, 5) 和幂 (7, 6) 之间，即 -x^2 = -(x^2)、-x*y = (-x)*y
+inline constexpr int8_t UNARY_MINUS_BINDING_POWER = 6;
+
+constexpr uint8_t classOf(char c) { return CLASS[static_cast<unsigned char>(c)]; }
+constexpr bool is(char c, uint8_t classes) { return (classOf(c) & classes) != 0; }    // 是否属于任一类别
+
+constexpr bool isDigit(char c) { return is(c, DIGIT); }                         // 判断是否为数字字符 0-9
+constexpr bool isNumber(char c) { return is(c, DIGIT | DOT | EXPONENT); }       // 判断是否可出现在数字中
+constexpr bool isBinaryOperator(char c) { return is(c, BINARY_OP); }            // 判断是否为二元运算符
+constexpr bool isFunction(char c) { return is(c, FUNCTION); }                   // 判断是否为函数
+constexpr bool isOperator(char c) { return is(c, BINARY_OP | FUNCTION); }       // 判断是否为运算符（含函数）
+constexpr bool isSpace(char c) { return is(c, SPACE); }                         // 判断是否为空白字符
+constexpr bool isOpenBracket(char c) { return is(c, OPEN_BRACKET); }            // 判断是否为左括号
+constexpr bool isCloseBracket(char c) { return is(c, CLOSE_BRACKET); }          // 判断是否为右括号
+constexpr bool isBracket(char c) { return is(c, OPEN_BRACKET | CLOSE_BRACKET); }  // 判断是否为括号
+constexpr int precedence(char op) { return PRECEDENCE[static_cast<unsigned char>(op)]; }  // 获取运算符优先级
+constexpr int leftBindingPower(char op) { return BINDING_POWER[static_cast<unsigned char>(op)].left; }    // 二元运算符的左结合力
+constexpr int rightBindingPower(char op) { return BINDING_POWER[static_cast<unsigned char>(op)].right; }  // 二元运算符的右结合力
+
+// 从 pos 开始跳过空白字符，返回第一个非空白字符的位置
+inline size_t skipSpaces(const string& s, size_t pos) {
+#if defined(__SSE2__)
+    const char* p = s.data();
+    while (pos + 16 <= s.size()) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + pos));
+        // 空白为 ' ' 或 '\t'..'\r'（0x09-0x0D）
+        __m128i space = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+        __m128i control = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(0x08)),
+                                        _mm_cmplt_epi8(block, _mm_set1_epi8(0x0E)));
+        unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(space, control))) & 0xFFFF;
+        if (mask != 0) return pos + __builtin_ctz(mask);
+        pos += 16;
+    }
+#endif
+    while (pos < s.size() && isSpace(s[pos])) pos++;
+    return pos;
+}
+
+// 从 pos 开始跳过数字字符 0-9，返回第一个非数字字符的位置
+inline size_t skipDigits(const string& s, size_t pos) {
+#if defined(__SSE2__)
+    const char* p = s.data();
+    while (pos + 16 <= s.size()) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + pos));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('0' - 1)),
+                                      _mm_cmplt_epi8(block, _mm_set1_epi8('9' + 1)));
+        unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(digit)) & 0xFFFF;
+        if (mask != 0) return pos + __builtin_ctz(mask);
+        pos += 16;
+    }
+#endif
+    while (pos < s.size() && isDigit(s[pos])) pos++;
+    return pos;
+}
+
+}  // namespace CharTable
+
+#endif // CHAR_TABLE_H    // 结束头文件保护
@@ -0,0 +1,254 @@
+#include "columnar_file.h"     // 包含列式文件头文件
+#include "batch_evaluator.h"   // 按列批量求值
+#include "error_type.h"        // 错误类型
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define COLUMNAR_MMAP 1
+#else
+#include <fstream>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr char MAGIC[8] = {'C', 'A', 'L', 'C', 'C', 'O', 'L', '1'};
+constexpr size_t HEADER_SIZE = 24;        // 魔数 + 行数 + 列数 + 保留
+constexpr size_t DESCRIPTOR_SIZE = 20;    // 每列描述的定长部分
+constexpr size_t ALIGNMENT = 64;          // 数据区对齐
+constexpr size_t CHUNK_ROWS = 64 * BatchEvaluator::TILE_ROWS;    // evaluateColumnarFile 每次求值的行数（8 的倍数，位图按字节对齐）
+
+[[noreturn]] void fail(const string& message) {
+    throw EvaluationError(IO_ERROR, message);
+}
+
+bool sameFile(const string& a, const string& b) {    // 两个路径是否指向同一个文件（含硬链接、符号链接）
+    if (a == b) return true;
+#ifdef COLUMNAR_MMAP
+    struct stat first, second;
+    return stat(a.c_str(), &first) == 0 && stat(b.c_str(), &second) == 0
+        && first.st_dev == second.st_dev && first.st_ino == second.st_ino;
+#else
+    return false;
+#endif
+}
+
+void requireLittleEndian() {    // 文件按小端存储，数据区直接当作 double / int64 使用
+    uint16_t probe = 1;
+    unsigned char first;
+    memcpy(&first, &probe, 1);
+    if (first != 1) fail("列式文件仅支持小端平台 (Columnar files require a little-endian platform)");
+}
+
+size_t alignUp(size_t offset) {
+    return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+size_t bitmapBytes(size_t rows) {
+    return (rows + 7) / 8;
+}
+
+template <typename T>
+T load(const char* p) {
+    T value;
+    memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void store(char* p, T value) {
+    memcpy(p, &value, sizeof(T));
+}
+
+}  // namespace
+
+ColumnarFile::ColumnarFile(const string& path) : file(path), rowCount(0) {
+    requireLittleEndian();
+    const char* base = file.data();
+    size_t length = file.size();
+    string corrupt = "列式文件已损坏 (Corrupt columnar file): " + path;
+    if (length < HEADER_SIZE || memcmp(base, MAGIC, sizeof(MAGIC)) != 0) fail("不是列式文件 (Not a columnar file): " + path);
+    uint64_t rows = load<uint64_t>(base + 8);
+    uint32_t count = load<uint32_t>(base + 16);
+    if (rows > length / 8) fail(corrupt);
+    rowCount = static_cast<size_t>(rows);
+    size_t pos = HEADER_SIZE;
+    for (uint32_t c = 0; c < count; c++) {
+        if (length - pos < DESCRIPTOR_SIZE) fail(corrupt);
+        uint16_t nameLength = load<uint16_t>(base + pos);
+        uint8_t type = load<uint8_t>(base + pos + 2);
+        uint64_t dataOffset = load<uint64_t>(base + pos + 4);
+        uint64_t validityOffset = load<uint64_t>(base + pos + 12);
+        pos += DESCRIPTOR_SIZE;
+        if (length - pos < nameLength || type > static_cast<uint8_t>(ColumnType::INT64)) fail(corrupt);
+        if (dataOffset % 8 != 0 || dataOffset > length || length - dataOffset < rowCount * 8) fail(corrupt);
+        if (validityOffset != 0 && (validityOffset > length || length - validityOffset < bitmapBytes(rowCount))) fail(corrupt);
+        Column column;
+        column.name.assign(base + pos, nameLength);
+        column.type = static_cast<ColumnType>(type);
+        column.data = base + dataOffset;
+        column.validity = validityOffset ? reinterpret_cast<const uint8_t*>(base + validityOffset) : nullptr;
+        columnList.push_back(move(column));
+        pos += nameLength;
+    }
+}
+
+const ColumnarFile::Column* ColumnarFile::find(const string& name) const {    // 按名字查找列
+    for (const Column& column : columnList) {
+        if (column.name == name) return &column;
+    }
+    return nullptr;
+}
+
+ColumnarWriter::ColumnarWriter(const string& path, const vector<ColumnSpec>& specs, size_t rows)
+    : path(path), base(nullptr), length(0), mapped(false), rowCount(rows), specs(specs) {
+    requireLittleEndian();
+    size_t header = HEADER_SIZE;
+    for (const ColumnSpec& spec : specs) {
+        if (spec.name.size() > UINT16_MAX) fail("列名过长 (Column name too long): " + spec.name.substr(0, 32));
+        header += DESCRIPTOR_SIZE + spec.name.size();
+    }
+    size_t pos = alignUp(header);
+    for (const ColumnSpec& spec : specs) {    // 数据和位图依次排列，各自 64 字节对齐
+        dataOffsets.push_back(pos);
+        pos = alignUp(pos + rows * 8);
+        validityOffsets.push_back(spec.nullable ? pos : 0);
+        if (spec.nullable) pos = alignUp(pos + bitmapBytes(rows));
+    }
+    length = pos;
+
+#ifdef COLUMNAR_MMAP
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) fail("无法创建文件 (Cannot create file): " + path);
+    if (ftruncate(fd, static_cast<off_t>(length)) != 0) {
+        ::close(fd);
+        fail("无法写入文件 (Cannot write file): " + path);
+    }
+    void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) fail("无法映射文件 (Cannot map file): " + path);
+    base = static_cast<char*>(p);
+    mapped = true;
+#else
+    buffer.assign(length, 0);
+    base = buffer.data();
+#endif
+
+    memcpy(base, MAGIC, sizeof(MAGIC));
+    store<uint64_t>(base + 8, rows);
+    store<uint32_t>(base + 16, static_cast<uint32_t>(specs.size()));
+    store<uint32_t>(base + 20, 0);
+    pos = HEADER_SIZE;
+    for (size_t c = 0; c < specs.size(); c++) {
+        store<uint16_t>(base + pos, static_cast<uint16_t>(specs[c].name.size()));
+        store<uint8_t>(base + pos + 2, static_cast<uint8_t>(specs[c].type));
+        store<uint8_t>(base + pos + 3, 0);
+        store<uint64_t>(base + pos + 4, dataOffsets[c]);
+        store<uint64_t>(base + pos + 12, validityOffsets[c]);
+        memcpy(base + pos + DESCRIPTOR_SIZE, specs[c].name.data(), specs[c].name.size());
+        pos += DESCRIPTOR_SIZE + specs[c].name.size();
+        if (validityOffsets[c]) {    // 初始全部有值，末字节超出行数的位保持 0
+            uint8_t* bits = reinterpret_cast<uint8_t*>(base + validityOffsets[c]);
+            memset(bits, 0xFF, rows / 8);
+            if (rows % 8) bits[rows / 8] = static_cast<uint8_t>((1u << (rows % 8)) - 1);
+        }
+    }
+}
+
+ColumnarWriter::~ColumnarWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+double* ColumnarWriter::doubleColumn(size_t column) {    // FLOAT64 列的数据区
+    if (column >= specs.size() || specs[column].type != ColumnType::FLOAT64 || !base) return nullptr;
+    return reinterpret_cast<double*>(base + dataOffsets[column]);
+}
+
+int64_t* ColumnarWriter::int64Column(size_t column) {    // INT64 列的数据区
+    if (column >= specs.size() || specs[column].type != ColumnType::INT64 || !base) return nullptr;
+    return reinterpret_cast<int64_t*>(base + dataOffsets[column]);
+}
+
+uint8_t* ColumnarWriter::validity(size_t column) {    // 有效位图
+    if (column >= specs.size() || !validityOffsets[column] || !base) return nullptr;
+    return reinterpret_cast<uint8_t*>(base + validityOffsets[column]);
+}
+
+void ColumnarWriter::close() {    // 写盘并解除映射
+    if (!base) return;
+#ifdef COLUMNAR_MMAP
+    if (mapped) munmap(base, length);
+    base = nullptr;
+#else
+    base = nullptr;
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out.write(buffer.data(), static_cast<streamsize>(buffer.size()))) fail("无法写入文件 (Cannot write file): " + path);
+    vector<char>().swap(buffer);
+#endif
+}
+
+namespace ExpressionUtils {
+
+/*按 CHUNK_ROWS 行分段交给 BatchEvaluator：double 列直接把映射的内存交给求值器，int64 列先转换到分段缓冲区；
+输入的有效位图原样传给求值器（分段从 8 的倍数行开始，位图按字节对齐），结果的有效位图由求值器直接写进输出文件。
+出错的行只使结果为空，不中止整批。*/
+size_t evaluateColumnarFile(const CompiledExpression& expr, const string& input, const string& output,
+                            const string& resultName, PrecisionMode mode, BatchStatus* status) {
+    // 输出文件创建时被截断，而输入仍映射着：同一个文件会在读取时触发 SIGBUS 并毁掉输入
+    if (sameFile(input, output)) fail("输出文件不能是输入文件 (Output must not be the input file): " + output);
+    ColumnarFile in(input);
+    size_t rows = in.rows();
+    const vector<string>& names = expr.getVariables();
+    vector<const ColumnarFile::Column*> bound;
+    for (const string& name : names) {
+        const ColumnarFile::Column* column = in.find(name);
+        if (!column) throw EvaluationError(INVALID_EXPRESSION, "输入文件中没有该列 (No such column in input): " + name);
+        bound.push_back(column);
+    }
+
+    ColumnarWriter out(output, {{resultName, ColumnType::FLOAT64, true}}, rows);
+    try {
+        BatchEvaluator batch(mode);
+        BatchStatus counts;
+        vector<vector<double>> converted(names.size());
+        vector<const double*> pointers(names.size());
+        vector<const uint8_t*> validity(names.size());
+        double* result = out.doubleColumn(0);
+        uint8_t* resultValidity = out.validity(0);
+        for (size_t base = 0; base < rows; base += CHUNK_ROWS) {
+            size_t count = min(CHUNK_ROWS, rows - base);
+            for (size_t v = 0; v < bound.size(); v++) {
+                const ColumnarFile::Column& column = *bound[v];
+                validity[v] = column.validity ? column.validity + base / 8 : nullptr;
+                if (column.type == ColumnType::FLOAT64) {
+                    pointers[v] = static_cast<const double*>(column.data) + base;
+                    continue;
+                }
+                converted[v].resize(CHUNK_ROWS);
+                double* values = converted[v].data();
+                const int64_t* source = static_cast<const int64_t*>(column.data) + base;
+                for (size_t i = 0; i < count; i++) values[i] = static_cast<double>(source[i]);
+                pointers[v] = values;
+            }
+            batch.evaluate(expr, pointers, validity, count, result + base, resultValidity + base / 8, counts);
+        }
+        out.close();
+        if (status) status->merge(counts);
+    } catch (...) {
+        out.close();
+        remove(output.c_str());
+        throw;
+    }
+    return rows;
+}
+
+}  // namespace ExpressionUtils
@@ -0,0 +1,89 @@
+#ifndef COLUMNAR_FILE_H    // 防止头文件重复包含
+#define COLUMNAR_FILE_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include "fast_math.h"              // 精度模式
+#include "batch_evaluator.h"        // 逐行求值状态
+#include "mapped_file.h"            // 只读映射
+#include <string>                   // 包含字符串处理
+#include <vector>                   // 包含向量容器
+#include <cstdint>                  // 定长整数类型
+using namespace std;                // 使用标准命名空间
+
+/*列式二进制文件：批处理时跳过文本解析，输入列映射（mmap）到内存后直接作为公式变量的取值，结果也直接写进映射的输出文件。
+布局（小端，偏移都相对文件开头）：
+  文件头   魔数 "CALCCOL1" | 行数 uint64 | 列数 uint32 | 保留 uint32
+  列描述   每列：名字长度 uint16 | 类型 uint8（0 double，1 int64）| 保留 uint8 | 数据偏移 uint64 | 有效位图偏移 uint64（0 表示没有）| 名字（UTF-8）
+  数据区   每列 rows 个 8 字节值，之后是可选的有效位图：(rows + 7) / 8 字节，第 i 行是第 i / 8 字节的第 i % 8 位
+           （低位在前，与 Arrow 相同），1 表示有值；每块数据都从 64 字节对齐的偏移开始。
+不支持 mmap 的平台上整个文件读入内存，写出时在 close 时一次写盘。格式或读写错误抛出 IO_ERROR 类型的 EvaluationError。*/
+
+enum class ColumnType : uint8_t { FLOAT64 = 0, INT64 = 1 };    // 列类型
+
+struct ColumnSpec {      // 要写出的列
+    string name;         // 列名
+    ColumnType type;     // 类型
+    bool nullable;       // 是否带有效位图
+};
+
+class ColumnarFile {    // 只读映射的列式文件
+public:
+    struct Column {              // 一列
+        string name;             // 列名
+        ColumnType type;         // 类型
+        const void* data;        // rows 个值（8 字节对齐）
+        const uint8_t* validity; // 有效位图，没有时为 nullptr（全部有值）
+    };
+
+    explicit ColumnarFile(const string& path);    // 映射并校验文件
+
+    size_t rows() const { return rowCount; }                          // 行数
+    const vector<Column>& columns() const { return columnList; }      // 所有列
+    const Column* find(const string& name) const;                     // 按名字查找列，没有时返回 nullptr
+
+    static bool isValid(const uint8_t* validity, size_t row) {        // 第 row 行是否有值
+        return !validity || ((validity[row >> 3] >> (row & 7)) & 1);
+    }
+
+private:
+    MappedFile file;            // 文件内容
+    size_t rowCount;            // 行数
+    vector<Column> columnList;  // 列
+};
+
+class ColumnarWriter {    // 按列描述建好文件后，各列直接写入映射的内存
+public:
+    ColumnarWriter(const string& path, const vector<ColumnSpec>& specs, size_t rows);    // 创建文件（已存在时覆盖）
+    ~ColumnarWriter();                                                                  // 未 close 时自动 close
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    double* doubleColumn(size_t column);     // FLOAT64 列的数据区
+    int64_t* int64Column(size_t column);     // INT64 列的数据区
+    uint8_t* validity(size_t column);        // 有效位图（初始全部有值），不可为空的列返回 nullptr
+    size_t rows() const { return rowCount; } // 行数
+    void close();                            // 写盘并解除映射
+
+private:
+    string path;                // 文件路径
+    char* base;                 // 文件内容
+    size_t length;              // 文件长度
+    bool mapped;                // base 是否来自 mmap
+    vector<char> buffer;        // 不支持 mmap 时的文件内容
+    size_t rowCount;            // 行数
+    vector<ColumnSpec> specs;   // 列描述
+    vector<uint64_t> dataOffsets;       // 各列数据偏移
+    vector<uint64_t> validityOffsets;   // 各列有效位图偏移（0 表示没有）
+};
+
+namespace ExpressionUtils {
+    // 对列式文件 input 的每一行求值 expr：变量按名字绑定到同名列（double 列直接使用映射的内存，int64 列按块转换），
+    // 结果写成列式文件 output 中可为空的 resultName 列；任一输入为空或求值出错的行结果为空，
+    // 空值和各类错误的行数累加到 status（可为 nullptr）。返回行数。文件读写失败时删除 output 并抛出 EvaluationError；
+    // output 与 input 是同一个文件（同一路径或同一 inode）时直接抛出，不改动任何文件。
+    size_t evaluateColumnarFile(const CompiledExpression& expr, const string& input, const string& output,
+                                const string& resultName = "result", PrecisionMode mode = PrecisionMode::EXACT,
+                                BatchStatus* status = nullptr);
+}
+
+#endif // COLUMNAR_FILE_H    // 结束头文件保护
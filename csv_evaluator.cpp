@@ -0,0 +1,306 @@
+#include "csv_evaluator.h"       // 包含 CSV 求值头文件
+#include "batch_evaluator.h"     // 按列批量求值
+#include "mapped_file.h"         // 只读映射
+#include "work_stealing_pool.h"  // 工作窃取线程池
+#include "error_type.h"          // 错误类型
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <vector>
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr double POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};    // 都能用 double 精确表示
+constexpr uint64_t MAX_EXACT_MANTISSA = uint64_t(1) << 53;    // 不超过它的整数能用 double 精确表示
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+bool parseWithStrtod(const char* begin, const char* end, double& value) {    // 快速路径以外的情况
+    size_t length = static_cast<size_t>(end - begin);
+    char small[64];
+    string large;
+    char* text = small;
+    if (length < sizeof(small)) {
+        memcpy(small, begin, length);
+        small[length] = '\0';
+    } else {
+        large.assign(begin, end);
+        text = &large[0];
+    }
+    char* stop;
+    value = strtod(text, &stop);
+    return stop == text + length;
+}
+
+const char* skipQuoted(const char* p, const char* end) {    // p 指向开头的引号，返回结尾引号之后的位置（"" 是转义的引号）
+    for (p++; p < end; p++) {
+        if (*p != '"') continue;
+        if (p + 1 < end && p[1] == '"') p++;
+        else return p + 1;
+    }
+    return end;
+}
+
+size_t formatNumber(double value, char* buffer) {    // 最短的可以原样读回的十进制形式，返回长度
+#if defined(__cpp_lib_to_chars)
+    return static_cast<size_t>(to_chars(buffer, buffer + 32, value).ptr - buffer);
+#else
+    return static_cast<size_t>(snprintf(buffer, 32, "%.17g", value));
+#endif
+}
+
+struct CsvJob {                          // 各块共用的只读信息
+    const CompiledExpression& expr;      // 公式
+    vector<int> slots;                   // 字段下标到变量下标，-1 表示不需要
+    size_t variableCount;                // 变量数
+    char delimiter;                      // 分隔符
+    PrecisionMode mode;                  // 精度模式
+};
+
+struct Chunk {                  // 一块输入及其输出
+    const char* begin;          // 本块第一行
+    const char* end;            // 最后一行的换行之后
+    string output;              // 格式化好的输出
+    size_t rows = 0;            // 数据行数
+    BatchStatus status;         // 空值和出错的行数
+    exception_ptr error;        // 处理时的异常
+    atomic<bool> done{false};   // 是否处理完
+};
+
+void processChunk(Chunk& chunk, const CsvJob& job) {    // 解析、求值并格式化一块
+    vector<vector<double>> columns(job.variableCount);
+    vector<vector<uint8_t>> validity(job.variableCount);    // 各变量的有效位图，字段是数字时置 1
+    vector<pair<const char*, const char*>> lines;    // 每行去掉换行后的范围
+    size_t fieldCount = job.slots.size();
+
+    for (const char* p = chunk.begin; p < chunk.end;) {
+        const char* newline = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(chunk.end - p)));
+        const char* lineEnd = newline ? newline : chunk.end;
+        const char* next = newline ? newline + 1 : chunk.end;
+        if (lineEnd > p && lineEnd[-1] == '\r') lineEnd--;
+        if (lineEnd == p) {
+            p = next;
+            continue;
+        }
+        size_t row = lines.size();
+        lines.push_back({p, lineEnd});
+        for (vector<double>& column : columns) column.push_back(NAN);
+        if (row % 8 == 0) {
+            for (vector<uint8_t>& bits : validity) bits.push_back(0);
+        }
+
+        const char* field = p;
+        for (size_t f = 0; f < fieldCount; f++) {    // 只走到最后一个需要的字段
+            const char* valueBegin = field;
+            const char* valueEnd;
+            const char* delimiter;
+            if (field < lineEnd && *field == '"') {
+                const char* after = skipQuoted(field, lineEnd);
+                valueBegin = field + 1;
+                valueEnd = after > valueBegin && after[-1] == '"' ? after - 1 : after;
+                delimiter = static_cast<const char*>(memchr(after, job.delimiter, static_cast<size_t>(lineEnd - after)));
+            } else {
+                delimiter = static_cast<const char*>(memchr(field, job.delimiter, static_cast<size_t>(lineEnd - field)));
+                valueEnd = delimiter ? delimiter : lineEnd;
+            }
+            int slot = job.slots[f];
+            if (slot >= 0) {
+                double value;
+                if (ExpressionUtils::parseCsvNumber(valueBegin, valueEnd, value)) {
+                    columns[slot][row] = value;
+                    validity[slot][row >> 3] |= static_cast<uint8_t>(1 << (row & 7));
+                }
+            }
+            if (!delimiter) break;
+            field = delimiter + 1;
+        }
+        p = next;
+    }
+
+    size_t rows = lines.size();
+    chunk.rows = rows;
+    if (rows == 0) return;
+    vector<const double*> pointers;
+    for (const vector<double>& column : columns) pointers.push_back(column.data());
+    vector<const uint8_t*> bits;
+    for (const vector<uint8_t>& column : validity) bits.push_back(column.data());
+    vector<double> results(rows);
+    vector<uint8_t> resultValidity((rows + 7) / 8);
+    BatchEvaluator batch(job.mode);
+    batch.evaluate(job.expr, pointers, bits, rows, results.data(), resultValidity.data(), chunk.status);
+
+    string& output = chunk.output;
+    output.reserve(static_cast<size_t>(chunk.end - chunk.begin) + rows * 26);
+    char number[32];
+    for (size_t r = 0; r < rows; r++) {
+        output.append(lines[r].first, lines[r].second);
+        output.push_back(job.delimiter);
+        if ((resultValidity[r >> 3] >> (r & 7)) & 1) output.append(number, formatNumber(results[r], number));    // 空值和出错的行留空
+        output.push_back('\n');
+    }
+}
+
+string headerName(const char* begin, const char* end) {    // 去掉空白和引号后的列名
+    while (begin < end && isBlank(*begin)) begin++;
+    while (end > begin && isBlank(end[-1])) end--;
+    if (end - begin >= 2 && *begin == '"' && end[-1] == '"') {
+        begin++;
+        end--;
+    }
+    return string(begin, end);
+}
+
+}  // namespace
+
+namespace ExpressionUtils {
+
+/*快速路径：有效数字（去掉前导零）不超过 19 位时整数部分 m 精确累加，若 m ≤ 2^53 且十进制指数 |e| ≤ 22，
+m 和 10^|e| 都能用 double 精确表示，一次乘或除即为正确舍入的结果（Clinger 算法）。*/
+bool parseCsvNumber(const char* begin, const char* end, double& value) {
+    while (begin < end && isBlank(*begin)) begin++;
+    while (end > begin && isBlank(end[-1])) end--;
+    if (begin == end) return false;
+
+    const char* p = begin;
+    bool negative = (*p == '-');
+    if (*p == '-' || *p == '+') p++;
+    const char* digitsBegin = p;
+    while (p < end && *p == '0') p++;    // 前导零不算有效数字
+    uint64_t mantissa = 0;
+    unsigned digit;
+    const char* significant = p;
+    for (; p < end && (digit = static_cast<unsigned>(*p - '0')) <= 9; p++) mantissa = mantissa * 10 + digit;
+    int digits = static_cast<int>(p - significant);    // 有效数字位数
+    int exponent = 0;                                  // 十进制指数
+    bool anyDigit = (p != digitsBegin);
+    if (p < end && *p == '.') {
+        const char* fraction = ++p;
+        if (digits == 0) {
+            while (p < end && *p == '0') p++;
+        }
+        significant = p;
+        for (; p < end && (digit = static_cast<unsigned>(*p - '0')) <= 9; p++) mantissa = mantissa * 10 + digit;
+        digits += static_cast<int>(p - significant);
+        exponent = -static_cast<int>(p - fraction);
+        anyDigit |= (p != fraction);
+    }
+    if (anyDigit && p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool negativeExponent = (q < end && *q == '-');
+        if (q < end && (*q == '-' || *q == '+')) q++;
+        if (q < end && isDigit(*q)) {
+            int e = 0;
+            for (; q < end && isDigit(*q); q++) {
+                if (e < 10000) e = e * 10 + (*q - '0');
+            }
+            exponent += negativeExponent ? -e : e;
+            p = q;
+        }
+    }
+    if (!anyDigit || p != end || digits > 19 || mantissa > MAX_EXACT_MANTISSA || exponent < -22 || exponent > 22) {
+        return parseWithStrtod(begin, end, value);
+    }
+    double result = static_cast<double>(mantissa);
+    result = exponent < 0 ? result / POW10[-exponent] : result * POW10[exponent];
+    value = negative ? -result : result;
+    return true;
+}
+
+size_t evaluateCsvFile(const CompiledExpression& expr, const string& input, ostream& out, const CsvOptions& options, BatchStatus* status) {
+    MappedFile file(input);
+    const char* data = file.data();
+    const char* end = data + file.size();
+    if (file.size() == 0) throw EvaluationError(IO_ERROR, "CSV 文件没有表头 (CSV file has no header): " + input);
+
+    const char* newline = static_cast<const char*>(memchr(data, '\n', file.size()));
+    const char* headerEnd = newline ? newline : end;
+    const char* body = newline ? newline + 1 : end;
+    if (headerEnd > data && headerEnd[-1] == '\r') headerEnd--;
+    vector<string> header;
+    const char* field = data;
+    if (headerEnd - field >= 3 && memcmp(field, "\xEF\xBB\xBF", 3) == 0) field += 3;    // UTF-8 BOM
+    while (true) {
+        const char* fieldEnd = field < headerEnd && *field == '"' ? skipQuoted(field, headerEnd) : field;
+        const char* delimiter = find(fieldEnd, headerEnd, options.delimiter);
+        header.push_back(headerName(field, delimiter));
+        if (delimiter == headerEnd) break;
+        field = delimiter + 1;
+    }
+
+    const vector<string>& names = expr.getVariables();
+    CsvJob job = {expr, {}, names.size(), options.delimiter, options.mode};
+    for (size_t v = 0; v < names.size(); v++) {
+        size_t column = find(header.begin(), header.end(), names[v]) - header.begin();
+        if (column == header.size()) throw EvaluationError(INVALID_EXPRESSION, "CSV 中没有该列 (No such column in CSV): " + names[v]);
+        if (job.slots.size() <= column) job.slots.resize(column + 1, -1);
+        job.slots[column] = static_cast<int>(v);
+    }
+
+    out.write(data, headerEnd - data);
+    out << options.delimiter << options.resultName << '\n';
+
+    WorkStealingPool pool(options.threads);
+    size_t window = 2 * (pool.size() + 1);    // 同时在途的块数（主线程等待时也帮忙处理）
+    size_t chunkBytes = max<size_t>(options.chunkBytes, 1);
+    deque<unique_ptr<Chunk>> inFlight;
+    const char* next = body;
+    size_t rows = 0;
+    exception_ptr error;
+    while (true) {
+        while (!error && next < end && inFlight.size() < window) {    // 在下一个换行处切出新块
+            const char* cut = end;
+            if (static_cast<size_t>(end - next) > chunkBytes) {
+                const char* found = static_cast<const char*>(memchr(next + chunkBytes, '\n', static_cast<size_t>(end - next) - chunkBytes));
+                cut = found ? found + 1 : end;
+            }
+            inFlight.push_back(make_unique<Chunk>());
+            Chunk* chunk = inFlight.back().get();
+            chunk->begin = next;
+            chunk->end = cut;
+            pool.submit([chunk, &job] {
+                try {
+                    processChunk(*chunk, job);
+                } catch (...) {
+                    chunk->error = current_exception();
+                }
+                chunk->done.store(true, memory_order_release);
+            });
+            next = cut;
+        }
+        if (inFlight.empty()) break;
+
+        Chunk& front = *inFlight.front();    // 按原顺序写出
+        pool.helpUntil([&front] { return front.done.load(memory_order_acquire); });
+        if (front.error && !error) error = front.error;
+        if (!error) {
+            out.write(front.output.data(), static_cast<streamsize>(front.output.size()));
+            rows += front.rows;
+            if (status) status->merge(front.status);
+        }
+        inFlight.pop_front();
+    }
+    if (error) rethrow_exception(error);
+    if (!out) throw EvaluationError(IO_ERROR, "无法写出结果 (Cannot write output)");
+    return rows;
+}
+
+}  // namespace ExpressionUtils
@@ -0,0 +1,38 @@
+#ifndef CSV_EVALUATOR_H    // 防止头文件重复包含
+#define CSV_EVALUATOR_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include "fast_math.h"              // 精度模式
+#include "batch_evaluator.h"        // 逐行求值状态
+#include <string>                   // 包含字符串处理
+#include <ostream>                  // 输出流
+using namespace std;                // 使用标准命名空间
+
+/*CSV 文件批量求值：表头的列名绑定到公式中的同名变量，文件映射（mmap）到内存后在换行处切成大块，
+各块交给线程池并行解析、按列求值（BatchEvaluator）并格式化，主线程按原顺序把各块结果写到输出流，
+同时在途的块数有上限，内存占用与文件大小无关。
+每行输出原样保留（去掉行尾 \r），末尾追加分隔符和结果；表头追加结果列名，空行跳过。
+只解析公式用到的列，其余字段原样跳过。数字用快速路径解析（不超过 19 位有效数字、十进制指数不超过 22 时
+一次乘除得到正确舍入的结果），其余情况（更长的数字、inf、nan 等）交给 strtod，结果相同。
+字段可以用双引号包围（其中可以有分隔符，不能有换行）；空字段或不是数字的字段为空值。
+任一输入为空或求值出错（除零等）的行结果字段留空，不中止整批，空值和各类错误的行数按 BatchStatus 汇总。*/
+
+struct CsvOptions {                          // CSV 求值选项
+    char delimiter = ',';                    // 字段分隔符
+    size_t threads = 0;                      // 工作线程数，0 表示硬件线程数
+    size_t chunkBytes = 4 << 20;             // 每块大约的字节数（在下一个换行处切开）
+    string resultName = "result";            // 结果列名
+    PrecisionMode mode = PrecisionMode::EXACT;    // 精度模式
+};
+
+namespace ExpressionUtils {
+    // 对 CSV 文件 input 的每一行求值 expr，变量按名字绑定到表头中的同名列（没有该列时抛出 EvaluationError），
+    // 带结果列的 CSV 写到 out，空值和出错的行数累加到 status（可为 nullptr）。返回数据行数。
+    size_t evaluateCsvFile(const CompiledExpression& expr, const string& input, ostream& out,
+                           const CsvOptions& options = CsvOptions(), BatchStatus* status = nullptr);
+
+    // 解析 [begin, end) 中的十进制浮点数（允许首尾空白），整个字段都是数字时返回 true
+    bool parseCsvNumber(const char* begin, const char* end, double& value);
+}
+
+#endif // CSV_EVALUATOR_H    // 结束头文件保护
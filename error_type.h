@@ -0,0 +1,36 @@
+#ifndef ERROR_TYPE_H    // 防止头文件重复包含
+#define ERROR_TYPE_H    // 定义头文件宏
+
+#include <stdexcept>  // 标准异常
+#include <string>     // 字符串处理
+using namespace std;  // 使用标准命名空间
+
+// 错误类型枚举
+enum ErrorType {
+    NO_ERROR,                // 无错误
+    MISMATCHED_PARENTHESES, // 括号不匹配
+    INVALID_CHARACTER,      // 非法字符
+    CONSECUTIVE_OPERATORS,  // 连续运算符
+    DIVISION_BY_ZERO,      // 除零错误
+    INVALID_EXPRESSION,    // 非法表达式
+    EMPTY_EXPRESSION,      // 空表达式
+    INVALID_NEGATIVE_NUMBER, // 无效的负数格式
+    INSUFFICIENT_OPERANDS,   // 操作数不足
+    FUNCTION_ARGUMENT_ERROR, // 函数参数错误
+    MISSING_OPERATOR,       // 缺少运算符
+    LIMIT_EXCEEDED,         // 超出长度或嵌套深度限制
+    CANCELLED,              // 异步请求在求值前被取消
+    IO_ERROR                // 文件读写失败或文件格式错误
+};
+
+// 带错误类型的求值异常，仍可按 runtime_error 捕获
+class EvaluationError : public runtime_error {
+private:
+    ErrorType type;    // 错误类型
+
+public:
+    EvaluationError(ErrorType errorType, const string& message) : runtime_error(message), type(errorType) {}
+    ErrorType getType() const { return type; }    // 获取错误类型
+};
+
+#endif // ERROR_TYPE_H    // 结束头文件保护
@@ -0,0 +1,181 @@
+#include "evaluation_service.h"    // 包含异步求值服务头文件
+#include "metrics.h"               // 运行指标
+#include <chrono>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+
+using CompileCache = unordered_map<string, CompiledExpression>;    // 键为类型字符加表达式
+
+EvaluationResult evaluateRequest(const string& expression, ExpressionType type,
+                                 const ServiceOptions& options, CompileCache& cache) {    // 求值单个请求
+    EvaluationResult result;
+    try {
+        string key;
+        const CompiledExpression* compiled = nullptr;
+        CompiledExpression uncached;
+        if (options.cacheCapacity > 0) {
+            key.reserve(expression.size() + 1);
+            key += static_cast<char>('0' + static_cast<int>(type));
+            key += expression;
+            auto it = cache.find(key);
+            if (it != cache.end()) compiled = &it->second;
+            if (options.collectMetrics) Metrics::recordCache(compiled != nullptr);
+        }
+        if (!compiled) {
+            HardenedEvaluator::checkLimits(expression, options.limits);
+            uncached = ExpressionCompiler::compile(expression, type, options.limits.maxDepth);
+            if (options.cacheCapacity > 0) {
+                if (cache.size() >= options.cacheCapacity) cache.clear();    // 满了整体清空，保持开销恒定
+                compiled = &cache.emplace(move(key), move(uncached)).first->second;
+            } else {
+                compiled = &uncached;
+            }
+        }
+        if (!compiled->getVariables().empty()) {
+            throw EvaluationError(INVALID_EXPRESSION, "表达式包含未赋值的变量 (Expression contains unbound variables): " + compiled->getVariables()[0]);
+        }
+        result.value = options.profiler ? options.profiler->evaluate(expression, *compiled) : compiled->evaluate();
+    } catch (const EvaluationError& e) {
+        result.error = e.getType();
+        result.message = e.what();
+    } catch (const exception& e) {
+        result.error = INVALID_EXPRESSION;
+        result.message = e.what();
+    }
+    return result;
+}
+
+}  // namespace
+
+EvaluationService::EvaluationService(const ServiceOptions& options) : options(options), stopping(false) {
+    startWorkers();
+}
+
+EvaluationService::~EvaluationService() {
+    lock_guard<mutex> guard(reconfigureLock);
+    stopWorkers();
+}
+
+void EvaluationService::startWorkers() {    // 按 options 启动工作线程
+    if (options.queueCapacity == 0) options.queueCapacity = 1;
+    if (options.batchSize == 0) options.batchSize = 1;
+    size_t threads = options.threads ? options.threads : thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    stopping = false;
+    for (size_t i = 0; i < threads; i++) workers.emplace_back([this] { workerLoop(); });
+}
+
+void EvaluationService::stopWorkers() {    // 工作线程在队列清空后才退出
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    notEmpty.notify_all();
+    for (thread& worker : workers) worker.join();
+    workers.clear();
+}
+
+void EvaluationService::reconfigure(const ServiceOptions& newOptions) {    // 原地换用新选项
+    lock_guard<mutex> guard(reconfigureLock);
+    stopWorkers();
+    {
+        lock_guard<mutex> queueGuard(lock);    // enqueue / pending / saturated 在锁内读取 options
+        options = newOptions;
+        startWorkers();
+    }
+    notEmpty.notify_all();    // 停止期间入队的请求由新的工作线程处理
+    notFull.notify_all();     // 队列容量可能变大，唤醒阻塞的提交者按新容量重新检查
+}
+
+bool EvaluationService::enqueue(Request&& request, bool wait) {    // 入队
+    request.enqueued = chrono::steady_clock::now();    // 延迟从提交时算起，包括排队和阻塞等待（在锁外读取，不看 options）
+    {
+        unique_lock<mutex> guard(lock);
+        if (wait) {
+            notFull.wait(guard, [this] { return queue.size() < options.queueCapacity; });
+        } else if (queue.size() >= options.queueCapacity) {
+            return false;
+        }
+        queue.push_back(move(request));
+    }
+    notEmpty.notify_one();
+    return true;
+}
+
+future<EvaluationResult> EvaluationService::submit(const string& expression, ExpressionType type, const CancellationToken& token) {
+    Request request{expression, type, token, nullptr, promise<EvaluationResult>()};
+    future<EvaluationResult> result = request.result.get_future();
+    enqueue(move(request), true);
+    return result;
+}
+
+void EvaluationService::submit(const string& expression, ExpressionType type, Callback callback, const CancellationToken& token) {
+    enqueue(Request{expression, type, token, move(callback), promise<EvaluationResult>()}, true);
+}
+
+bool EvaluationService::trySubmit(const string& expression, ExpressionType type, future<EvaluationResult>& result, const CancellationToken& token) {
+    Request request{expression, type, token, nullptr, promise<EvaluationResult>()};
+    future<EvaluationResult> pendingResult = request.result.get_future();
+    if (!enqueue(move(request), false)) return false;
+    result = move(pendingResult);
+    return true;
+}
+
+bool EvaluationService::trySubmit(const string& expression, ExpressionType type, Callback callback, const CancellationToken& token) {
+    return enqueue(Request{expression, type, token, move(callback), promise<EvaluationResult>()}, false);
+}
+
+size_t EvaluationService::pending() const {    // 队列中等待的请求数
+    lock_guard<mutex> guard(lock);
+    return queue.size();
+}
+
+bool EvaluationService::saturated() const {    // 队列是否已满
+    lock_guard<mutex> guard(lock);
+    return queue.size() >= options.queueCapacity;
+}
+
+void EvaluationService::workerLoop() {    // 工作线程主循环：成批取出请求
+    CompileCache cache;
+    vector<Request> batch;
+    batch.reserve(options.batchSize);
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            notEmpty.wait(guard, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;    // 已停止且队列已清空
+            while (!queue.empty() && batch.size() < options.batchSize) {
+                batch.push_back(move(queue.front()));
+                queue.pop_front();
+            }
+        }
+        notFull.notify_all();
+
+        for (Request& request : batch) {
+            EvaluationResult result;
+            if (request.token.isCancelled()) {
+                result.error = CANCELLED;
+                result.message = "请求已取消 (Request cancelled)";
+            } else {
+                result = evaluateRequest(request.expression, request.type, options, cache);
+            }
+            if (options.collectMetrics) {    // 结果就绪即记录：覆盖排队与求值，不含回调本身的运行时间
+                auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - request.enqueued);
+                Metrics::recordRequest(request.type, result.error, static_cast<uint64_t>(elapsed.count()));
+            }
+            if (request.callback) {
+                try {
+                    request.callback(result);
+                } catch (...) {
+                    // 回调的异常无处报告，忽略以免终止工作线程
+                }
+            } else {
+                request.result.set_value(move(result));
+            }
+        }
+        batch.clear();
+    }
+}
@@ -0,0 +1,143 @@
+#ifndef EVALUATION_SERVICE_H    // 防止头文件重复包含
+#define EVALUATION_SERVICE_H    // 定义头文件宏
+
+#include "expression_type.h"       // 表达式类型
+#include "expression_compiler.h"   // 编译后的表达式
+#include "hardened_evaluator.h"    // 长度与嵌套深度限制
+#include "error_type.h"            // 错误类型
+#include "operator_profiler.h"     // 按运算符统计开销
+#include <string>                  // 包含字符串处理
+#include <vector>                  // 包含向量容器
+#include <deque>                   // 请求队列
+#include <future>                  // future / promise
+#include <functional>              // 回调
+#include <memory>                  // shared_ptr
+#include <atomic>                  // 取消标志
+#include <mutex>                   // 互斥锁
+#include <condition_variable>      // 队列空 / 满时等待
+#include <thread>                  // 工作线程
+#include <chrono>                  // 入队时间
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>               // C++20 协程
+#define EVALUATION_SERVICE_COROUTINE 1
+#endif
+using namespace std;               // 使用标准命名空间
+
+/*异步求值服务：有界请求队列加固定数量的工作线程。
+队列满时 submit 阻塞调用者，trySubmit 立即返回 false，pending / saturated 可供调用者提前减速（背压）。
+工作线程每次加锁取出最多 batchSize 个请求一起处理，锁和唤醒的开销由整批请求分摊；
+每个工作线程有自己的编译缓存，重复的表达式直接复用编译结果，不再重新解析，也没有求值器的栈和错误状态需要重置。
+求值走编译路径，不输出求值步骤。*/
+
+struct EvaluationResult {         // 异步求值结果
+    double value = 0.0;           // 结果值（出错时为 0）
+    ErrorType error = NO_ERROR;   // 错误类型
+    string message;               // 错误信息
+
+    bool ok() const { return error == NO_ERROR; }    // 是否成功
+};
+
+class CancellationToken {    // 取消标记，可在多个线程间复制共享
+private:
+    shared_ptr<atomic<bool>> flag;    // 为空表示不可取消
+
+    explicit CancellationToken(nullptr_t) {}
+
+public:
+    CancellationToken() : flag(make_shared<atomic<bool>>(false)) {}
+
+    static CancellationToken none() { return CancellationToken(nullptr); }    // 不可取消的标记（不分配内存）
+    void cancel() const { if (flag) flag->store(true, memory_order_relaxed); }  // 取消，尚未开始求值的请求将以 CANCELLED 结束
+    bool isCancelled() const { return flag && flag->load(memory_order_relaxed); }
+};
+
+struct ServiceOptions {            // 异步求值服务选项
+    size_t threads = 0;            // 工作线程数，0 表示硬件线程数
+    size_t queueCapacity = 1024;   // 队列中最多等待的请求数
+    size_t batchSize = 32;         // 工作线程每次最多取出的请求数
+    size_t cacheCapacity = 256;    // 每个工作线程缓存的编译结果数，0 表示不缓存
+    EvaluationLimits limits;       // 长度与嵌套深度限制
+    bool collectMetrics = true;    // 是否记录运行指标（见 metrics.h）
+    OperatorProfiler* profiler = nullptr;    // 非空时按采样记录每种运算的开销（由调用者持有）
+};
+
+class EvaluationService {    // 异步求值服务
+public:
+    using Callback = function<void(const EvaluationResult&)>;    // 回调（在工作线程中调用，不应抛出异常）
+
+    explicit EvaluationService(const ServiceOptions& options = ServiceOptions());
+    ~EvaluationService();    // 处理完已入队的请求后停止
+
+    EvaluationService(const EvaluationService&) = delete;
+    EvaluationService& operator=(const EvaluationService&) = delete;
+
+    // 提交请求；队列满时阻塞直到有空位
+    future<EvaluationResult> submit(const string& expression, ExpressionType type,
+                                    const CancellationToken& token = CancellationToken::none());
+    void submit(const string& expression, ExpressionType type, Callback callback,
+                const CancellationToken& token = CancellationToken::none());
+
+    // 尝试提交；队列满时不阻塞，直接返回 false
+    bool trySubmit(const string& expression, ExpressionType type, future<EvaluationResult>& result,
+                   const CancellationToken& token = CancellationToken::none());
+    bool trySubmit(const string& expression, ExpressionType type, Callback callback,
+                   const CancellationToken& token = CancellationToken::none());
+
+    size_t pending() const;      // 队列中等待的请求数
+    bool saturated() const;      // 队列是否已满
+    const ServiceOptions& getOptions() const { return options; }    // 获取选项（不要与 reconfigure 并发调用）
+
+    // 原地换用新选项：等待现有工作线程处理完已入队的请求后按新选项重启，服务对象本身不变，
+    // 调用者持有的引用仍然有效；期间提交的请求不会丢失。不能在回调（工作线程）中调用
+    void reconfigure(const ServiceOptions& newOptions);
+
+#ifdef EVALUATION_SERVICE_COROUTINE
+    struct Awaiter {    // co_await 求值结果；协程在工作线程中恢复
+        EvaluationService& service;
+        string expression;
+        ExpressionType type;
+        CancellationToken token;
+        EvaluationResult result;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(coroutine_handle<> handle) {
+            service.submit(expression, type, [this, handle](const EvaluationResult& r) {
+                result = r;
+                handle.resume();
+            }, token);
+        }
+        EvaluationResult await_resume() { return move(result); }
+    };
+
+    Awaiter evaluateAsync(const string& expression, ExpressionType type,
+                          const CancellationToken& token = CancellationToken::none()) {
+        return Awaiter{*this, expression, type, token, EvaluationResult()};
+    }
+#endif
+
+private:
+    struct Request {                       // 单个请求
+        string expression;
+        ExpressionType type;
+        CancellationToken token;
+        Callback callback;                 // 回调版本使用
+        promise<EvaluationResult> result;  // future 版本使用
+        chrono::steady_clock::time_point enqueued{};  // 提交时间（计算延迟用，由 enqueue 记录）
+    };
+
+    ServiceOptions options;                // 选项
+    mutable mutex lock;                    // 保护队列
+    condition_variable notEmpty;           // 有请求时唤醒工作线程
+    condition_variable notFull;            // 有空位时唤醒阻塞的提交者
+    deque<Request> queue;                  // 有界请求队列
+    bool stopping;                         // 是否正在停止（受 lock 保护）
+    vector<thread> workers;                // 工作线程
+    mutex reconfigureLock;                 // 串行化 reconfigure 与析构
+
+    bool enqueue(Request&& request, bool wait);    // 入队；wait 为 false 且队列满时返回 false
+    void startWorkers();                           // 按 options 启动工作线程
+    void stopWorkers();                            // 处理完已入队的请求后停止工作线程
+    void workerLoop();                             // 工作线程主循环
+};
+
+#endif // EVALUATION_SERVICE_H    // 结束头文件保护
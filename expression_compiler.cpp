@@ -0,0 +1,545 @@
+#include "expression_compiler.h"    // 包含表达式编译器头文件
+#include "error_type.h"             // 错误类型
+#include "char_table.h"             // 共享的字符分类与优先级表
+#include <cmath>
+#include <cctype>
+#include <climits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+constexpr double EXACT_INTEGER_LIMIT = 9007199254740992.0;    // 2^53，绝对值不超过它的整数 double 都能精确表示
+constexpr int64_t EXACT_INTEGER_MAX = int64_t(1) << 53;         // 整数快速路径允许的中间结果绝对值上限
+
+bool toExactInteger(double value, int64_t& result) {    // double 恰为整数且可精确表示时转换为 int64
+    if (!(fabs(value) <= EXACT_INTEGER_LIMIT)) return false;    // 含 NaN、无穷
+    result = static_cast<int64_t>(value);
+    return static_cast<double>(result) == value;
+}
+
+}  // namespace
+
+CompiledExpression::CompiledExpression() : depth(0), maxStackDepth(0), integral(true) {}
+
+void CompiledExpression::emitConstant(double value, const string& literal) {    // 追加压入常数指令
+    constants.push_back(value);
+    literals.push_back(literal);
+    int64_t unused;
+    if (!toExactInteger(value, unused) || (value == 0 && signbit(value))) integral = false;    // 改写后的常数可能是 -0
+    code.push_back({OpCode::PUSH_CONST, 0, static_cast<int>(constants.size() - 1)});
+    depth++;
+    if (depth > maxStackDepth) maxStackDepth = depth;
+}
+
+void CompiledExpression::emitVariable(const string& name) {    // 追加压入变量指令
+    int index = variableIndex(name);
+    if (index < 0) {    // 新变量
+        variables.push_back(name);
+        index = static_cast<int>(variables.size() - 1);
+    }
+    code.push_back({OpCode::LOAD_VAR, 0, index});
+    depth++;
+    if (depth > maxStackDepth) maxStackDepth = depth;
+}
+
+void CompiledExpression::declareVariable(const string& name) {    // 登记变量
+    if (variableIndex(name) < 0) variables.push_back(name);
+}
+
+void CompiledExpression::emitBinary(char op) {    // 追加二元运算指令
+    if (depth < 2) throw EvaluationError(INSUFFICIENT_OPERANDS, "表达式有误，操作数不足 (Insufficient operands)");
+    code.push_back({OpCode::BINARY, op, 0});
+    depth--;
+}
+
+void CompiledExpression::emitUnary(char op) {    // 追加一元运算指令
+    if (depth < 1) throw EvaluationError(FUNCTION_ARGUMENT_ERROR, "函数参数缺失 (Missing function argument)");
+    code.push_back({OpCode::UNARY, op, 0});
+    if (op != '-') integral = false;    // 函数结果一般不是整数
+}
+
+int CompiledExpression::variableIndex(const string& name) const {    // 查找变量下标
+    for (size_t i = 0; i < variables.size(); i++) {
+        if (variables[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+double CompiledExpression::evaluateOperation(double a, double b, char op) {    // 执行二元运算
+    switch (op) {
+        case '+': return a + b;
+        case '-': return a - b;
+        case '*': return a * b;
+        case '/':
+            if (b == 0) throw EvaluationError(DIVISION_BY_ZERO, "除数不能为零 (Division by zero)");
+            return a / b;
+        case '%':
+            if (b == 0) throw EvaluationError(DIVISION_BY_ZERO, "除数不能为零 (Division by zero)");
+            return fmod(a, b);
+        case '^': return pow(a, b);
+        case '&': return toBitwiseOperand(a) & toBitwiseOperand(b);
+        case '|': return toBitwiseOperand(a) | toBitwiseOperand(b);
+        default: throw EvaluationError(INVALID_CHARACTER, "未知运算符 (Unknown operator)");
+    }
+}
+
+int CompiledExpression::toBitwiseOperand(double value) {    // 位运算操作数转 int，越界（含 NaN）时报错而不是未定义行为
+    if (!(value > INT_MIN - 1.0 && value < INT_MAX + 1.0)) {
+        throw EvaluationError(INVALID_EXPRESSION, "位运算操作数超出范围 (Bitwise operand out of range)");
+    }
+    return static_cast<int>(value);
+}
+
+bool CompiledExpression::checkedPower(int64_t base, int64_t exp, int64_t& result) {    // 快速幂
+    result = 1;
+    while (exp > 0) {
+        if ((exp & 1) && __builtin_mul_overflow(result, base, &result)) return false;
+        exp >>= 1;
+        if (exp > 0 && __builtin_mul_overflow(base, base, &base)) return false;
+    }
+    return true;
+}
+
+double CompiledExpression::evaluateUnary(char op, double b) {    // 执行一元运算
+    switch (op) {
+        case '-': return -b;
+        case 's': return sin(b);
+        case 'c': return cos(b);
+        case 't': return tan(b);
+        case 'l':
+            if (b <= 0) throw EvaluationError(FUNCTION_ARGUMENT_ERROR, "对数函数的参数必须大于零 (Logarithm argument must be positive)");
+            return log(b);
+        default: throw EvaluationError(INVALID_CHARACTER, "未知运算符 (Unknown operator)");
+    }
+}
+
+double CompiledExpression::evaluate(const vector<double>& values) const {    // 按变量取值求值
+    if (!isComplete()) throw EvaluationError(INVALID_EXPRESSION, "表达式不完整 (Incomplete expression)");
+    if (values.size() < variables.size()) throw EvaluationError(INVALID_EXPRESSION, "变量取值不足 (Missing variable values)");
+    if (integral) {
+        double result;
+        if (evaluateInteger(values, result)) return result;
+    }
+
+    vector<double> stack(maxStackDepth);    // 预先分配的求值栈
+    size_t top = 0;
+    for (const Instruction& ins : code) {
+        switch (ins.code) {
+            case OpCode::PUSH_CONST: stack[top++] = constants[ins.index]; break;
+            case OpCode::LOAD_VAR:   stack[top++] = values[ins.index]; break;
+            case OpCode::BINARY:
+                top--;
+                stack[top - 1] = evaluateOperation(stack[top - 1], stack[top], ins.op);
+                break;
+            case OpCode::UNARY:
+                stack[top - 1] = evaluateUnary(ins.op, stack[top - 1]);
+                break;
+        }
+    }
+    return stack[0];
+}
+
+bool CompiledExpression::evaluateInteger(const vector<double>& values, double& result) const {    // 整数快速路径
+    vector<int64_t> stack(maxStackDepth);
+    size_t top = 0;
+    for (const Instruction& ins : code) {
+        switch (ins.code) {
+            case OpCode::PUSH_CONST:
+                stack[top++] = static_cast<int64_t>(constants[ins.index]);    // 编译时已确认是整数
+                break;
+            case OpCode::LOAD_VAR:
+                if (!toExactInteger(values[ins.index], stack[top]) || (stack[top] == 0 && signbit(values[ins.index]))) return false;    // -0 交给 double 路径
+                top++;
+                break;
+            case OpCode::BINARY: {
+                top--;
+                int64_t a = stack[top - 1], b = stack[top];
+                int64_t& r = stack[top - 1];
+                switch (ins.op) {
+                    case '+': if (__builtin_add_overflow(a, b, &r)) return false; break;
+                    case '-': if (__builtin_sub_overflow(a, b, &r)) return false; break;
+                    case '*': if (__builtin_mul_overflow(a, b, &r)) return false; break;
+                    case '/':    // 除零由 double 路径报错，除不尽时结果不是整数
+                        if (b == 0 || (a == INT64_MIN && b == -1) || a % b != 0) return false;
+                        r = a / b;
+                        break;
+                    case '%':    // 与 fmod 一致：结果与被除数同号
+                        if (b == 0) return false;
+                        r = (b == -1) ? 0 : a % b;
+                        break;
+                    case '^':
+                        if (b < 0 || !checkedPower(a, b, r)) return false;
+                        break;
+                    case '&':
+                    case '|':    // 超出 int 范围时由 double 路径报错
+                        if (a < INT_MIN || a > INT_MAX || b < INT_MIN || b > INT_MAX) return false;
+                        r = (ins.op == '&') ? (a & b) : (a | b);
+                        break;
+                    default: return false;
+                }
+                if (r > EXACT_INTEGER_MAX || r < -EXACT_INTEGER_MAX) return false;    // double 在这里已经舍入，退回以保持结果一致
+                // 栈上的 0 都是 +0；double 路径在这里会得到 -0 时（负数乘 0、0 除以负数、负数取余为 0）退回
+                if (r == 0 && ((ins.op == '*' && (a < 0 || b < 0)) || (ins.op == '/' && b < 0) || (ins.op == '%' && a < 0))) {
+                    return false;
+                }
+                break;
+            }
+            case OpCode::UNARY:    // 只有一元负号，-0 与 INT64_MIN 都退回
+                if (stack[top - 1] == 0 || stack[top - 1] == INT64_MIN) return false;
+                stack[top - 1] = -stack[top - 1];
+                break;
+        }
+    }
+    result = static_cast<double>(stack[0]);
+    return true;
+}
+
+// 逐个求值时只有三角函数换成快速版本：标准库的 log / pow 标量版本本身已经比多项式核函数快，
+// 它们的快速版本只在批量（向量化）时有收益，见 BatchEvaluator
+double CompiledExpression::evaluateUnary(char op, double b, PrecisionMode mode) {    // 按精度模式执行一元运算
+    if (mode == PrecisionMode::EXACT) return evaluateUnary(op, b);
+    switch (op) {
+        case 's': return FastMath::sin(b);
+        case 'c': return FastMath::cos(b);
+        case 't': return FastMath::tan(b);
+        default: return evaluateUnary(op, b);
+    }
+}
+
+double CompiledExpression::evaluate(const vector<double>& values, PrecisionMode mode) const {    // 按精度模式求值
+    if (mode == PrecisionMode::EXACT) return evaluate(values);
+    if (!isComplete()) throw EvaluationError(INVALID_EXPRESSION, "表达式不完整 (Incomplete expression)");
+    if (values.size() < variables.size()) throw EvaluationError(INVALID_EXPRESSION, "变量取值不足 (Missing variable values)");
+
+    vector<double> stack(maxStackDepth);
+    size_t top = 0;
+    for (const Instruction& ins : code) {
+        switch (ins.code) {
+            case OpCode::PUSH_CONST: stack[top++] = constants[ins.index]; break;
+            case OpCode::LOAD_VAR:   stack[top++] = values[ins.index]; break;
+            case OpCode::BINARY:
+                top--;
+                stack[top - 1] = evaluateOperation(stack[top - 1], stack[top], ins.op);
+                break;
+            case OpCode::UNARY:
+                stack[top - 1] = evaluateUnary(ins.op, stack[top - 1], mode);
+                break;
+        }
+    }
+    return stack[0];
+}
+
+bool ExpressionCompiler::isFunctionName(const string& name, char& func) {    // 判断是否为函数名
+    if (name == "s" || name == "sin") { func = 's'; return true; }
+    if (name == "c" || name == "cos") { func = 'c'; return true; }
+    if (name == "t" || name == "tan") { func = 't'; return true; }
+    if (name == "l" || name == "log") { func = 'l'; return true; }
+    return false;
+}
+
+bool ExpressionCompiler::isConstantName(const string& name, double& value) {    // 判断是否为常量名
+    if (name == "pi") { value = 3.14159265358979323846; return true; }
+    if (name == "e") { value = 2.71828182845904523536; return true; }
+    return false;
+}
+
+namespace {
+
+bool isIdentifierStart(char c) { return isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+bool isIdentifierChar(char c) { return isalnum(static_cast<unsigned char>(c)) || c == '_'; }
+using CharTable::isOpenBracket;
+using CharTable::isCloseBracket;
+using CharTable::isBinaryOperator;
+
+// 从 pos 开始扫描一个数字（整数、小数、科学计数法），返回数字的长度
+size_t scanNumber(const string& expr, size_t pos) {
+    size_t i = CharTable::skipDigits(expr, pos);    // 整数部分（长数字串按块跳过）
+    bool hasDigit = i > pos;
+    while (i < expr.length() && expr[i] == '.') {    // 小数部分（多个小数点留给 parseLiteral 报错）
+        size_t next = CharTable::skipDigits(expr, i + 1);
+        if (next > i + 1) hasDigit = true;
+        i = next;
+    }
+    if (!hasDigit) return 0;
+    // 科学计数法：e 后面必须跟数字（可带符号），否则 e 不属于这个数字
+    if (i < expr.length() && (expr[i] == 'e' || expr[i] == 'E')) {
+        size_t j = i + 1;
+        if (j < expr.length() && (expr[j] == '+' || expr[j] == '-')) j++;
+        if (j < expr.length() && CharTable::isDigit(expr[j])) i = CharTable::skipDigits(expr, j);
+    }
+    return i - pos;
+}
+
+double parseLiteral(const string& text) {    // 解析数字文本
+    size_t used = 0;
+    double value = 0;
+    try {
+        value = stod(text, &used);
+    } catch (const out_of_range&) {
+        throw EvaluationError(INVALID_EXPRESSION, "数字超出范围 (Number out of range): " + text);
+    } catch (const invalid_argument&) {
+        used = 0;
+    }
+    if (used != text.length()) throw EvaluationError(INVALID_EXPRESSION, "无效的数字格式 (Invalid number format): " + text);
+    return value;
+}
+
+// 前缀 / 后缀表达式的 token
+struct Token {
+    enum Kind { NUMBER, IDENTIFIER, OPERATOR } kind;
+    string text;
+};
+
+vector<Token> tokenizeSpaced(const string& expr) {    // 分割前缀 / 后缀表达式
+    vector<Token> tokens;
+    size_t i = 0;
+    while (i < expr.length()) {
+        i = CharTable::skipSpaces(expr, i);
+        if (i >= expr.length()) break;
+        char c = expr[i];
+        // 负号紧跟数字时视为负数
+        size_t start = i;
+        if (c == '-' && i + 1 < expr.length() &&
+            (CharTable::isDigit(expr[i + 1]) || expr[i + 1] == '.')) {
+            i++;
+        }
+        size_t len = scanNumber(expr, i);
+        if (len > 0) {
+            i += len;
+            tokens.push_back({Token::NUMBER, expr.substr(start, i - start)});
+        } else if (isIdentifierStart(c)) {
+            while (i < expr.length() && isIdentifierChar(expr[i])) i++;
+            tokens.push_back({Token::IDENTIFIER, expr.substr(start, i - start)});
+        } else if (isBinaryOperator(c)) {
+            tokens.push_back({Token::OPERATOR, string(1, c)});
+            i++;
+        } else {
+            throw EvaluationError(INVALID_CHARACTER, string("非法字符 (Invalid character): ") + c);
+        }
+    }
+    return tokens;
+}
+
+// 将操作数 token（数字、常量、变量）写入指令序列；若为函数名返回 false
+bool emitOperand(CompiledExpression& compiled, const Token& tk, char& func) {
+    if (tk.kind == Token::NUMBER) {
+        compiled.emitConstant(parseLiteral(tk.text), tk.text);
+        return true;
+    }
+    if (ExpressionCompiler::isFunctionName(tk.text, func)) return false;
+    double value = 0;
+    if (ExpressionCompiler::isConstantName(tk.text, value)) {
+        compiled.emitConstant(value, tk.text);
+    } else {
+        compiled.emitVariable(tk.text);
+    }
+    return true;
+}
+
+}  // namespace
+
+/*中缀编译是表驱动的 Pratt 解析，用显式的帧栈代替递归（深度只受 maxDepth 限制，不会栈溢出），只输出指令、不计算。
+每个待完成的运算符是一帧，记录它的右结合力；新的二元运算符 c 到来时，先输出右结合力大于 c 的左结合力的帧，
+再把 c 压栈。结合力来自 CharTable::BINDING_POWER：左结合 (2p, 2p+1) 使 a-b-c = (a-b)-c，
+右结合 (2p+1, 2p) 使 2^3^2 = 2^(3^2)。期待操作数时出现的 '-' 是一元负号（右结合力见 UNARY_MINUS_BINDING_POWER），
+-2^2 = -(2^2)，不再按前一个字符猜测是负数还是减号。
+左括号和函数帧的右结合力为 0，不会被二元运算符弹出；右括号弹出到匹配的左括号，下面是函数帧时输出函数调用。
+整个过程是一个 O(n) 的循环，期待操作数和期待运算符两种状态交替。*/
+CompiledExpression ExpressionCompiler::compileInfix(const string& expr, size_t maxDepth) {    // 编译中缀表达式
+    struct Frame {    // 待完成的运算符：二元运算符、'~'（一元负号）、函数或左括号
+        char op;
+        int right;    // 右结合力
+    };
+    CompiledExpression compiled;
+    vector<Frame> frames;
+    bool expectOperand = true;  // 当前位置是否期待操作数
+    // 帧栈不会超过输入长度，也不会超过深度限制，预先分配避免反复扩容
+    frames.reserve(maxDepth > 0 && maxDepth < expr.length() ? maxDepth : expr.length());
+
+    auto pushFrame = [&](char op, int right) {    // 压入一帧并检查深度
+        if (maxDepth > 0 && frames.size() >= maxDepth) {
+            throw EvaluationError(LIMIT_EXCEEDED, "嵌套深度超出限制 (Nesting depth limit exceeded)");
+        }
+        frames.push_back({op, right});
+    };
+    auto checkStackDepth = [&]() {    // 检查求值栈深度
+        if (maxDepth > 0 && compiled.getMaxStackDepth() > maxDepth) {
+            throw EvaluationError(LIMIT_EXCEEDED, "嵌套深度超出限制 (Nesting depth limit exceeded)");
+        }
+    };
+    auto popFrame = [&]() {    // 弹出并输出栈顶运算符
+        char op = frames.back().op;
+        frames.pop_back();
+        if (op == '~') compiled.emitUnary('-');
+        else compiled.emitBinary(op);
+    };
+
+    size_t i = 0;
+    while (i < expr.length()) {
+        i = CharTable::skipSpaces(expr, i);
+        if (i >= expr.length()) break;
+        char c = expr[i];
+
+        if (expectOperand) {
+            size_t start = i;
+            size_t len = scanNumber(expr, i);
+            if (len > 0) {
+                i += len;
+                string text = expr.substr(start, len);
+                compiled.emitConstant(parseLiteral(text), text);
+                checkStackDepth();
+                expectOperand = false;
+                continue;
+            }
+            if (c == '-') {    // 一元负号
+                pushFrame('~', CharTable::UNARY_MINUS_BINDING_POWER);
+                i++;
+                continue;
+            }
+            if (isIdentifierStart(c)) {
+                while (i < expr.length() && isIdentifierChar(expr[i])) i++;
+                string name = expr.substr(start, i - start);
+                size_t next = CharTable::skipSpaces(expr, i);
+                char func = 0;
+                double value = 0;
+                if (next < expr.length() && isOpenBracket(expr[next]) && isFunctionName(name, func)) {
+                    pushFrame(func, 0);    // 函数帧，随后的左括号在下一轮压入
+                    continue;
+                }
+                if (isConstantName(name, value)) compiled.emitConstant(value, name);
+                else compiled.emitVariable(name);
+                checkStackDepth();
+                expectOperand = false;
+                continue;
+            }
+            if (isOpenBracket(c)) {
+                pushFrame(c, 0);
+                i++;
+                continue;
+            }
+            if (isBinaryOperator(c)) throw EvaluationError(CONSECUTIVE_OPERATORS, "连续运算符错误 (Consecutive operators error)");
+            if (isCloseBracket(c)) throw EvaluationError(INSUFFICIENT_OPERANDS, "括号内缺少操作数 (Missing operand in brackets)");
+            throw EvaluationError(INVALID_CHARACTER, string("非法字符 (Invalid character): ") + c);
+        }
+
+        // 期待运算符或右括号
+        if (isBinaryOperator(c)) {
+            int left = CharTable::leftBindingPower(c);
+            while (!frames.empty() && frames.back().right > left) popFrame();
+            pushFrame(c, CharTable::rightBindingPower(c));
+            expectOperand = true;
+            i++;
+        } else if (isCloseBracket(c)) {
+            char match = (c == ')') ? '(' : (c == '}') ? '{' : '[';
+            while (!frames.empty() && !isOpenBracket(frames.back().op)) popFrame();
+            if (frames.empty() || frames.back().op != match) {
+                throw EvaluationError(MISMATCHED_PARENTHESES, "括号不匹配错误 (Mismatched parentheses)");
+            }
+            frames.pop_back();    // 移除左括号
+            if (!frames.empty() && CharTable::isFunction(frames.back().op)) {
+                compiled.emitUnary(frames.back().op);    // 栈顶为函数，输出函数调用
+                frames.pop_back();
+            }
+            i++;
+        } else {
+            throw EvaluationError(MISSING_OPERATOR, "缺少运算符错误 (Missing operator)");
+        }
+    }
+
+    if (expectOperand) {
+        if (compiled.getCode().empty() && frames.empty()) throw EvaluationError(EMPTY_EXPRESSION, "表达式为空 (Empty expression)");
+        throw EvaluationError(INSUFFICIENT_OPERANDS, "表达式不能以运算符结尾 (Expression ends with an operator)");
+    }
+    while (!frames.empty()) {
+        if (isOpenBracket(frames.back().op)) throw EvaluationError(MISMATCHED_PARENTHESES, "括号不匹配错误 (Mismatched parentheses)");
+        popFrame();
+    }
+    return compiled;
+}
+
+/*前缀表达式从右向左扫描，先建立语法树，再按后序输出指令（避免递归）。*/
+CompiledExpression ExpressionCompiler::compilePrefix(const string& expr) {    // 编译前缀表达式
+    vector<Token> tokens = tokenizeSpaced(expr);
+    if (tokens.empty()) throw EvaluationError(EMPTY_EXPRESSION, "表达式为空 (Empty expression)");
+
+    struct Node { int token; int left; int right; };    // 语法树结点，right 为 -1 表示一元
+    vector<Node> nodes;
+    vector<int> operands;    // 结点下标栈
+    nodes.reserve(tokens.size());
+
+    for (int i = static_cast<int>(tokens.size()) - 1; i >= 0; --i) {
+        const Token& tk = tokens[i];
+        char func = 0;
+        if (tk.kind == Token::OPERATOR) {
+            if (operands.size() < 2) throw EvaluationError(INSUFFICIENT_OPERANDS, "表达式有误，操作数不足 (Insufficient operands)");
+            int a = operands.back(); operands.pop_back();    // 第一个操作数在栈顶
+            int b = operands.back(); operands.pop_back();
+            nodes.push_back({i, a, b});
+        } else if (tk.kind == Token::IDENTIFIER && isFunctionName(tk.text, func)) {
+            if (operands.empty()) throw EvaluationError(FUNCTION_ARGUMENT_ERROR, "函数参数缺失 (Missing function argument)");
+            int a = operands.back(); operands.pop_back();
+            nodes.push_back({i, a, -1});
+        } else {
+            nodes.push_back({i, -1, -1});
+        }
+        operands.push_back(static_cast<int>(nodes.size() - 1));
+    }
+    if (operands.size() != 1) {
+        throw EvaluationError(MISSING_OPERATOR, "表达式有误，栈中剩余多余元素 (Invalid expression, extra elements in stack)");
+    }
+
+    // 迭代后序遍历输出指令
+    CompiledExpression compiled;
+    vector<pair<int, bool>> work;    // (结点, 子结点是否已展开)
+    work.push_back({operands.back(), false});
+    while (!work.empty()) {
+        auto [id, expanded] = work.back();
+        work.pop_back();
+        const Node& node = nodes[id];
+        const Token& tk = tokens[node.token];
+        if (node.left < 0) {    // 叶子
+            char func = 0;
+            emitOperand(compiled, tk, func);
+        } else if (expanded) {
+            char func = 0;
+            if (node.right < 0 && isFunctionName(tk.text, func)) compiled.emitUnary(func);
+            else compiled.emitBinary(tk.text[0]);
+        } else {
+            work.push_back({id, true});
+            if (node.right >= 0) work.push_back({node.right, false});
+            work.push_back({node.left, false});
+        }
+    }
+    return compiled;
+}
+
+/*后缀表达式从左向右扫描，本身就是指令顺序，直接输出。*/
+CompiledExpression ExpressionCompiler::compilePostfix(const string& expr) {    // 编译后缀表达式
+    vector<Token> tokens = tokenizeSpaced(expr);
+    if (tokens.empty()) throw EvaluationError(EMPTY_EXPRESSION, "表达式为空 (Empty expression)");
+
+    CompiledExpression compiled;
+    for (const Token& tk : tokens) {
+        char func = 0;
+        if (tk.kind == Token::OPERATOR) {
+            compiled.emitBinary(tk.text[0]);
+        } else if (!emitOperand(compiled, tk, func)) {
+            compiled.emitUnary(func);
+        }
+    }
+    if (!compiled.isComplete()) {
+        throw EvaluationError(MISSING_OPERATOR, "表达式有误，栈中剩余多余元素 (Invalid expression, extra elements in stack)");
+    }
+    return compiled;
+}
+
+CompiledExpression ExpressionCompiler::compile(const string& expr, ExpressionType type, size_t maxDepth) {    // 按类型编译
+    switch (type) {
+        case ExpressionType::INFIX:   return compileInfix(expr, maxDepth);
+        case ExpressionType::PREFIX:  return compilePrefix(expr);
+        case ExpressionType::POSTFIX: return compilePostfix(expr);
+    }
+    throw EvaluationError(INVALID_EXPRESSION, "未知的表达式类型 (Unknown expression type)");
+}
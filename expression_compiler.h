@@ -0,0 +1,87 @@
+#ifndef EXPRESSION_COMPILER_H    // 防止头文件重复包含
+#define EXPRESSION_COMPILER_H    // 定义头文件宏
+
+#include "expression_type.h"    // 表达式类型
+#include "fast_math.h"         // 精度模式与快速超越函数
+#include <string>    // 包含字符串处理
+#include <vector>    // 包含向量容器
+#include <cstdint>   // 定长整数类型
+using namespace std; // 使用标准命名空间
+
+/*编译后的表达式采用后缀（逆波兰）指令序列：
+中缀、前缀、后缀三种输入都先编译成同一套指令，之后可以反复求值，
+也可以交给自动微分等其他求值引擎使用，不再逐字符重新解析。
+只含整数常数、不含函数的表达式（如 10 % 3 + 4、5 & 3 | 4）在变量取值也都是整数时走 64 位整数快速路径：
+% 为精确整数取余，^ 为快速幂，& | 为原生整数运算；任一中间结果超过 ±2^53、除不尽、负指数、结果为 -0 等
+double 运算会舍入或得到不同结果的情况退回 double 路径重新求值，因此错误和结果与 double 路径逐位相同，
+批量、CSV、列式文件等只走 double 的入口与逐个求值的结果一致。*/
+
+enum class OpCode {    // 指令操作码
+    PUSH_CONST,        // 压入常数（index 为常数下标）
+    LOAD_VAR,          // 压入变量（index 为变量下标）
+    BINARY,            // 二元运算：+ - * / % ^ & |
+    UNARY              // 一元运算：s c t l，以及一元负号 -
+};
+
+struct Instruction {    // 单条指令
+    OpCode code;        // 操作码
+    char op;            // 运算符字符（BINARY / UNARY 使用）
+    int index;          // 常数或变量下标（PUSH_CONST / LOAD_VAR 使用）
+};
+
+class CompiledExpression {    // 编译后的表达式
+private:
+    vector<Instruction> code;     // 指令序列
+    vector<double> constants;     // 常数表
+    vector<string> literals;      // 常数原文（用于高精度等需要原始文本的引擎）
+    vector<string> variables;     // 变量名表（按首次出现顺序）
+    size_t depth;                 // 当前栈深度（编译时模拟）
+    size_t maxStackDepth;         // 求值所需的最大栈深度
+    bool integral;                // 只含整数常数、没有函数（可走整数快速路径）
+
+    bool evaluateInteger(const vector<double>& values, double& result) const;  // 整数快速路径，需要退回 double 时返回 false
+
+public:
+    CompiledExpression();    // 构造函数
+
+    // 构造指令序列
+    void emitConstant(double value, const string& literal);    // 追加压入常数指令
+    void emitVariable(const string& name);                     // 追加压入变量指令
+    void declareVariable(const string& name);                  // 登记变量但不输出指令（改写表达式时保持变量下标不变）
+    void emitBinary(char op);                                  // 追加二元运算指令
+    void emitUnary(char op);                                   // 追加一元运算指令
+
+    // 求值
+    double evaluate(const vector<double>& values = vector<double>()) const;  // 按变量取值求值
+    double evaluate(const vector<double>& values, PrecisionMode mode) const; // 按精度模式求值（FAST 时 s c t 用快速近似）
+
+    // 访问函数
+    const vector<Instruction>& getCode() const { return code; }          // 获取指令序列
+    const vector<double>& getConstants() const { return constants; }     // 获取常数表
+    const vector<string>& getLiterals() const { return literals; }       // 获取常数原文
+    const vector<string>& getVariables() const { return variables; }     // 获取变量名表
+    size_t getMaxStackDepth() const { return maxStackDepth; }            // 获取最大栈深度
+    int variableIndex(const string& name) const;                         // 查找变量下标，不存在返回 -1
+    bool isComplete() const { return depth == 1; }                      // 指令序列是否恰好产生一个结果
+    bool isIntegral() const { return integral; }                         // 是否可走整数快速路径
+
+    // 运算实现（所有编译后引擎共享的 evaluateOperation）
+    static double evaluateOperation(double a, double b, char op);  // 执行二元运算
+    static double evaluateUnary(char op, double b);                // 执行一元运算
+    static double evaluateUnary(char op, double b, PrecisionMode mode);  // 按精度模式执行一元运算
+    static int toBitwiseOperand(double value);                     // 位运算操作数转 int（越界报错）
+    static bool checkedPower(int64_t base, int64_t exp, int64_t& result);  // 非负整数指数的快速幂，溢出返回 false
+};
+
+class ExpressionCompiler {    // 表达式编译器
+public:
+    static CompiledExpression compileInfix(const string& expr, size_t maxDepth = 0);  // 编译中缀表达式（maxDepth 为 0 表示不限深度）
+    static CompiledExpression compilePrefix(const string& expr);    // 编译前缀表达式
+    static CompiledExpression compilePostfix(const string& expr);   // 编译后缀表达式
+    static CompiledExpression compile(const string& expr, ExpressionType type, size_t maxDepth = 0);  // 按类型编译（maxDepth 仅用于中缀）
+
+    static bool isFunctionName(const string& name, char& func);     // 判断标识符是否为函数名（s/sin 等）
+    static bool isConstantName(const string& name, double& value);  // 判断标识符是否为常量名（pi/e）
+};
+
+#endif // EXPRESSION_COMPILER_H    // 结束头文件保护
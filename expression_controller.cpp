@@ -0,0 +1,127 @@
+#include "ExpressionEvaluator.h"    // 主控制器声明
+#include "infix_evaluator.h"        // 中缀表达式求值器
+#include "prefix_evaluator.h"       // 前缀表达式求值器
+#include "postfix_evaluator.h"      // 后缀表达式求值器
+#include "utils.h"                  // 表达式转换
+
+using namespace std;
+
+ExpressionController::ExpressionController()
+    : currentType(ExpressionType::INFIX), outputPrecision(10), showCalculationSteps(true) {
+    initializeEvaluator(currentType);
+}
+
+ExpressionController::~ExpressionController() = default;
+
+void ExpressionController::initializeEvaluator(ExpressionType type) {    // 按类型创建求值器（类型不变时复用）
+    if (evaluator && type == currentType) return;
+    switch (type) {
+        case ExpressionType::INFIX:   evaluator.reset(new EvaluatorAdapter<InfixEvaluator>()); break;
+        case ExpressionType::PREFIX:  evaluator.reset(new EvaluatorAdapter<PrefixEvaluator>()); break;
+        case ExpressionType::POSTFIX: evaluator.reset(new EvaluatorAdapter<PostfixEvaluator>()); break;
+        default: throw EvaluationError(INVALID_EXPRESSION, "未知的表达式类型 (Unknown expression type)");
+    }
+    currentType = type;
+    evaluator->setVerbose(showCalculationSteps);
+}
+
+double ExpressionController::evaluateExpression(const string& expr, ExpressionType type) {    // 验证并求值表达式
+    initializeEvaluator(type);
+    if (!evaluator->validateExpression(expr)) {
+        throw EvaluationError(INVALID_EXPRESSION, "无效的表达式格式 (Invalid expression format)");
+    }
+    return evaluator->evaluate(expr);
+}
+
+bool ExpressionController::validateExpression(const string& expr, ExpressionType type) {    // 验证表达式
+    initializeEvaluator(type);
+    return evaluator->validateExpression(expr);
+}
+
+string ExpressionController::convertExpression(const string& expr, ExpressionType from, ExpressionType to) {    // 经中缀转换
+    if (from == to) return expr;
+    string infix = expr;
+    if (from == ExpressionType::PREFIX) infix = Utils::prefixToInfix(expr);
+    else if (from == ExpressionType::POSTFIX) infix = Utils::postfixToInfix(expr);
+    if (to == ExpressionType::PREFIX) return Utils::infixToPrefix(infix);
+    if (to == ExpressionType::POSTFIX) return Utils::infixToPostfix(infix);
+    return infix;
+}
+
+void ExpressionController::runInteractiveMode() {    // 交互模式：每行“类型 表达式”，或 help / examples / features / steps on|off / precision n / q
+    displayHelp();
+    string input;
+    while (true) {
+        cout << "\n> ";
+        if (!getline(cin, input) || input == "q" || input == "Q") break;
+        istringstream iss(input);
+        string command;
+        iss >> command;
+        if (command.empty()) continue;
+        if (command == "help") { displayHelp(); continue; }
+        if (command == "examples") { displayExamples(); continue; }
+        if (command == "features") { displaySupportedFeatures(); continue; }
+        if (command == "steps") {
+            string value;
+            iss >> value;
+            setDisplayMode(value != "off");
+            continue;
+        }
+        if (command == "precision") {
+            int precision = 0;
+            if (iss >> precision && precision >= 0) setPrecision(precision);
+            else displayError("精度必须是非负整数 (Precision must be a non-negative integer)");
+            continue;
+        }
+
+        if (command != "1" && command != "2" && command != "3") {
+            displayError("输入格式无效，请使用'类型 表达式'格式 (Invalid input format. Please use 'type expression' format)");
+            continue;
+        }
+        string expr;
+        getline(iss >> ws, expr);
+        try {
+            displayResult(evaluateExpression(expr, static_cast<ExpressionType>(command[0] - '0')));
+        } catch (const exception& e) {
+            displayError(e.what());
+        }
+    }
+}
+
+void ExpressionController::displayHelp() {    // 显示帮助信息
+    cout << "输入格式 (Input format): 类型 表达式 / type expression（1-中缀 Infix, 2-前缀 Prefix, 3-后缀 Postfix）" << endl;
+    cout << "命令 (Commands): help, examples, features, steps on|off, precision <n>, q" << endl;
+}
+
+void ExpressionController::displayExamples() {    // 显示示例
+    cout << "1 3 + 4 * (2 - 1)" << endl;
+    cout << "1 s(pi / 2) + l(e)" << endl;
+    cout << "2 + * 2 3 4" << endl;
+    cout << "3 3 4 * 2 +" << endl;
+}
+
+void ExpressionController::displaySupportedFeatures() {    // 显示支持的功能
+    cout << "运算符 (Operators): + - * / % ^ & |" << endl;
+    cout << "函数 (Functions): s(sin) c(cos) t(tan) l(log)（仅中缀 / infix only）" << endl;
+    cout << "常量 (Constants): pi, e" << endl;
+    cout << "括号 (Brackets): ( ) [ ] { }" << endl;
+}
+
+void ExpressionController::setPrecision(int precision) {    // 设置输出精度
+    outputPrecision = precision;
+}
+
+void ExpressionController::setDisplayMode(bool showSteps) {    // 设置是否显示计算步骤
+    showCalculationSteps = showSteps;
+    if (evaluator) evaluator->setVerbose(showSteps);
+}
+
+void ExpressionController::displayResult(double result) {    // 显示结果
+    cout << "\n最终结果 (Final result): " << fixed << setprecision(outputPrecision) << result << endl;
+    cout << "----------------------------------------" << endl;
+}
+
+void ExpressionController::displayError(const string& error) {    // 显示错误
+    cout << "\n错误 (Error): " << error << endl;
+    cout << "----------------------------------------" << endl;
+}
@@ -0,0 +1,52 @@
+#include "expression_generator.h"    // 包含随机表达式生成器头文件
+
+using namespace std;
+
+ExpressionGenerator::ExpressionGenerator(uint32_t seed, const GeneratorOptions& options)
+    : options(options), rng(seed), data(nullptr), size(0), pos(0) {}
+
+ExpressionGenerator::ExpressionGenerator(const uint8_t* data, size_t size, const GeneratorOptions& options)
+    : options(options), rng(0), data(data), size(size), pos(0) {}
+
+uint32_t ExpressionGenerator::choose(uint32_t bound) {    // 取 [0, bound) 内的随机选择
+    if (bound <= 1) return 0;
+    if (data == nullptr) return uniform_int_distribution<uint32_t>(0, bound - 1)(rng);
+    if (pos >= size) return 0;    // 字节用完后总是选第一个分支，保证生成结束
+    return data[pos++] % bound;
+}
+
+void ExpressionGenerator::generateNumber(string& out) {    // 生成一个数字
+    out += to_string(choose(100));
+    if (options.allowDecimals && choose(4) == 0) {
+        out += '.';
+        out += to_string(choose(100));
+    }
+}
+
+void ExpressionGenerator::generateExpression(string& out, int depth) {    // 递归生成子表达式
+    uint32_t kind = depth >= options.maxDepth ? 0 : choose(options.allowNegation ? 5 : 4);
+    if (kind == 0 || options.operators.empty()) {    // 数字
+        generateNumber(out);
+    } else if (kind == 1) {    // 括号
+        const char* brackets = options.allowAllBrackets ? "()[]{}" + 2 * choose(3) : "()";
+        out += brackets[0];
+        generateExpression(out, depth + 1);
+        out += brackets[1];
+    } else if (kind == 4) {    // 一元负号
+        out += '-';
+        generateExpression(out, depth + 1);
+    } else {    // 二元运算
+        generateExpression(out, depth + 1);
+        bool spaced = options.allowSpaces && choose(2) == 0;
+        if (spaced) out += ' ';
+        out += options.operators[choose(static_cast<uint32_t>(options.operators.size()))];
+        if (spaced) out += ' ';
+        generateExpression(out, depth + 1);
+    }
+}
+
+string ExpressionGenerator::generate() {    // 生成一个中缀表达式
+    string out;
+    generateExpression(out, 0);
+    return out;
+}
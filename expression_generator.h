@@ -0,0 +1,43 @@
+#ifndef EXPRESSION_GENERATOR_H    // 防止头文件重复包含
+#define EXPRESSION_GENERATOR_H    // 定义头文件宏
+
+#include <string>     // 包含字符串处理
+#include <random>     // 随机数引擎
+#include <cstdint>    // 定长整数类型
+#include <cstddef>    // size_t
+using namespace std;  // 使用标准命名空间
+
+/*随机中缀表达式生成器，用于差分测试和吞吐量测量。
+只生成三种记法（中缀求值、Utils 转换后的前缀 / 后缀求值）都支持的子集：
+非负整数和小数、二元运算符、三种括号和一元负号（转换后写成负数或乘以 -1）。随机选择既可以来自种子，也可以来自 fuzzer 提供的字节，
+后者让 libFuzzer 的覆盖率反馈作用在表达式结构上，而不是随机字节上。*/
+
+struct GeneratorOptions {        // 生成选项
+    int maxDepth = 6;            // 最大嵌套深度
+    string operators = "+-*/";   // 可用的二元运算符
+    bool allowDecimals = true;   // 是否生成小数
+    bool allowSpaces = true;     // 是否在运算符两侧随机插入空格
+    bool allowNegation = true;   // 是否生成一元负号（检验负号与 ^、乘除之间的优先级）
+    bool allowAllBrackets = true;    // 是否生成方括号和花括号（否则只用圆括号）
+};
+
+class ExpressionGenerator {    // 随机表达式生成器
+private:
+    GeneratorOptions options;  // 生成选项
+    mt19937 rng;               // 随机数引擎（种子模式）
+    const uint8_t* data;       // fuzzer 字节（字节模式，nullptr 表示种子模式）
+    size_t size;               // 字节数
+    size_t pos;                // 已消耗的字节数
+
+    uint32_t choose(uint32_t bound);              // 取 [0, bound) 内的随机选择
+    void generateNumber(string& out);             // 生成一个数字
+    void generateExpression(string& out, int depth);    // 递归生成子表达式（深度不超过 maxDepth）
+
+public:
+    ExpressionGenerator(uint32_t seed, const GeneratorOptions& options = GeneratorOptions());                 // 种子模式
+    ExpressionGenerator(const uint8_t* data, size_t size, const GeneratorOptions& options = GeneratorOptions());  // 字节模式
+
+    string generate();    // 生成一个中缀表达式
+};
+
+#endif // EXPRESSION_GENERATOR_H    // 结束头文件保护
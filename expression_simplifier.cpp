@@ -0,0 +1,284 @@
+#include "expression_simplifier.h"    // 包含表达式化简器头文件
+#include "error_type.h"               // 错误类型
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+struct Node {          // 语法树结点
+    OpCode code;       // 操作码
+    char op;           // 运算符（BINARY / UNARY）
+    int left;          // 左子结点（BINARY）或唯一子结点（UNARY）
+    int right;         // 右子结点（BINARY）
+    int index;         // 变量下标（LOAD_VAR）
+    double value;      // 常数值（PUSH_CONST）
+    string literal;    // 常数原文（PUSH_CONST）
+    bool mayFail;      // 求值时是否可能出错（除零、对数参数非正、位运算越界）
+    int size;          // 子树的指令数
+    int polyVar;       // 子树是单变量多项式时的变量下标，NO_POLYNOMIAL 表示不是，ANY_VARIABLE 表示常数
+    vector<double> poly;    // 多项式系数（按次数从低到高）
+};
+
+constexpr int MAX_REPEATED_BASE = 3;        // x^n 展开时底数子树最多的指令数（如 x - 1），重复计算它仍比调用 pow 便宜
+constexpr int NO_POLYNOMIAL = -2;
+constexpr int ANY_VARIABLE = -1;
+constexpr size_t MAX_POLYNOMIAL_DEGREE = 32;    // 超过该次数的多项式不改写
+constexpr double MAX_EXACT_INTEGER = 9007199254740992.0;    // 2^53，double 能连续精确表示的最大整数
+
+size_t nonzeroTerms(const vector<double>& poly) {    // 非零系数个数
+    size_t count = 0;
+    for (double c : poly) count += (c != 0);
+    return count;
+}
+
+/*子树是单变量多项式时求出系数：常数和变量本身是多项式，+ - 、一元负号和除以非零常数逐项计算，
+乘法只在一边是常数或两边都是单项式时展开（不展开 (x+1)*(x+2) 这样的乘积，避免引入抵消误差），
+x^n 要求底数就是变量、n 为不超过 MAX_POLYNOMIAL_DEGREE 的非负整数。*/
+void derivePolynomial(Node& n, const Node& a, const Node* b) {
+    n.polyVar = NO_POLYNOMIAL;
+    if (a.polyVar == NO_POLYNOMIAL || (b && b->polyVar == NO_POLYNOMIAL)) return;
+    int var = a.polyVar;
+    if (b && b->polyVar != ANY_VARIABLE) {
+        if (var != ANY_VARIABLE && var != b->polyVar) return;
+        var = b->polyVar;
+    }
+    vector<double> result;
+    if (n.code == OpCode::UNARY) {
+        if (n.op != '-') return;
+        for (double c : a.poly) result.push_back(-c);
+    } else if (n.op == '+' || n.op == '-') {
+        result.assign(max(a.poly.size(), b->poly.size()), 0.0);
+        for (size_t k = 0; k < a.poly.size(); k++) result[k] = a.poly[k];
+        for (size_t k = 0; k < b->poly.size(); k++) result[k] = (n.op == '+') ? result[k] + b->poly[k] : result[k] - b->poly[k];
+    } else if (n.op == '*') {
+        bool scale = a.poly.size() == 1 || b->poly.size() == 1;
+        if (!scale && (nonzeroTerms(a.poly) > 1 || nonzeroTerms(b->poly) > 1)) return;
+        if (a.poly.size() + b->poly.size() - 1 > MAX_POLYNOMIAL_DEGREE + 1) return;
+        result.assign(a.poly.size() + b->poly.size() - 1, 0.0);
+        for (size_t i = 0; i < a.poly.size(); i++) {
+            if (a.poly[i] == 0) continue;
+            for (size_t j = 0; j < b->poly.size(); j++) {
+                if (b->poly[j] != 0) result[i + j] += a.poly[i] * b->poly[j];
+            }
+        }
+    } else if (n.op == '/') {    // 除以非零常数
+        if (b->polyVar != ANY_VARIABLE || b->poly[0] == 0) return;
+        for (double c : a.poly) result.push_back(c / b->poly[0]);
+    } else if (n.op == '^') {
+        double exponent = b->poly.size() == 1 ? b->poly[0] : -1;
+        bool isVariable = a.polyVar != ANY_VARIABLE && a.poly.size() == 2 && a.poly[0] == 0 && a.poly[1] == 1;
+        if (b->polyVar != ANY_VARIABLE || !isVariable || exponent < 0 || exponent > MAX_POLYNOMIAL_DEGREE || exponent != floor(exponent)) return;
+        result.assign(static_cast<size_t>(exponent) + 1, 0.0);
+        result.back() = 1.0;
+    } else {
+        return;
+    }
+    if (result.size() > MAX_POLYNOMIAL_DEGREE + 1) return;
+    n.polyVar = var;
+    n.poly = move(result);
+}
+
+string formatConstant(double value) {    // 折叠出的常数文本（17 位有效数字，能还原成同一个 double）
+    ostringstream out;
+    out << setprecision(17) << value;
+    return out.str();
+}
+
+bool isPowerOfTwo(double value) {    // |value| 是否为 2 的整数次幂
+    int exponent;
+    return value != 0 && isfinite(value) && fabs(frexp(value, &exponent)) == 0.5;
+}
+
+class Rewriter {    // 自底向上建树，建结点时就地化简
+private:
+    const SimplifyOptions& options;
+    vector<Node> nodes;
+
+    int add(Node node) {
+        nodes.push_back(move(node));
+        return static_cast<int>(nodes.size() - 1);
+    }
+    bool isConstant(int id) const { return nodes[id].code == OpCode::PUSH_CONST; }
+    bool isConstant(int id, double value) const { return isConstant(id) && nodes[id].value == value; }    // 与 value 相等（0 不区分正负）
+    bool isZero(int id, bool negative) const {    // 是否为指定符号的零
+        return isConstant(id, 0.0) && signbit(nodes[id].value) == negative;
+    }
+
+    bool fold(OpCode code, char op, int a, int b, double& result) const {    // 按 double 语义折叠常数，出错或不宜折叠时返回 false
+        try {
+            result = (code == OpCode::BINARY) ? CompiledExpression::evaluateOperation(nodes[a].value, nodes[b].value, op)
+                                              : CompiledExpression::evaluateUnary(op, nodes[a].value);
+        } catch (const EvaluationError&) {
+            return false;
+        }
+        // 整数运算的结果达到 2^53 时可能已经舍入（2^53 + 1 舍入成 2^53），无法确认精确，不折叠，留到求值时与原表达式同样计算
+        bool integerOperands = nodes[a].value == floor(nodes[a].value) && (code == OpCode::UNARY || nodes[b].value == floor(nodes[b].value));
+        return !(integerOperands && fabs(result) >= MAX_EXACT_INTEGER);
+    }
+
+    int node(OpCode code, char op, int a, int b) {    // 不化简，直接建运算结点
+        bool mayFail = nodes[a].mayFail || (code == OpCode::BINARY && nodes[b].mayFail);
+        if (code == OpCode::UNARY && op == 'l') mayFail = true;
+        if (code == OpCode::BINARY && (op == '&' || op == '|')) mayFail = true;
+        if (code == OpCode::BINARY && (op == '/' || op == '%') && !(isConstant(b) && nodes[b].value != 0)) mayFail = true;
+        int size = 1 + nodes[a].size + (code == OpCode::BINARY ? nodes[b].size : 0);
+        Node n{code, op, a, b, 0, 0.0, "", mayFail, size, NO_POLYNOMIAL, {}};
+        derivePolynomial(n, nodes[a], code == OpCode::BINARY ? &nodes[b] : nullptr);
+        return add(move(n));
+    }
+
+public:
+    explicit Rewriter(const SimplifyOptions& options) : options(options) {}
+
+    int constant(double value, const string& literal) {
+        return add({OpCode::PUSH_CONST, 0, -1, -1, 0, value, literal, false, 1, ANY_VARIABLE, {value}});
+    }
+
+    int variable(int index) {
+        return add({OpCode::LOAD_VAR, 0, -1, -1, index, 0.0, "", false, 1, index, {0.0, 1.0}});
+    }
+
+    int unary(char op, int a) {
+        double result;
+        if (isConstant(a) && fold(OpCode::UNARY, op, a, -1, result)) return constant(result, formatConstant(result));
+        if (op == '-' && nodes[a].code == OpCode::UNARY && nodes[a].op == '-') return nodes[a].left;    // -(-x) → x
+        return node(OpCode::UNARY, op, a, -1);
+    }
+
+    int binary(char op, int a, int b) {
+        double result;
+        if (isConstant(a) && isConstant(b) && fold(OpCode::BINARY, op, a, b, result)) return constant(result, formatConstant(result));
+        switch (op) {
+            case '+':
+                if (isZero(b, true) || (options.finiteMath && isConstant(b, 0.0))) return a;    // x + (-0) → x
+                if (isZero(a, true) || (options.finiteMath && isConstant(a, 0.0))) return b;
+                break;
+            case '-':
+                if (isZero(b, false) || (options.finiteMath && isConstant(b, 0.0))) return a;    // x - 0 → x
+                if (options.finiteMath && isConstant(a, 0.0)) return unary('-', b);
+                break;
+            case '*':
+                if (isConstant(b, 1.0)) return a;
+                if (isConstant(a, 1.0)) return b;
+                if (isConstant(b, -1.0)) return unary('-', a);
+                if (isConstant(a, -1.0)) return unary('-', b);
+                if (options.finiteMath && isConstant(b, 0.0) && !nodes[a].mayFail) return constant(0.0, "0");
+                if (options.finiteMath && isConstant(a, 0.0) && !nodes[b].mayFail) return constant(0.0, "0");
+                break;
+            case '/':
+                if (isConstant(b, 1.0)) return a;
+                if (isConstant(b, -1.0)) return unary('-', a);
+                if (isConstant(b) && nodes[b].value != 0 && (isPowerOfTwo(nodes[b].value) || options.reciprocalDivision)) {
+                    double reciprocal = 1.0 / nodes[b].value;
+                    if (isnormal(reciprocal)) return binary('*', a, constant(reciprocal, formatConstant(reciprocal)));
+                }
+                break;
+            case '^':
+                if (isConstant(b, 1.0)) return a;
+                if (isConstant(b, 0.0) && !nodes[a].mayFail) return constant(1.0, "1");    // pow(x, 0) 恒为 1（含 NaN）
+                if (nodes[a].size <= MAX_REPEATED_BASE && !nodes[a].mayFail && isConstant(b) && nodes[b].value >= 2
+                    && nodes[b].value <= options.maxPowerChain && nodes[b].value == floor(nodes[b].value)) {
+                    int chain = a;    // x^n → x * x * ...（底数子树在输出时重复展开，结果相同）
+                    for (int k = 1; k < static_cast<int>(nodes[b].value); k++) chain = node(OpCode::BINARY, '*', chain, a);
+                    return chain;
+                }
+                break;
+        }
+        return node(OpCode::BINARY, op, a, b);
+    }
+
+    bool isHornerCandidate(const Node& n) const {    // 至少二次、至少两项的单变量多项式（最高次系数非零）
+        if (!options.horner || n.polyVar < 0 || n.code != OpCode::BINARY) return false;
+        size_t degree = n.poly.size() - 1;
+        while (degree > 0 && n.poly[degree] == 0) degree--;
+        return degree >= 2 && nonzeroTerms(n.poly) >= 2;
+    }
+
+    static void emitHorner(CompiledExpression& result, const string& variable, const vector<double>& poly) {    // (c_n*x + c_{n-1})*x + ... + c_0
+        size_t degree = poly.size() - 1;
+        while (poly[degree] == 0) degree--;
+        for (size_t k = degree; k-- > 0;) {
+            if (k + 1 < degree) {
+                result.emitVariable(variable);
+                result.emitBinary('*');
+            } else if (poly[degree] == 1) {
+                result.emitVariable(variable);    // 首项系数为 1 时省去一次乘法
+            } else {
+                result.emitConstant(poly[degree], formatConstant(poly[degree]));
+                result.emitVariable(variable);
+                result.emitBinary('*');
+            }
+            if (poly[k] != 0) {
+                result.emitConstant(poly[k], formatConstant(poly[k]));
+                result.emitBinary('+');
+            }
+        }
+    }
+
+    CompiledExpression emit(const CompiledExpression& original, int root) const {    // 按后序输出指令（迭代，避免深树递归）
+        CompiledExpression result;
+        for (const string& name : original.getVariables()) result.declareVariable(name);
+        vector<pair<int, bool>> work;    // (结点, 子结点是否已展开)
+        work.push_back({root, false});
+        while (!work.empty()) {
+            auto [id, expanded] = work.back();
+            work.pop_back();
+            const Node& n = nodes[id];
+            if (!expanded && isHornerCandidate(n)) {    // 自顶向下最先遇到的多项式子树就是最大的
+                emitHorner(result, original.getVariables()[n.polyVar], n.poly);
+                continue;
+            }
+            switch (n.code) {
+                case OpCode::PUSH_CONST: result.emitConstant(n.value, n.literal); break;
+                case OpCode::LOAD_VAR:   result.emitVariable(original.getVariables()[n.index]); break;
+                case OpCode::UNARY:
+                case OpCode::BINARY:
+                    if (expanded) {
+                        if (n.code == OpCode::UNARY) result.emitUnary(n.op);
+                        else result.emitBinary(n.op);
+                    } else {
+                        work.push_back({id, true});
+                        if (n.code == OpCode::BINARY) work.push_back({n.right, false});
+                        work.push_back({n.left, false});
+                    }
+                    break;
+            }
+        }
+        return result;
+    }
+};
+
+}  // namespace
+
+CompiledExpression ExpressionSimplifier::simplify(const CompiledExpression& expr, const SimplifyOptions& options) {    // 化简
+    if (!expr.isComplete()) throw EvaluationError(INVALID_EXPRESSION, "表达式不完整 (Incomplete expression)");
+    Rewriter rewriter(options);
+    const vector<double>& constants = expr.getConstants();
+    const vector<string>& literals = expr.getLiterals();
+    vector<int> stack;    // 结点下标栈
+    stack.reserve(expr.getMaxStackDepth());
+    for (const Instruction& ins : expr.getCode()) {
+        switch (ins.code) {
+            case OpCode::PUSH_CONST:
+                stack.push_back(rewriter.constant(constants[ins.index], literals[ins.index]));
+                break;
+            case OpCode::LOAD_VAR:
+                stack.push_back(rewriter.variable(ins.index));
+                break;
+            case OpCode::UNARY:
+                stack.back() = rewriter.unary(ins.op, stack.back());
+                break;
+            case OpCode::BINARY: {
+                int b = stack.back();
+                stack.pop_back();
+                stack.back() = rewriter.binary(ins.op, stack.back(), b);
+                break;
+            }
+        }
+    }
+    return rewriter.emit(expr, stack.back());
+}
@@ -0,0 +1,36 @@
+#ifndef EXPRESSION_SIMPLIFIER_H    // 防止头文件重复包含
+#define EXPRESSION_SIMPLIFIER_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+using namespace std;                // 使用标准命名空间
+
+/*编译后表达式的化简与强度削减：把指令序列还原成语法树，自底向上改写后重新输出指令。
+默认的改写不改变出错行为，结果与原表达式逐位相同（幂除外）：
+- 常数折叠（如 l(e) → 1、2 * pi → 6.283...）按 double 语义进行（保留 -0，如 (-0)^(-1) → -inf），折叠时出错的子表达式保持原样，
+  留到求值时报同样的错；绝对值达到 2^53 的整数结果不折叠（可能已经舍入），留到求值时计算；
+- x * 1、1 * x、x / 1、x - 0 → x，x * -1、x / -1 → -x，-(-x) → x，x^1 → x，x^0 → 1；
+- 除以 2 的幂 c → 乘以 1/c（倒数精确）；
+- x^n（n 为 2 到 maxPowerChain 的整数，x 为变量或 x - 1 这样不超过 3 条指令、不会出错的子表达式）→ x * x * ...：x * x 是正确舍入的平方（pow 偶尔差 1 ulp），
+  n ≥ 3 的乘法链误差约 (n-1)/2 ulp，maxPowerChain 设为 2 或更小可以关闭。
+可选的改写会改变舍入或特殊值：reciprocalDivision 把除以任意非零常数换成乘以倒数（可能差 1 ulp）；
+finiteMath 假设没有 NaN、无穷和负零，化简 x + 0、0 + x → x，x * 0 → 0，0 - x → -x；
+horner 把单变量多项式（如 3*x^3 + 2*x^2 + x + 7，至少二次、至少两项）合并同类项后按 Horner 形式 ((3x + 2)x + 1)x + 7 输出，
+不再调用 pow，BatchEvaluator 识别这种指令序列并整段融合求值。舍入与逐项求和不同（ulp 量级），
+x 为无穷时 NaN 可能变成 ±inf（如 x - x^2 逐项求值是 inf - inf = NaN，Horner 形式 (1 - x)x 为 -inf），与 finiteMath 一样只在输入有限时使用。
+被丢弃的子表达式（如 x * 0 中的 x）必须不会出错（不含 / % & | l），否则保留，错误照常报告。
+变量表与原表达式相同（下标不变），原来的取值向量可以直接使用。
+折叠出的常数以十进制文本记录，只保证 double 求值一致：有理数、多精度等精确引擎应使用未化简的表达式。*/
+
+struct SimplifyOptions {           // 化简选项
+    bool reciprocalDivision = false;  // 除以任意非零常数改为乘以倒数（可能差 1 ulp）
+    bool finiteMath = false;          // 假设没有 NaN / 无穷 / 负零
+    int maxPowerChain = 4;            // x^n 展开成乘法的最大 n（小于 2 时不展开）
+    bool horner = false;              // 单变量多项式按 Horner 形式输出（x 为无穷时 NaN 可能变成 ±inf）
+};
+
+class ExpressionSimplifier {    // 表达式化简器
+public:
+    static CompiledExpression simplify(const CompiledExpression& expr, const SimplifyOptions& options = SimplifyOptions());  // 化简，返回新的表达式
+};
+
+#endif // EXPRESSION_SIMPLIFIER_H    // 结束头文件保护
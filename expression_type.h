@@ -0,0 +1,10 @@
+#ifndef EXPRESSION_TYPE_H    // 防止头文件重复包含
+#define EXPRESSION_TYPE_H    // 定义头文件宏
+
+enum class ExpressionType {   // 表达式类型枚举类
+    INFIX = 1,               // 中缀表达式
+    PREFIX = 2,              // 前缀表达式
+    POSTFIX = 3              // 后缀表达式
+};
+
+#endif // EXPRESSION_TYPE_H    // 结束头文件保护
@@ -0,0 +1,128 @@
+#include "ExpressionEvaluator.h"    // ExpressionTypeDetector 声明
+#include "expression_compiler.h"    // 判断类型标记时试编译
+#include <cctype>
+
+using namespace std;
+
+/*一遍扫描判断记法，不做试探性解析：只看首尾记号的种类和运算数、运算符的个数。
+- 出现括号（含函数调用）只可能是中缀；
+- 运算数个数 = 二元运算符个数 + 1 时，以运算符开头为前缀、以运算符结尾为后缀；
+- 其余（含单个运算数、一元负号开头的中缀如 -pi + 1）按中缀处理，格式错误交给对应的求值器报告。
+记号开头紧跟数字的 '-'（前面是行首、空白或左括号）视为负数的符号，所以 -3 + 4 是中缀，- 3 4 是前缀。*/
+
+namespace {
+
+enum TokenKind { NO_TOKEN, OPERAND, OPERATOR, BRACKET };    // 记号种类
+
+struct Shape {                   // 扫描结果
+    TokenKind first = NO_TOKEN;  // 第一个记号
+    TokenKind last = NO_TOKEN;   // 最后一个记号
+    size_t operands = 0;         // 运算数个数（数字、常量、变量）
+    size_t operators = 0;        // 二元运算符个数
+    bool brackets = false;       // 是否出现括号
+};
+
+bool isIdentifierChar(char c) {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+size_t skipNumber(const string& expr, size_t pos) {    // 跳过数字（含小数点与科学计数法指数）
+    while (pos < expr.size()) {
+        pos = CharTable::skipDigits(expr, pos);
+        if (pos >= expr.size()) break;
+        char c = expr[pos];
+        if (c == '.') {
+            pos++;
+        } else if ((c == 'e' || c == 'E') && pos + 1 < expr.size()
+                   && (CharTable::isDigit(expr[pos + 1])
+                       || ((expr[pos + 1] == '+' || expr[pos + 1] == '-') && pos + 2 < expr.size() && CharTable::isDigit(expr[pos + 2])))) {
+            pos += 2;
+        } else {
+            break;
+        }
+    }
+    return pos;
+}
+
+Shape scan(const string& expr) {    // 一遍扫描，统计首尾记号种类和运算数、运算符个数
+    Shape shape;
+    size_t pos = CharTable::skipSpaces(expr, 0);
+    while (pos < expr.size()) {
+        char c = expr[pos];
+        TokenKind kind;
+        bool tokenStart = pos == 0 || CharTable::isSpace(expr[pos - 1]) || CharTable::isOpenBracket(expr[pos - 1]);
+        if (CharTable::isDigit(c) || c == '.'
+            || (c == '-' && tokenStart && pos + 1 < expr.size() && (CharTable::isDigit(expr[pos + 1]) || expr[pos + 1] == '.'))) {
+            pos = skipNumber(expr, pos + 1);
+            kind = OPERAND;
+            shape.operands++;
+        } else if (CharTable::isBinaryOperator(c)) {
+            pos++;
+            kind = OPERATOR;
+            shape.operators++;
+        } else if (CharTable::isBracket(c)) {
+            pos++;
+            kind = BRACKET;
+            shape.brackets = true;
+        } else {    // 常量、变量或函数名（函数后面必有括号）；非法字符也按运算数计，由求值器报错
+            pos++;
+            while (pos < expr.size() && isIdentifierChar(expr[pos])) pos++;
+            kind = OPERAND;
+            shape.operands++;
+        }
+        if (shape.first == NO_TOKEN) shape.first = kind;
+        shape.last = kind;
+        pos = CharTable::skipSpaces(expr, pos);
+    }
+    return shape;
+}
+
+bool compiles(const string& expr, ExpressionType type) {    // 能否按 type 记法编译（不求值）
+    try {
+        ExpressionCompiler::compile(expr, type);
+        return true;
+    } catch (const exception&) {
+        return false;
+    }
+}
+
+ExpressionType classify(const Shape& shape) {    // 按首尾记号和运算数、运算符个数判断记法
+    if (shape.brackets || shape.operands != shape.operators + 1) return ExpressionType::INFIX;
+    if (shape.first == OPERATOR) return ExpressionType::PREFIX;
+    if (shape.last == OPERATOR) return ExpressionType::POSTFIX;
+    return ExpressionType::INFIX;
+}
+
+}  // namespace
+
+ExpressionType ExpressionTypeDetector::detectType(const string& expr) {    // 检测表达式类型，空表达式抛出 EvaluationError
+    Shape shape = scan(expr);
+    if (shape.first == NO_TOKEN) throw EvaluationError(EMPTY_EXPRESSION, "表达式为空 (Empty expression)");
+    return classify(shape);
+}
+
+bool ExpressionTypeDetector::isInfixExpression(const string& expr) {    // 判断是否为中缀表达式
+    Shape shape = scan(expr);
+    return shape.first != NO_TOKEN && classify(shape) == ExpressionType::INFIX;
+}
+
+bool ExpressionTypeDetector::isPrefixExpression(const string& expr) {    // 判断是否为前缀表达式
+    Shape shape = scan(expr);
+    return shape.first != NO_TOKEN && classify(shape) == ExpressionType::PREFIX;
+}
+
+bool ExpressionTypeDetector::isPostfixExpression(const string& expr) {    // 判断是否为后缀表达式
+    Shape shape = scan(expr);
+    return shape.first != NO_TOKEN && classify(shape) == ExpressionType::POSTFIX;
+}
+
+/*交互输入的行首数字既可能是类型标记，也可能是表达式的第一个运算数，计数区分不了一元负号（1 2*-3、1 -(3)），
+所以这里按记法试编译（线性时间，只在交互输入时调用一次）：
+去掉它后的部分能按标记的记法编译（如 1 3 + 4、1 2*-3、1 -(3)、3 3 4 * 2 +）时是类型标记；
+否则整行本身能按自动识别的记法编译（如 1 + 2、3 4 +）时数字属于表达式；
+两者都不能编译时仍视为类型标记（与原来的规则相同），错误按标记的记法报告。*/
+bool ExpressionTypeDetector::hasTypeTag(const string& line) {    // 行首的 1 / 2 / 3 是否为类型标记
+    if (line.size() < 2 || line[0] < '1' || line[0] > '3' || !CharTable::isSpace(line[1])) return false;
+    if (compiles(line.substr(2), static_cast<ExpressionType>(line[0] - '0'))) return true;
+    return !compiles(line, classify(scan(line)));
+}
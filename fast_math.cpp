@@ -0,0 +1,84 @@
+#include "fast_math.h"    // 包含快速超越函数头文件
+#include <algorithm>
+
+using namespace std;
+
+/*批量版本按 256 个元素分块：先把输入复制到栈上的缓冲区（定义域外的元素和末块不足部分填安全值），
+再对整块无条件计算核函数。循环次数固定、缓冲区不与输入输出重叠，编译器在 -O2 下即可向量化；
+最后逐个写出结果，定义域外的元素改用标准库计算。每个元素先读输入再写输出，所以 out 可以与输入相同。*/
+
+namespace FastMath {
+
+namespace {
+
+constexpr size_t CHUNK = 256;    // 分块大小
+
+template<typename Kernel, typename InRange, typename Fallback>
+void unaryBatch(const double* x, double* out, size_t n, double safe, Kernel kernel, InRange inRange, Fallback fallback) {
+    double buffer[CHUNK];
+    for (size_t base = 0; base < n; base += CHUNK) {
+        size_t count = min(CHUNK, n - base);
+        const double* in = x + base;
+        for (size_t i = 0; i < count; i++) {
+            double v = in[i];
+            buffer[i] = inRange(v) ? v : safe;    // 定义域外先用安全值代入，写出时再修正
+        }
+        for (size_t i = count; i < CHUNK; i++) buffer[i] = safe;
+        for (size_t i = 0; i < CHUNK; i++) buffer[i] = kernel(buffer[i]);    // 定长、无分支：向量化的主循环
+        for (size_t i = 0; i < count; i++) {
+            double v = in[i];
+            out[base + i] = inRange(v) ? buffer[i] : fallback(v);
+        }
+    }
+}
+
+}  // namespace
+
+void sin(const double* x, double* out, size_t n) {
+    unaryBatch(x, out, n, 0.0, [](double v) { return sinKernel(v); }, [](double v) { return trigInRange(v); },
+               [](double v) { return std::sin(v); });
+}
+
+void cos(const double* x, double* out, size_t n) {
+    unaryBatch(x, out, n, 0.0, [](double v) { return cosKernel(v); }, [](double v) { return trigInRange(v); },
+               [](double v) { return std::cos(v); });
+}
+
+void tan(const double* x, double* out, size_t n) {
+    unaryBatch(x, out, n, 0.0, [](double v) { return tanKernel(v); }, [](double v) { return trigInRange(v); },
+               [](double v) { return std::tan(v); });
+}
+
+void log(const double* x, double* out, size_t n) {
+    unaryBatch(x, out, n, 1.0, [](double v) { return logKernel(v); }, [](double v) { return logInRange(v); },
+               [](double v) { return std::log(v); });
+}
+
+void pow(const double* a, const double* b, double* out, size_t n) {
+    double buffer[CHUNK];
+    double exponent[CHUNK];
+    for (size_t base = 0; base < n; base += CHUNK) {
+        size_t count = min(CHUNK, n - base);
+        const double* x = a + base;
+        const double* y = b + base;
+        for (size_t i = 0; i < count; i++) {
+            double v = x[i];
+            buffer[i] = logInRange(v) ? v : 1.0;
+            exponent[i] = y[i];
+        }
+        for (size_t i = count; i < CHUNK; i++) { buffer[i] = 1.0; exponent[i] = 0.0; }
+        for (size_t i = 0; i < CHUNK; i++) exponent[i] *= logKernel(buffer[i]);    // b·ln a
+        for (size_t i = 0; i < CHUNK; i++) {
+            double w = exponent[i];
+            buffer[i] = fabs(w) <= EXP_LIMIT ? w : 0.0;
+        }
+        for (size_t i = 0; i < CHUNK; i++) buffer[i] = expKernel(buffer[i]);      // exp(b·ln a)
+        for (size_t i = 0; i < count; i++) {    // 定义域外退回标准库
+            double v = x[i], w = y[i];
+            bool fast = logInRange(v) && fabs(exponent[i]) <= EXP_LIMIT;
+            out[base + i] = fast ? buffer[i] : std::pow(v, w);
+        }
+    }
+}
+
+}  // namespace FastMath
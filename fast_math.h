@@ -0,0 +1,148 @@
+#ifndef FAST_MATH_H    // 防止头文件重复包含
+#define FAST_MATH_H    // 定义头文件宏
+
+#include <cstdint>    // 位操作
+#include <cstddef>    // size_t
+#include <cstring>    // memcpy
+#include <cfloat>     // DBL_MIN
+#include <cmath>      // 定义域外退回标准库
+using namespace std;  // 使用标准命名空间
+
+/*快速超越函数：用于可以容忍约 1e-9 相对误差的场合（PrecisionMode::FAST），默认仍用标准库（EXACT）。
+核函数只用乘加、除法和位操作，没有分支和查表，批量版本的循环（定长分块）在 -O2 下即可被编译器向量化；
+定义域外的少数元素（参数过大、非正、非有限等）在第二遍中退回标准库逐个计算。
+误差上界（benchmark.cpp 在随机输入上实测，均远小于 1e-9）：
+  sin / cos：|x| <= 1e6 时绝对误差 <= 3e-16；在零点附近按绝对误差计
+  tan：      |x| <= 1e6 时相对误差 <= 5e-16（远离极点时）
+  log：      正规正数上相对误差 <= 4e-16
+  pow：      a > 0 且 |b·ln a| <= 708 时相对误差 <= 1e-13（主要来自 b·ln a 的舍入被 exp 放大）
+  整数指数的 pow 不再保证精确（如 2^10 可能是 1023.9999999999998）。
+标量的 log / pow 并不比标准库快（glibc 的实现本身很快），只有批量版本才有收益。*/
+
+enum class PrecisionMode {    // 超越函数精度模式
+    EXACT,                    // 标准库（默认）
+    FAST                      // 多项式近似，见 fast_math.h 中的误差上界
+};
+
+namespace FastMath {
+
+constexpr double ROUND_MAGIC = 6755399441055744.0;    // 1.5 * 2^52，加上后再减去即得最近整数，低位即为整数值
+constexpr double TRIG_LIMIT = 1e6;                    // sin / cos / tan 快速路径的参数范围
+constexpr double EXP_LIMIT = 708.0;                   // exp 快速路径的参数范围
+
+inline uint64_t toBits(double x) { uint64_t bits; memcpy(&bits, &x, sizeof(bits)); return bits; }
+inline double fromBits(uint64_t bits) { double x; memcpy(&x, &bits, sizeof(x)); return x; }
+
+struct Reduced {    // 三角函数参数约减结果：x = k·π/2 + r，|r| <= π/4
+    double r;
+    uint64_t quadrant;    // k mod 4
+};
+
+inline Reduced reduce(double x) {    // Cody-Waite 三段约减（π/2 的前两段各 33 位，k < 2^20 时乘积精确）
+    const double TWO_OVER_PI = 6.36619772367581382433e-01;
+    const double PIO2_1 = 1.57079632673412561417e+00;
+    const double PIO2_2 = 6.07710050630396597660e-11;
+    const double PIO2_3 = 2.02226624871116645580e-21;
+    double t = x * TWO_OVER_PI + ROUND_MAGIC;
+    double k = t - ROUND_MAGIC;
+    Reduced result;
+    result.r = ((x - k * PIO2_1) - k * PIO2_2) - k * PIO2_3;
+    result.quadrant = toBits(t) & 3;
+    return result;
+}
+
+inline double sinPoly(double r) {    // |r| <= π/4 上的 sin，泰勒展开到 r^15
+    double s = r * r;
+    return r + r * s * (-1.0 / 6 + s * (1.0 / 120 + s * (-1.0 / 5040 + s * (1.0 / 362880
+        + s * (-1.0 / 39916800 + s * (1.0 / 6227020800 + s * (-1.0 / 1307674368000)))))));
+}
+
+inline double cosPoly(double r) {    // |r| <= π/4 上的 cos，泰勒展开到 r^16
+    double s = r * r;
+    return 1.0 + s * (-0.5 + s * (1.0 / 24 + s * (-1.0 / 720 + s * (1.0 / 40320 + s * (-1.0 / 3628800
+        + s * (1.0 / 479001600 + s * (-1.0 / 87178291200 + s * (1.0 / 20922789888000))))))));
+}
+
+// 位操作的选择与取反：整数掩码运算可以向量化，按整数条件选择 double 的三元表达式则不行
+inline double selectBits(uint64_t mask, double a, double b) { return fromBits((toBits(a) & mask) | (toBits(b) & ~mask)); }  // mask 全 1 取 a
+inline double flipSign(double x, uint64_t signBit) { return fromBits(toBits(x) ^ signBit); }
+
+inline double sinKernel(double x) {    // 要求 |x| <= TRIG_LIMIT
+    Reduced red = reduce(x);
+    double s = sinPoly(red.r), c = cosPoly(red.r);
+    uint64_t q = red.quadrant;
+    return flipSign(selectBits(0 - (q & 1), c, s), (q & 2) << 62);
+}
+
+inline double cosKernel(double x) {    // 要求 |x| <= TRIG_LIMIT
+    Reduced red = reduce(x);
+    double s = sinPoly(red.r), c = cosPoly(red.r);
+    uint64_t q = red.quadrant;
+    return flipSign(selectBits(0 - (q & 1), s, c), ((q + 1) & 2) << 62);
+}
+
+inline double tanKernel(double x) {    // 要求 |x| <= TRIG_LIMIT；奇数象限为 -cos/sin
+    Reduced red = reduce(x);
+    double s = sinPoly(red.r), c = cosPoly(red.r);
+    uint64_t q = red.quadrant;
+    uint64_t odd = 0 - (q & 1);
+    return flipSign(selectBits(odd, c, s) / selectBits(odd, s, c), (q & 1) << 63);
+}
+
+inline double logKernel(double x) {    // 要求 x 为正规正数：x = m·2^k，m ∈ [√2/2, √2)，ln m = 2·atanh((m-1)/(m+1))
+    const double LN2_HI = 6.93147180369123816490e-01;
+    const double LN2_LO = 1.90821492927058770002e-10;
+    const uint64_t OFFSET = 0x3FE6A09E667F3BCDull;    // √2/2 的位模式
+    uint64_t bits = toBits(x);
+    uint64_t shifted = bits - OFFSET;
+    int64_t k = static_cast<int64_t>(shifted) >> 52;
+    double m = fromBits(bits - (shifted & 0xFFF0000000000000ull));
+    double e = fromBits(toBits(ROUND_MAGIC) + static_cast<uint64_t>(k)) - ROUND_MAGIC;    // k 转 double，不用不可向量化的整数转换
+    double f = (m - 1.0) / (m + 1.0);
+    double s = f * f;
+    double series = s * (1.0 / 3 + s * (1.0 / 5 + s * (1.0 / 7 + s * (1.0 / 9 + s * (1.0 / 11
+        + s * (1.0 / 13 + s * (1.0 / 15 + s * (1.0 / 17 + s * (1.0 / 19)))))))));
+    double logm = 2.0 * f + 2.0 * f * series;
+    return e * LN2_HI + (logm + e * LN2_LO);
+}
+
+inline double expKernel(double x) {    // 要求 |x| <= EXP_LIMIT：x = n·ln2 + r，|r| <= ln2/2
+    const double LOG2E = 1.44269504088896338700;
+    const double LN2_HI = 6.93147180369123816490e-01;
+    const double LN2_LO = 1.90821492927058770002e-10;
+    double t = x * LOG2E + ROUND_MAGIC;
+    double n = t - ROUND_MAGIC;
+    double r = (x - n * LN2_HI) - n * LN2_LO;
+    double p = 1.0 + r * (1.0 + r * (1.0 / 2 + r * (1.0 / 6 + r * (1.0 / 24 + r * (1.0 / 120 + r * (1.0 / 720
+        + r * (1.0 / 5040 + r * (1.0 / 40320 + r * (1.0 / 362880 + r * (1.0 / 3628800
+        + r * (1.0 / 39916800 + r * (1.0 / 479001600 + r * (1.0 / 6227020800)))))))))))));
+    uint64_t scale = (toBits(t) + 1023) << 52;    // 2^n
+    return p * fromBits(scale);
+}
+
+// 快速路径的适用条件，不满足时退回标准库
+inline bool trigInRange(double x) { return fabs(x) <= TRIG_LIMIT; }
+inline bool logInRange(double x) { return x >= DBL_MIN && x <= DBL_MAX; }
+inline bool powInRange(double a, double y) { return logInRange(a) && fabs(y) <= EXP_LIMIT; }    // y = b·ln a
+
+inline double sin(double x) { return trigInRange(x) ? sinKernel(x) : std::sin(x); }
+inline double cos(double x) { return trigInRange(x) ? cosKernel(x) : std::cos(x); }
+inline double tan(double x) { return trigInRange(x) ? tanKernel(x) : std::tan(x); }
+inline double log(double x) { return logInRange(x) ? logKernel(x) : std::log(x); }
+inline double exp(double x) { return fabs(x) <= EXP_LIMIT ? expKernel(x) : std::exp(x); }
+inline double pow(double a, double b) {
+    if (!logInRange(a)) return std::pow(a, b);
+    double y = b * logKernel(a);
+    return fabs(y) <= EXP_LIMIT ? expKernel(y) : std::pow(a, b);
+}
+
+// 批量版本：out[i] = f(x[i])，out 可以与输入相同
+void sin(const double* x, double* out, size_t n);
+void cos(const double* x, double* out, size_t n);
+void tan(const double* x, double* out, size_t n);
+void log(const double* x, double* out, size_t n);
+void pow(const double* a, const double* b, double* out, size_t n);
+
+}  // namespace FastMath
+
+#endif // FAST_MATH_H    // 结束头文件保护
@@ -0,0 +1,232 @@
+#include "formula_graph.h"    // 包含公式依赖图头文件
+#include "error_type.h"       // 错误类型
+#include "expression_simplifier.h"    // 化简与强度削减
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <memory>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t NONE = static_cast<size_t>(-1);    // 无公式 / 无输入
+
+struct Binding {          // 公式中一个变量的来源
+    size_t formula;       // 引用的公式下标，NONE 表示不是公式
+    size_t input;         // 输入下标，NONE 表示从未设置过的名称
+};
+
+}  // namespace
+
+struct FormulaPlan {                      // 缓存的依赖关系
+    vector<string> names;                        // 按名称排序的公式名
+    vector<const CompiledExpression*> exprs;     // 对应的公式
+    vector<vector<Binding>> bindings;            // 每个公式每个变量的来源
+    vector<vector<size_t>> dependents;           // 引用该公式的公式
+    vector<size_t> references;                   // 每个公式引用的公式数
+    vector<size_t> roots;                        // 不引用其他公式的公式
+};
+
+namespace {
+
+struct Schedule {                                // 一次 evaluate 的调度状态
+    const FormulaPlan* plan;              // 依赖关系
+    const vector<double>* inputValues;           // 输入取值
+    const vector<char>* inputBound;              // 输入是否已设置
+    unique_ptr<atomic<size_t>[]> remaining;      // 尚未完成的被引用公式数
+    vector<EvaluationResult> results;            // 结果
+    atomic<size_t> finished{0};                  // 已完成的公式数
+};
+
+void evaluateFormula(Schedule& schedule, size_t index) {    // 求值单个公式（被引用的公式都已完成）
+    const CompiledExpression& expr = *schedule.plan->exprs[index];
+    const vector<Binding>& bindings = schedule.plan->bindings[index];
+    EvaluationResult& result = schedule.results[index];
+    vector<double> values(bindings.size());
+    for (size_t i = 0; i < bindings.size(); i++) {
+        const Binding& binding = bindings[i];
+        if (binding.formula != NONE) {
+            const EvaluationResult& referenced = schedule.results[binding.formula];
+            if (!referenced.ok()) {    // 引用的公式出错
+                result.error = referenced.error;
+                result.message = referenced.message;
+                return;
+            }
+            values[i] = referenced.value;
+        } else if (binding.input != NONE && (*schedule.inputBound)[binding.input]) {
+            values[i] = (*schedule.inputValues)[binding.input];
+        } else {
+            result.error = INVALID_EXPRESSION;
+            result.message = "变量未赋值 (Unbound variable): " + expr.getVariables()[i];
+            return;
+        }
+    }
+    try {
+        result.value = expr.evaluate(values);
+    } catch (const EvaluationError& e) {
+        result.error = e.getType();
+        result.message = e.what();
+    }
+}
+
+void runFormula(Schedule& schedule, WorkStealingPool& pool, size_t index) {    // 求值公式并释放依赖它的公式
+    while (true) {
+        evaluateFormula(schedule, index);
+        size_t next = NONE;
+        for (size_t dependent : schedule.plan->dependents[index]) {
+            if (schedule.remaining[dependent].fetch_sub(1, memory_order_acq_rel) != 1) continue;
+            if (next != NONE) pool.submit([&schedule, &pool, next] { runFormula(schedule, pool, next); });
+            next = dependent;    // 最后一个就绪的公式在当前线程继续算
+        }
+        schedule.finished.fetch_add(1, memory_order_release);
+        if (next == NONE) return;
+        index = next;
+    }
+}
+
+bool isValidName(const string& name) {    // 公式名须为标识符，且不能是函数名或常量名
+    if (name.empty() || !(isalpha(static_cast<unsigned char>(name[0])) || name[0] == '_')) return false;
+    for (char c : name) {
+        if (!(isalnum(static_cast<unsigned char>(c)) || c == '_')) return false;
+    }
+    char func;
+    double value;
+    return !ExpressionCompiler::isFunctionName(name, func) && !ExpressionCompiler::isConstantName(name, value);
+}
+
+}  // namespace
+
+FormulaGraph::FormulaGraph(size_t threads) : pool(threads) {}
+
+FormulaGraph::~FormulaGraph() = default;
+
+bool FormulaGraph::findPath(const string& from, const string& to, vector<string>& path) const {    // 沿引用深度优先查找
+    unordered_map<string, string> parent;    // 搜索树中的父结点，兼作已访问集合
+    vector<string> stack = {from};
+    parent[from] = "";
+    while (!stack.empty()) {
+        string current = stack.back();
+        stack.pop_back();
+        if (current == to) {
+            for (string node = to; !node.empty(); node = parent[node]) path.push_back(node);
+            reverse(path.begin(), path.end());
+            return true;
+        }
+        auto formula = formulas.find(current);
+        if (formula == formulas.end()) continue;    // 输入
+        for (const string& next : formula->second.getVariables()) {
+            if (parent.count(next)) continue;
+            parent[next] = current;
+            stack.push_back(next);
+        }
+    }
+    return false;
+}
+
+void FormulaGraph::countReferences(const CompiledExpression& expr, bool add) {    // 更新引用计数
+    for (const string& reference : expr.getVariables()) {
+        if (add) {
+            referenceCount[reference]++;
+        } else if (--referenceCount[reference] == 0) {
+            referenceCount.erase(reference);
+        }
+    }
+}
+
+void FormulaGraph::define(const string& name, const string& infix) {    // 定义或替换公式
+    define(name, ExpressionCompiler::compileInfix(infix));
+}
+
+void FormulaGraph::define(const string& name, const CompiledExpression& expr) {    // 定义或替换已编译的公式
+    if (!isValidName(name)) throw EvaluationError(INVALID_EXPRESSION, "无效的公式名 (Invalid formula name): " + name);
+    if (!expr.isComplete()) throw EvaluationError(INVALID_EXPRESSION, "表达式不完整 (Incomplete expression)");
+    bool referenced = referenceCount.count(name) > 0;    // 成环必然经过某个引用 name 的公式
+    for (const string& reference : expr.getVariables()) {
+        vector<string> path;
+        if (reference != name && (!referenced || !findPath(reference, name, path))) continue;
+        string cycle = name;
+        for (const string& node : path) cycle += " -> " + node;
+        if (path.empty()) cycle += " -> " + name;    // 自引用
+        throw EvaluationError(INVALID_EXPRESSION, "公式循环引用 (Circular reference): " + cycle);
+    }
+    remove(name);
+    auto stored = formulas.emplace(name, ExpressionSimplifier::simplify(expr)).first;    // 每次 evaluate 都要重算，定义时化简一次
+    countReferences(stored->second, true);    // 与 remove 计数同一个（化简后的）表达式
+    plan.reset();
+}
+
+bool FormulaGraph::remove(const string& name) {    // 删除公式，引用它的公式之后视其为未赋值的输入
+    auto formula = formulas.find(name);
+    if (formula == formulas.end()) return false;
+    countReferences(formula->second, false);
+    formulas.erase(formula);
+    plan.reset();
+    return true;
+}
+
+void FormulaGraph::setInput(const string& name, double value) {    // 设置输入值
+    if (formulas.count(name)) throw EvaluationError(INVALID_EXPRESSION, "名称已被公式使用 (Name is defined as a formula): " + name);
+    auto slot = inputSlots.find(name);
+    if (slot == inputSlots.end()) {    // 新的输入名：引用它的公式需要重新绑定
+        slot = inputSlots.emplace(name, inputValues.size()).first;
+        inputValues.push_back(0.0);
+        inputBound.push_back(0);
+        plan.reset();
+    }
+    inputValues[slot->second] = value;
+    inputBound[slot->second] = 1;
+}
+
+void FormulaGraph::buildPlan() {    // 重建依赖关系
+    plan.reset(new FormulaPlan());
+    for (const auto& formula : formulas) plan->names.push_back(formula.first);
+    sort(plan->names.begin(), plan->names.end());
+    size_t count = plan->names.size();
+    unordered_map<string, size_t> indexOf;
+    for (size_t i = 0; i < count; i++) indexOf[plan->names[i]] = i;
+
+    plan->exprs.resize(count);
+    plan->bindings.resize(count);
+    plan->dependents.resize(count);
+    plan->references.assign(count, 0);
+    for (size_t i = 0; i < count; i++) {
+        const CompiledExpression& expr = formulas.at(plan->names[i]);
+        plan->exprs[i] = &expr;
+        for (const string& variable : expr.getVariables()) {    // 变量名互不相同，每个被引用公式只计一次
+            Binding binding = {NONE, NONE};
+            auto formula = indexOf.find(variable);
+            if (formula != indexOf.end()) {
+                binding.formula = formula->second;
+                plan->dependents[formula->second].push_back(i);
+                plan->references[i]++;
+            } else {
+                auto input = inputSlots.find(variable);
+                if (input != inputSlots.end()) binding.input = input->second;
+            }
+            plan->bindings[i].push_back(binding);
+        }
+        if (plan->references[i] == 0) plan->roots.push_back(i);
+    }
+}
+
+map<string, EvaluationResult> FormulaGraph::evaluate() {    // 按拓扑顺序并行求值
+    map<string, EvaluationResult> output;
+    if (formulas.empty()) return output;
+    if (!plan) buildPlan();
+
+    size_t count = plan->names.size();
+    Schedule schedule;
+    schedule.plan = plan.get();
+    schedule.inputValues = &inputValues;
+    schedule.inputBound = &inputBound;
+    schedule.remaining.reset(new atomic<size_t>[count]);
+    for (size_t i = 0; i < count; i++) schedule.remaining[i].store(plan->references[i], memory_order_relaxed);
+    schedule.results.resize(count);
+
+    for (size_t i : plan->roots) pool.submit([&schedule, this, i] { runFormula(schedule, pool, i); });
+    pool.helpUntil([&schedule, count] { return schedule.finished.load(memory_order_acquire) == count; });
+
+    for (size_t i = 0; i < count; i++) output.emplace_hint(output.end(), plan->names[i], schedule.results[i]);
+    return output;
+}
@@ -0,0 +1,53 @@
+#ifndef FORMULA_GRAPH_H    // 防止头文件重复包含
+#define FORMULA_GRAPH_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include "evaluation_service.h"     // EvaluationResult
+#include "work_stealing_pool.h"     // 工作窃取线程池
+#include <string>                   // 包含字符串处理
+#include <vector>                   // 包含向量容器
+#include <map>                      // 按名称排序的结果
+#include <unordered_map>            // 公式表与输入表
+#include <memory>                   // unique_ptr
+using namespace std;                // 使用标准命名空间
+
+/*具名公式集合：公式中的变量名如果是另一个公式的名字，就引用该公式的结果（如 margin = revenue - cost），
+否则取 setInput 设置的输入值。引用关系构成有向无环图，define 时检查并拒绝循环引用（包括自引用），
+因此引用的公式可以先使用、后定义。
+evaluate 按拓扑顺序在线程池上调度：没有未完成依赖的公式立即提交，一个公式算完后把依赖它的公式的计数减一，
+减到零的公式随即提交（最后一个就地继续算，省去一次提交），互不依赖的公式并行求值；
+每个公式每次 evaluate 只算一次，被多个公式引用的中间结果共享；公式在 define 时经 ExpressionSimplifier 化简（默认选项）。
+依赖关系（拓扑）在两次 evaluate 之间缓存，只有 define / remove 或出现新的输入名时才重建。
+引用的公式出错时，依赖它的公式以相同的错误类型失败。define / setInput 与 evaluate 不能并发调用。*/
+
+struct FormulaPlan;    // 缓存的依赖关系（定义见 formula_graph.cpp）
+
+class FormulaGraph {    // 具名公式的依赖图
+private:
+    unordered_map<string, CompiledExpression> formulas;    // 公式名到编译结果
+    unordered_map<string, size_t> inputSlots;              // 输入名到取值下标
+    vector<double> inputValues;                            // 输入取值
+    vector<char> inputBound;                               // 输入是否已设置
+    unordered_map<string, size_t> referenceCount;          // 每个名称被多少个公式引用（没有被引用的新公式不可能成环）
+    unique_ptr<FormulaPlan> plan;                          // 缓存的依赖关系，为空表示需要重建
+    WorkStealingPool pool;                                 // 线程池
+
+    bool findPath(const string& from, const string& to, vector<string>& path) const;    // 沿引用查找 from 到 to 的路径
+    void countReferences(const CompiledExpression& expr, bool add);                    // 更新引用计数
+    void buildPlan();                                                                  // 重建依赖关系
+
+public:
+    explicit FormulaGraph(size_t threads = 0);    // threads 为 0 时使用硬件线程数
+    ~FormulaGraph();
+
+    void define(const string& name, const string& infix);               // 定义或替换公式，循环引用时抛出 EvaluationError
+    void define(const string& name, const CompiledExpression& expr);    // 定义或替换已编译的公式
+    bool remove(const string& name);                                    // 删除公式
+    void setInput(const string& name, double value);                    // 设置输入值
+
+    map<string, EvaluationResult> evaluate();    // 按拓扑顺序并行求值全部公式
+    size_t size() const { return formulas.size(); }    // 公式数
+    bool contains(const string& name) const { return formulas.count(name) > 0; }    // 是否定义了该公式
+};
+
+#endif // FORMULA_GRAPH_H    // 结束头文件保护
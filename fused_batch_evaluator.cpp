@@ -0,0 +1,193 @@
+#include "fused_batch_evaluator.h"    // 包含融合批量求值器头文件
+#include "expression_simplifier.h"    // 公式化简
+#include "error_type.h"               // 错误类型
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+uint64_t bitsOf(double value) {    // double 的位模式（常数按位去重，0.0 与 -0.0 不合并）
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+}  // namespace
+
+FusedBatchEvaluator::FusedBatchEvaluator(PrecisionMode mode) : mode(mode), planned(false), registerCount(0) {}
+
+uint32_t FusedBatchEvaluator::variableId(const string& name) {    // 查找或新建变量
+    auto found = variableIds.find(name);
+    if (found != variableIds.end()) return found->second;
+    uint32_t id = static_cast<uint32_t>(variableNames.size());
+    variableNames.push_back(name);
+    variableIds[name] = id;
+    return id;
+}
+
+uint32_t FusedBatchEvaluator::intern(OpCode code, char op, uint64_t a, uint64_t b, double constant) {    // 查找或新建节点
+    if (code == OpCode::BINARY && (op == '+' || op == '*') && a > b) swap(a, b);    // 交换律：x + y 与 y + x 共用一个节点
+    NodeKey key = {static_cast<uint64_t>(code) | (static_cast<uint64_t>(static_cast<unsigned char>(op)) << 8), a, b};
+    auto found = interned.find(key);
+    if (found != interned.end()) return found->second;
+
+    uint32_t id = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({code, op, static_cast<uint32_t>(a), static_cast<uint32_t>(b), constant});
+    interned[key] = id;
+    return id;
+}
+
+size_t FusedBatchEvaluator::addFormula(const CompiledExpression& expr) {    // 加入公式
+    if (!expr.isComplete()) throw EvaluationError(INVALID_EXPRESSION, "表达式不完整 (Incomplete expression)");
+    const vector<double>& constants = expr.getConstants();
+    vector<uint32_t> variables;    // 公式内变量下标到本求值器变量下标
+    for (const string& name : expr.getVariables()) variables.push_back(variableId(name));
+
+    vector<uint32_t> stack;
+    stack.reserve(expr.getMaxStackDepth());
+    for (const Instruction& ins : expr.getCode()) {
+        switch (ins.code) {
+            case OpCode::PUSH_CONST: {
+                double constant = constants[ins.index];
+                stack.push_back(intern(OpCode::PUSH_CONST, 0, bitsOf(constant), 0, constant));
+                break;
+            }
+            case OpCode::LOAD_VAR:
+                stack.push_back(intern(OpCode::LOAD_VAR, 0, variables[ins.index], 0, 0.0));
+                break;
+            case OpCode::BINARY: {
+                uint32_t right = stack.back();
+                stack.pop_back();
+                stack.back() = intern(OpCode::BINARY, ins.op, stack.back(), right, 0.0);
+                break;
+            }
+            case OpCode::UNARY:
+                stack.back() = intern(OpCode::UNARY, ins.op, stack.back(), 0, 0.0);
+                break;
+        }
+    }
+    formulaRoots.push_back(stack[0]);
+    planned = false;
+    return formulaRoots.size() - 1;
+}
+
+size_t FusedBatchEvaluator::addFormula(const string& infix) {    // 编译、化简并加入中缀公式
+    return addFormula(ExpressionSimplifier::simplify(ExpressionCompiler::compileInfix(infix)));
+}
+
+/*节点按编号顺序执行（子节点编号总是小于父节点）。变量直接读输入列，不占寄存器；常数各占一个寄存器，
+每次求值前填好，整个求值期间不释放；其余节点在最后一次被使用后释放寄存器，
+左运算数在这里最后一次使用时结果直接写在它的寄存器里（按列运算都是原地的 a = a op b）。*/
+void FusedBatchEvaluator::plan() {    // 按存活区间分配寄存器，生成块内指令序列
+    uint32_t variableCount = static_cast<uint32_t>(variableNames.size());
+    vector<uint32_t> lastUse(nodes.size(), 0);    // 0 表示没有节点使用（节点 0 不可能使用别的节点）
+    for (uint32_t id = 0; id < nodes.size(); id++) {
+        const Node& node = nodes[id];
+        if (node.code == OpCode::BINARY || node.code == OpCode::UNARY) lastUse[node.left] = id;
+        if (node.code == OpCode::BINARY) lastUse[node.right] = id;
+    }
+    vector<pair<uint32_t, uint32_t>> roots;    // (根节点, 公式编号)，按根节点排序
+    for (uint32_t f = 0; f < formulaRoots.size(); f++) roots.push_back({formulaRoots[f], f});
+    sort(roots.begin(), roots.end());
+
+    steps.clear();
+    stepOutputs.clear();
+    directOutputs.clear();
+    constantRegisters.clear();
+    location.assign(nodes.size(), 0);
+    registerCount = 0;
+    vector<uint32_t> freeRegisters;
+    auto isTemporary = [&](uint32_t id) { return nodes[id].code == OpCode::BINARY || nodes[id].code == OpCode::UNARY; };
+    size_t nextRoot = 0;
+
+    for (uint32_t id = 0; id < nodes.size(); id++) {
+        const Node& node = nodes[id];
+        size_t rootsBegin = nextRoot;
+        while (nextRoot < roots.size() && roots[nextRoot].first == id) nextRoot++;
+        if (node.code == OpCode::LOAD_VAR || node.code == OpCode::PUSH_CONST) {
+            if (node.code == OpCode::LOAD_VAR) {
+                location[id] = node.left;
+            } else {
+                location[id] = variableCount + static_cast<uint32_t>(registerCount++);
+                constantRegisters.push_back(id);
+            }
+            for (size_t r = rootsBegin; r < nextRoot; r++) directOutputs.push_back(roots[r].second);
+            continue;
+        }
+
+        uint32_t target;
+        if (isTemporary(node.left) && lastUse[node.left] == id) {
+            target = location[node.left];
+        } else if (!freeRegisters.empty()) {
+            target = freeRegisters.back();
+            freeRegisters.pop_back();
+        } else {
+            target = variableCount + static_cast<uint32_t>(registerCount++);
+        }
+        location[id] = target;
+        Step step = {node.code, node.op, target, location[node.left], node.code == OpCode::BINARY ? location[node.right] : 0,
+                     static_cast<uint32_t>(stepOutputs.size()), 0};
+        for (size_t r = rootsBegin; r < nextRoot; r++) stepOutputs.push_back(roots[r].second);
+        step.outputEnd = static_cast<uint32_t>(stepOutputs.size());
+        steps.push_back(step);
+
+        uint32_t operands[2] = {node.left, node.code == OpCode::BINARY ? node.right : node.left};
+        for (int k = 0; k < 2; k++) {
+            uint32_t operand = operands[k];
+            if (k == 1 && operand == operands[0]) break;
+            if (isTemporary(operand) && lastUse[operand] == id && location[operand] != target) freeRegisters.push_back(location[operand]);
+        }
+        if (lastUse[id] == 0) freeRegisters.push_back(target);    // 只作为公式结果，写出后即可复用
+    }
+    planned = true;
+}
+
+size_t FusedBatchEvaluator::getRegisterCount() {    // 块内寄存器数
+    if (!planned) plan();
+    return registerCount;
+}
+
+void FusedBatchEvaluator::evaluate(const vector<const double*>& columns, size_t rows, const vector<double*>& outputs) {    // 分块融合求值
+    if (columns.size() < variableNames.size()) throw EvaluationError(INVALID_EXPRESSION, "变量取值不足 (Missing variable values)");
+    if (outputs.size() < formulaRoots.size()) throw EvaluationError(INVALID_EXPRESSION, "输出列不足 (Missing output columns)");
+    if (rows == 0 || formulaRoots.empty()) return;
+    if (!planned) plan();
+
+    size_t variableCount = variableNames.size();
+    registers.resize(registerCount * TILE_ROWS);
+    vector<const double*> source(variableCount + registerCount);    // 位置到本块数据
+    for (size_t r = 0; r < registerCount; r++) source[variableCount + r] = registers.data() + r * TILE_ROWS;
+    for (uint32_t id : constantRegisters) {
+        double* column = registers.data() + (location[id] - variableCount) * TILE_ROWS;
+        fill_n(column, TILE_ROWS, nodes[id].constant);
+    }
+
+    for (size_t base = 0; base < rows; base += TILE_ROWS) {
+        size_t count = min(TILE_ROWS, rows - base);
+        for (size_t v = 0; v < variableCount; v++) source[v] = columns[v] + base;
+        for (uint32_t f : directOutputs) copy_n(source[location[formulaRoots[f]]], count, outputs[f] + base);
+        for (const Step& step : steps) {
+            double* target = registers.data() + (step.target - variableCount) * TILE_ROWS;
+            if (source[step.left] != target) copy_n(source[step.left], count, target);
+            if (step.code == OpCode::BINARY) BatchEvaluator::binaryColumn(target, source[step.right], count, step.op, mode);
+            else BatchEvaluator::unaryColumn(target, count, step.op, mode);
+            for (uint32_t k = step.outputBegin; k < step.outputEnd; k++) copy_n(target, count, outputs[stepOutputs[k]] + base);
+        }
+    }
+}
+
+vector<vector<double>> FusedBatchEvaluator::evaluate(const vector<vector<double>>& columns) {    // 分块融合求值
+    size_t rows = columns.empty() ? 1 : columns[0].size();
+    vector<const double*> pointers;
+    for (const vector<double>& column : columns) {
+        if (column.size() != rows) throw EvaluationError(INVALID_EXPRESSION, "各变量的取值列长度不一致 (Column lengths differ)");
+        pointers.push_back(column.data());
+    }
+    vector<vector<double>> results(formulaRoots.size(), vector<double>(rows));
+    vector<double*> outputs;
+    for (vector<double>& result : results) outputs.push_back(result.data());
+    evaluate(pointers, rows, outputs);
+    return results;
+}
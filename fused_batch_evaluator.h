@@ -0,0 +1,98 @@
+#ifndef FUSED_BATCH_EVALUATOR_H    // 防止头文件重复包含
+#define FUSED_BATCH_EVALUATOR_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include "batch_evaluator.h"        // 按列运算与块大小
+#include <string>                   // 包含字符串处理
+#include <vector>                   // 包含向量容器
+#include <unordered_map>            // 节点去重与变量表
+#include <cstdint>                  // 定长整数类型
+using namespace std;                // 使用标准命名空间
+
+/*多个公式在同一批行上融合求值：所有公式合并成一个程序，相同的子表达式（同一常数、同一变量、
+相同运算和相同子节点，+ 和 * 不区分左右）只算一次；按 TILE_ROWS 行分块，每块输入只从内存读一次，
+在这一块上依次执行整个程序，中间结果放在按块大小分配的寄存器里，寄存器按存活区间复用，
+公式的结果一算出就写到输出，所以工作区大小只取决于同时存活的中间结果数，与行数无关。
+每个公式单独用 BatchEvaluator 求值时，每个公式都要把输入列从内存读一遍，公式之间相同的子表达式也要各算一次。
+任意一行出错时整批抛出 EvaluationError（与 BatchEvaluator 相同），已写出的部分结果无效。
+不是线程安全的，多线程使用时每个线程一个实例。*/
+
+class FusedBatchEvaluator {    // 多公式融合批量求值器
+public:
+    static constexpr size_t TILE_ROWS = BatchEvaluator::TILE_ROWS;    // 每块行数（每个寄存器 4 KB）
+
+private:
+    struct Node {          // 程序中的一个值
+        OpCode code;       // 操作码
+        char op;           // 运算符（BINARY / UNARY）
+        uint32_t left;     // 左子节点（BINARY）或唯一子节点（UNARY）；LOAD_VAR 时为变量下标
+        uint32_t right;    // 右子节点（BINARY）
+        double constant;   // 常数（PUSH_CONST）
+    };
+
+    struct NodeKey {    // 节点去重键
+        uint64_t head;  // 操作码、运算符
+        uint64_t a;     // 常数的位模式、变量下标或左子节点
+        uint64_t b;     // 右子节点
+        bool operator==(const NodeKey& other) const { return head == other.head && a == other.a && b == other.b; }
+    };
+
+    struct NodeKeyHash {
+        size_t operator()(const NodeKey& key) const {
+            uint64_t h = key.head * 0x9E3779B97F4A7C15ull;
+            h = (h ^ key.a) * 0xBF58476D1CE4E5B9ull;
+            h = (h ^ key.b) * 0x94D049BB133111EBull;
+            return static_cast<size_t>(h ^ (h >> 31));
+        }
+    };
+
+    struct Step {               // 一条块内指令：target = left op right
+        OpCode code;            // BINARY / UNARY
+        char op;                // 运算符
+        uint32_t target;        // 结果寄存器
+        uint32_t left;          // 左运算数所在位置（见 location）
+        uint32_t right;         // 右运算数所在位置
+        uint32_t outputBegin;   // 以本结果为值的公式在 stepOutputs 中的范围
+        uint32_t outputEnd;
+    };
+
+    vector<Node> nodes;                                      // 所有节点（子节点在前）
+    unordered_map<NodeKey, uint32_t, NodeKeyHash> interned;  // 节点去重表
+    vector<string> variableNames;                            // 变量名
+    unordered_map<string, uint32_t> variableIds;             // 变量名到下标
+    vector<uint32_t> formulaRoots;                           // 每个公式的根节点
+    PrecisionMode mode;                                      // 精度模式
+
+    bool planned;                                            // 执行计划是否最新
+    vector<Step> steps;                                      // 块内指令序列
+    vector<uint32_t> stepOutputs;                            // 各指令写出的公式编号
+    vector<uint32_t> directOutputs;                          // 根是变量或常数的公式
+    vector<uint32_t> location;                               // 节点值所在位置：变量下标，或 variableNames.size() + 寄存器号
+    vector<uint32_t> constantRegisters;                      // 常数节点（每次求值前填满一块）
+    size_t registerCount;                                    // 寄存器数
+    vector<double> registers;                                // 寄存器，每个 TILE_ROWS 行
+
+    uint32_t variableId(const string& name);                 // 查找或新建变量
+    uint32_t intern(OpCode code, char op, uint64_t a, uint64_t b, double constant);    // 查找或新建节点
+    void plan();                                             // 按存活区间分配寄存器，生成块内指令序列
+
+public:
+    explicit FusedBatchEvaluator(PrecisionMode mode = PrecisionMode::EXACT);    // 构造函数
+
+    size_t addFormula(const CompiledExpression& expr);    // 加入公式，返回公式编号
+    size_t addFormula(const string& infix);               // 编译、化简并加入中缀公式
+
+    // columns[v] 指向第 v 个变量（getVariables() 的顺序）的 rows 个取值，outputs[f] 接收第 f 个公式的 rows 个结果
+    void evaluate(const vector<const double*>& columns, size_t rows, const vector<double*>& outputs);
+    // columns[v] 为第 v 个变量的取值列，各列等长（没有变量时按 1 行求值），返回每个公式的结果列
+    vector<vector<double>> evaluate(const vector<vector<double>>& columns);
+
+    const vector<string>& getVariables() const { return variableNames; }    // 变量名（决定输入列的顺序）
+    size_t formulaCount() const { return formulaRoots.size(); }             // 公式数
+    size_t nodeCount() const { return nodes.size(); }                       // 去重后的节点数
+    size_t getRegisterCount();                                              // 块内寄存器数（工作区为其乘以 TILE_ROWS 个 double）
+    PrecisionMode getMode() const { return mode; }                          // 获取精度模式
+    void setMode(PrecisionMode newMode) { mode = newMode; }                 // 设置精度模式
+};
+
+#endif // FUSED_BATCH_EVALUATOR_H    // 结束头文件保护
@@ -0,0 +1,292 @@
+/*差分测试与模糊测试入口：
+对每个生成的中缀表达式，比较以下几条求值路径的结果（允许相对误差 1e-9）：
+  infix     InfixEvaluator 求值（Pratt 编译后在数字栈上逐条执行 double 运算，不走整数快速路径）
+  postfix   Utils::infixToPostfix（调度场算法，与 Pratt 解析器相互独立）转换后由 PostfixEvaluator 求值
+  prefix    Utils::infixToPrefix（同上）转换后由 PrefixEvaluator 求值
+  compiled  ExpressionCompiler 编译后求值
+两条路径都报错视为一致；一条报错而另一条得到 inf / NaN 也视为一致（除零的处理方式不同）。
+ExpressionSimplifier 用一组固定用例（负零、出错的常数子表达式、超过 2^53 的整数）在多个变量取值下
+比较化简前后的结果，必须逐位相同（NaN 只要求同为 NaN），出错时错误信息也必须相同。
+另外用随机括号串（多余的右括号、混合括号、非法字符）比较 Prescan 的 AVX2 实现与标量实现，结果的每个字段都必须相同。
+同时统计每条路径的吞吐量，任何求值器的性能改动都不能悄悄破坏正确性。
+
+普通编译：  g++ -std=c++17 -O2 -o fuzz_harness fuzz_harness.cpp expression_generator.cpp infix_evaluator.cpp
+                prefix_evaluator.cpp postfix_evaluator.cpp utils.cpp expression_compiler.cpp hardened_evaluator.cpp prescan.cpp expression_simplifier.cpp
+            ./fuzz_harness [表达式个数] [种子]
+libFuzzer： clang++ -std=c++17 -g -O1 -DEXPRESSION_LIBFUZZER -fsanitize=fuzzer,address,undefined（其余源文件同上）*/
+
+#include "expression_generator.h"    // 随机表达式生成器
+#include "infix_evaluator.h"         // 中缀表达式求值器
+#include "prefix_evaluator.h"        // 前缀表达式求值器
+#include "postfix_evaluator.h"       // 后缀表达式求值器
+#include "expression_compiler.h"     // 表达式编译器
+#include "hardened_evaluator.h"      // 加固求值器
+#include "expression_simplifier.h"   // 表达式化简器
+#include "utils.h"                   // 中缀转前缀 / 后缀
+#include "prescan.h"                 // 向量化预扫描
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <exception>
+#include <random>
+
+using namespace std;
+
+namespace {
+
+struct Outcome {    // 一条求值路径的结果
+    bool ok;        // 是否成功求值
+    double value;   // 结果
+    string error;   // 错误信息
+};
+
+template<typename F>
+Outcome run(F evaluate) {    // 执行一条求值路径，捕获所有异常
+    try {
+        return {true, evaluate(), ""};
+    } catch (const exception& e) {
+        return {false, 0, e.what()};
+    }
+}
+
+bool agree(const Outcome& a, const Outcome& b) {    // 两个结果是否一致
+    if (!a.ok && !b.ok) return true;
+    if (!a.ok || !b.ok) return !isfinite(a.ok ? a.value : b.value);
+    if (isnan(a.value) || isnan(b.value)) return isnan(a.value) && isnan(b.value);
+    if (a.value == b.value) return true;    // 包括同号的无穷大
+    double scale = max(1.0, max(fabs(a.value), fabs(b.value)));
+    return fabs(a.value - b.value) <= 1e-9 * scale;
+}
+
+string describe(const Outcome& o) {    // 结果的文字描述
+    if (!o.ok) return "错误 (error): " + o.error;
+    ostringstream out;
+    out << setprecision(17) << o.value;
+    return out.str();
+}
+
+bool samePrescan(const PrescanResult& a, const PrescanResult& b) {    // 两个预扫描结果是否完全相同
+    return a.illegalPos == b.illegalPos && a.mismatchPos == b.mismatchPos &&
+           a.openBrackets == b.openBrackets && a.maxDepth == b.maxDepth;
+}
+
+string describe(const PrescanResult& r) {    // 预扫描结果的文字描述
+    auto position = [](size_t p) { return p == PrescanResult::npos ? string("npos") : to_string(p); };
+    return "illegal " + position(r.illegalPos) + ", mismatch " + position(r.mismatchPos) +
+           ", open " + to_string(r.openBrackets) + ", maxDepth " + to_string(r.maxDepth);
+}
+
+// 比较 AVX2（CPU 支持时）与标量预扫描，不一致时把详情写入 report 并返回 false
+bool checkPrescan(const string& text, string& report) {
+    for (bool checkIllegal : {true, false}) {
+        PrescanResult fast = checkIllegal ? Prescan::scan(text) : Prescan::scanBrackets(text);
+        PrescanResult reference = Prescan::scanScalar(text, checkIllegal);
+        if (samePrescan(fast, reference)) continue;
+        report = "预扫描 (prescan" + string(checkIllegal ? "" : ", brackets only") + "): " + text + "\n" +
+                 "  fast:   " + describe(fast) + "\n  scalar: " + describe(reference) + "\n";
+        return false;
+    }
+    return true;
+}
+
+// 随机括号串：以单一种类的圆括号为主（走 AVX2 块内前缀和），左括号比例随串变化，
+// 深度有时很深、有时很快变负，夹杂其他种类的括号、非法字符和普通字符
+string randomBracketText(mt19937& rng) {
+    size_t length = rng() % 200;
+    uint32_t openPercent = 30 + rng() % 30;
+    string text;
+    for (size_t i = 0; i < length; i++) {
+        uint32_t r = rng() % 100;
+        if (r < openPercent) text += '(';
+        else if (r < 75) text += ')';
+        else if (r < 77) text += "[]{}"[rng() % 4];
+        else if (r < 78) text += '#';
+        else text += "1+ x"[rng() % 4];
+    }
+    return text;
+}
+
+// 化简的回归用例：常数折叠必须保留 -0、不折叠出错的子表达式，超过 2^53 的整数与求值时一样按 double 舍入
+const char* SIMPLIFIER_CASES[] = {
+    "(-0)^(-1) + x",                     // -inf + x
+    "l(x*(-0)^(-1))",                    // 对数参数为 -inf 或 NaN，必须照常报错
+    "(0*-1)^(-1) - x",                   // 0 * -1 = -0
+    "(-0 % 5)^(-1) * x",                 // fmod(-0, 5) = -0
+    "x - 0*(-3)",                        // x - (-0) 不能化简成 x
+    "x + 1/(2-2)",                       // 折叠时除零，留到求值时报错
+    "3^39 % 1000 + x",                   // 3^39 超过 2^53，各路径都按 double 舍入：256 + x
+    "(2^60 + 1) % 1000 + x",             // 976 + x
+    "2^53+1+1",                          // 2^53 + 1 舍入成 2^53，与原表达式同样按 double 计算
+    "2^53-1+2+1",
+    "-(2^53)-1-1",
+};
+const double SIMPLIFIER_VALUES[] = {0.0, -0.0, 1.0, -2.5, 7.0, INFINITY, -INFINITY, NAN};
+
+bool sameResult(const Outcome& a, const Outcome& b) {    // 逐位相同（NaN 只要求同为 NaN），或报同样的错
+    if (!a.ok || !b.ok) return !a.ok && !b.ok && a.error == b.error;
+    if (isnan(a.value) || isnan(b.value)) return isnan(a.value) && isnan(b.value);
+    return a.value == b.value && signbit(a.value) == signbit(b.value);
+}
+
+bool checkSimplifier(const string& expr, string& report) {    // 化简前后在各取值下的结果必须相同
+    CompiledExpression original = ExpressionCompiler::compileInfix(expr);
+    CompiledExpression simplified = ExpressionSimplifier::simplify(original);
+    for (double x : SIMPLIFIER_VALUES) {
+        vector<double> values(original.getVariables().size(), x);
+        Outcome a = run([&] { return original.evaluate(values); });
+        Outcome b = run([&] { return simplified.evaluate(values); });
+        if (sameResult(a, b)) continue;
+        ostringstream out;
+        out << "化简 (simplify): " << expr << ", x = " << x << "\n  original: " << describe(a) << "\n  simplified: " << describe(b) << "\n";
+        report = out.str();
+        return false;
+    }
+    return true;
+}
+
+enum Path { INFIX, POSTFIX, PREFIX, COMPILED, PATH_COUNT };    // 求值路径
+const char* PATH_NAMES[PATH_COUNT] = {"infix", "postfix", "prefix", "compiled"};
+
+class DifferentialTester {    // 差分测试器
+private:
+    InfixEvaluator infixEvaluator;
+    PrefixEvaluator prefixEvaluator;
+    PostfixEvaluator postfixEvaluator;
+
+public:
+    double seconds[PATH_COUNT] = {};    // 每条路径累计耗时
+    size_t expressions = 0;             // 已测试的表达式个数
+    size_t bytes = 0;                   // 已测试的表达式总字节数
+    size_t mismatches = 0;              // 不一致的个数
+
+    DifferentialTester() {
+        infixEvaluator.setVerbose(false);
+        prefixEvaluator.setVerbose(false);
+        postfixEvaluator.setVerbose(false);
+    }
+
+    // 比较各路径结果，不一致时把详情写入 report 并返回 false
+    bool check(const string& expr, string& report) {
+        Outcome results[PATH_COUNT];
+        for (int p = 0; p < PATH_COUNT; p++) {
+            auto start = chrono::steady_clock::now();
+            switch (p) {
+                case INFIX:    results[p] = run([&] { return infixEvaluator.evaluate(expr); }); break;
+                case POSTFIX:  results[p] = run([&] { return postfixEvaluator.evaluate(Utils::infixToPostfix(expr)); }); break;
+                case PREFIX:   results[p] = run([&] { return prefixEvaluator.evaluate(Utils::infixToPrefix(expr)); }); break;
+                case COMPILED: results[p] = run([&] { return ExpressionCompiler::compileInfix(expr).evaluate(); }); break;
+            }
+            seconds[p] += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        }
+        expressions++;
+        bytes += expr.size();
+
+        bool consistent = true;
+        for (int p = 1; p < PATH_COUNT; p++) {
+            if (!agree(results[INFIX], results[p])) consistent = false;
+        }
+        if (consistent) return true;
+        mismatches++;
+        report = "表达式 (expression): " + expr + "\n";
+        for (int p = 0; p < PATH_COUNT; p++) report += string("  ") + PATH_NAMES[p] + ": " + describe(results[p]) + "\n";
+        return false;
+    }
+
+    void printThroughput() const {    // 输出吞吐量
+        cout << left << setw(10) << "path" << right << setw(14) << "expr/s" << setw(12) << "MB/s" << endl;
+        for (int p = 0; p < PATH_COUNT; p++) {
+            double t = seconds[p] > 0 ? seconds[p] : 1e-9;
+            cout << left << setw(10) << PATH_NAMES[p] << right << fixed << setprecision(0)
+                 << setw(14) << expressions / t << setprecision(2) << setw(12) << bytes / t / 1e6 << endl;
+        }
+    }
+};
+
+}  // namespace
+
+#ifdef EXPRESSION_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static DifferentialTester tester;
+
+    // 1. 以字节驱动生成结构合法的表达式，做差分检查，不一致时中止让 libFuzzer 保存用例
+    GeneratorOptions options;
+    options.operators = "+-*/%^";
+    ExpressionGenerator generator(data, size, options);
+    string report;
+    if (!tester.check(generator.generate(), report)) {
+        cerr << report;
+        abort();
+    }
+
+    // 2. 原始字节直接作为中缀表达式，只要求不崩溃、不出现未定义行为
+    string raw(reinterpret_cast<const char*>(data), size);
+    try {
+        HardenedEvaluator().evaluate(raw);
+    } catch (const exception&) {
+    }
+    try {
+        InfixEvaluator infix;
+        infix.setVerbose(false);
+        HardenedEvaluator::checkLimits(raw, EvaluationLimits());
+        if (infix.validateExpression(raw)) infix.evaluate(raw);
+    } catch (const exception&) {
+    }
+
+    // 3. 原始字节的 AVX2 与标量预扫描必须完全一致
+    if (!checkPrescan(raw, report)) {
+        cerr << report;
+        abort();
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+    uint32_t seed = argc > 2 ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 12345;
+
+    GeneratorOptions options;
+    options.operators = "+-*/%^";
+    ExpressionGenerator generator(seed, options);
+    DifferentialTester tester;
+
+    const size_t maxReports = 10;    // 最多输出的不一致用例数
+    for (size_t i = 0; i < count; i++) {
+        string report;
+        if (!tester.check(generator.generate(), report) && tester.mismatches <= maxReports) cout << report;
+    }
+
+    cout << "表达式 (expressions): " << tester.expressions << ", 不一致 (mismatches): " << tester.mismatches
+         << ", 种子 (seed): " << seed << endl;
+    tester.printThroughput();
+
+    mt19937 rng(seed);
+    size_t prescanMismatches = 0;
+    for (size_t i = 0; i < count; i++) {
+        string report;
+        if (!checkPrescan(randomBracketText(rng), report) && ++prescanMismatches <= maxReports) cout << report;
+    }
+    size_t simplifierMismatches = 0;
+    for (const char* expr : SIMPLIFIER_CASES) {
+        string report;
+        if (!checkSimplifier(expr, report)) {
+            simplifierMismatches++;
+            cout << report;
+        }
+    }
+    cout << "化简 (simplifier): " << sizeof(SIMPLIFIER_CASES) / sizeof(SIMPLIFIER_CASES[0])
+         << ", 不一致 (mismatches): " << simplifierMismatches << endl;
+
+    cout << "预扫描 (prescan): " << count << (Prescan::hasAvx2() ? " AVX2 / scalar" : " (无 AVX2 / no AVX2)")
+         << ", 不一致 (mismatches): " << prescanMismatches << endl;
+    return tester.mismatches == 0 && simplifierMismatches == 0 && prescanMismatches == 0 ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,27 @@
+#include "hardened_evaluator.h"    // 包含加固求值器头文件
+
+using namespace std;
+
+HardenedEvaluator::HardenedEvaluator(const EvaluationLimits& limits) : limits(limits) {}
+
+/*预扫描在第一个非法字符或不匹配的右括号处停止，此时的最大深度只覆盖停止点之前的部分；
+之后的解析最迟在停止点报错，不会进入更深的嵌套，所以限制仍然成立。*/
+PrescanResult HardenedEvaluator::checkLimits(const string& expr, const EvaluationLimits& limits) {    // 长度与括号深度预扫描
+    if (limits.maxLength > 0 && expr.length() > limits.maxLength) {
+        throw EvaluationError(LIMIT_EXCEEDED, "表达式长度超出限制 (Expression length limit exceeded)");
+    }
+    PrescanResult scan = Prescan::scan(expr);
+    if (limits.maxDepth > 0 && scan.maxDepth > limits.maxDepth) {
+        throw EvaluationError(LIMIT_EXCEEDED, "嵌套深度超出限制 (Nesting depth limit exceeded)");
+    }
+    return scan;
+}
+
+CompiledExpression HardenedEvaluator::compile(const string& expr) const {    // 检查限制后编译
+    checkLimits(expr, limits);
+    return ExpressionCompiler::compileInfix(expr, limits.maxDepth);
+}
+
+double HardenedEvaluator::evaluate(const string& expr, const vector<double>& values) const {    // 编译并求值
+    return compile(expr).evaluate(values);
+}
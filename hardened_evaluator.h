@@ -0,0 +1,39 @@
+#ifndef HARDENED_EVALUATOR_H    // 防止头文件重复包含
+#define HARDENED_EVALUATOR_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include "error_type.h"             // 错误类型
+#include "prescan.h"                // 向量化预扫描
+#include <string>                   // 包含字符串处理
+#include <vector>                   // 包含向量容器
+using namespace std;                // 使用标准命名空间
+
+/*面向不可信输入的加固求值器：
+先做 O(1) 的长度检查和 O(n) 的向量化预扫描（字符分类、括号深度），再用带深度限制的编译器编译、用预分配栈求值。
+整个过程不递归，所有栈的容量都不超过 maxDepth，内存在开始前即可确定上界；
+超出限制时抛出 LIMIT_EXCEEDED 类型的 EvaluationError，而不是崩溃或未定义行为。*/
+
+struct EvaluationLimits {    // 求值限制
+    size_t maxLength;        // 表达式最大长度（字符数，0 表示不限）
+    size_t maxDepth;         // 最大嵌套深度：括号、一元负号、函数以及求值栈（0 表示不限）
+
+    EvaluationLimits(size_t length = 1 << 20, size_t depth = 1000) : maxLength(length), maxDepth(depth) {}
+};
+
+class HardenedEvaluator {    // 加固求值器
+private:
+    EvaluationLimits limits;    // 当前限制
+
+public:
+    explicit HardenedEvaluator(const EvaluationLimits& limits = EvaluationLimits());    // 构造函数
+
+    // O(n) 预扫描：检查长度与括号深度，返回预扫描结果供调用者提前报告非法字符和括号错误
+    static PrescanResult checkLimits(const string& expr, const EvaluationLimits& limits);
+    CompiledExpression compile(const string& expr) const;                           // 检查限制后编译中缀表达式
+    double evaluate(const string& expr, const vector<double>& values = vector<double>()) const;    // 编译并求值
+
+    const EvaluationLimits& getLimits() const { return limits; }    // 获取限制
+    void setLimits(const EvaluationLimits& newLimits) { limits = newLimits; }    // 设置限制
+};
+
+#endif // HARDENED_EVALUATOR_H    // 结束头文件保护
@@ -0,0 +1,188 @@
+#include "incremental_evaluator.h"    // 包含增量求值器头文件
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+uint64_t bitsOf(double value) {    // double 的位模式（常数去重和变化检测都按位比较，NaN 也能判等）
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+}  // namespace
+
+IncrementalEvaluator::IncrementalEvaluator() : recomputed(0) {}
+
+uint32_t IncrementalEvaluator::variableId(const string& name) {    // 查找或新建变量
+    auto found = variableIds.find(name);
+    if (found != variableIds.end()) return found->second;
+    uint32_t id = static_cast<uint32_t>(variableNames.size());
+    variableNames.push_back(name);
+    variableValues.push_back(0.0);
+    variableBound.push_back(false);
+    variableIds[name] = id;
+    variableNodes.push_back(intern(OpCode::LOAD_VAR, 0, id, 0, 0.0));
+    return id;
+}
+
+uint32_t IncrementalEvaluator::intern(OpCode code, char op, uint64_t a, uint64_t b, double constant) {    // 查找或新建节点
+    NodeKey key = {static_cast<uint64_t>(code) | (static_cast<uint64_t>(static_cast<unsigned char>(op)) << 8), a, b};
+    auto found = interned.find(key);
+    if (found != interned.end()) return found->second;
+
+    uint32_t id = static_cast<uint32_t>(nodes.size());
+    Node node;
+    node.code = code;
+    node.op = op;
+    node.left = static_cast<uint32_t>(a);
+    node.right = static_cast<uint32_t>(b);
+    node.value = constant;
+    node.error = NO_ERROR;
+    node.errorSource = 0;
+    node.queued = false;
+    nodes.push_back(node);
+    interned[key] = id;
+
+    if (code == OpCode::BINARY || code == OpCode::UNARY) {
+        nodes[node.left].parents.push_back(id);
+        if (code == OpCode::BINARY && node.right != node.left) nodes[node.right].parents.push_back(id);
+    }
+    if (code != OpCode::PUSH_CONST) compute(id);    // 子节点都已有缓存值
+    return id;
+}
+
+void IncrementalEvaluator::fail(Node& node, uint32_t id, ErrorType error, const string& message) {    // 记录节点自身产生的错误
+    node.error = error;
+    node.errorSource = id;
+    node.value = 0.0;
+    errorMessages[id] = message;
+}
+
+bool IncrementalEvaluator::compute(uint32_t id) {    // 重算节点，返回结果是否变化
+    Node& node = nodes[id];
+    uint64_t oldBits = bitsOf(node.value);
+    ErrorType oldError = node.error;
+    uint32_t oldSource = node.errorSource;
+    node.error = NO_ERROR;
+
+    if (node.code == OpCode::LOAD_VAR) {
+        if (variableBound[node.left]) {
+            node.value = variableValues[node.left];
+        } else {
+            fail(node, id, INVALID_EXPRESSION, "变量未赋值 (Unbound variable): " + variableNames[node.left]);
+        }
+    } else if (node.code == OpCode::UNARY || node.code == OpCode::BINARY) {
+        const Node& left = nodes[node.left];
+        const Node* failed = (left.error != NO_ERROR) ? &left : nullptr;
+        if (!failed && node.code == OpCode::BINARY && nodes[node.right].error != NO_ERROR) failed = &nodes[node.right];
+        if (failed) {    // 子节点出错：按求值顺序传递最先出现的错误
+            node.error = failed->error;
+            node.errorSource = failed->errorSource;
+            node.value = 0.0;
+        } else {
+            try {
+                node.value = (node.code == OpCode::UNARY)
+                    ? CompiledExpression::evaluateUnary(node.op, left.value)
+                    : CompiledExpression::evaluateOperation(left.value, nodes[node.right].value, node.op);
+            } catch (const EvaluationError& e) {
+                fail(node, id, e.getType(), e.what());
+            }
+        }
+    }
+
+    if (oldError != NO_ERROR && oldSource == id && (node.error == NO_ERROR || node.errorSource != id)) errorMessages.erase(id);    // 错误信息只保存在错误源节点
+    if (node.error != oldError) return true;
+    return node.error != NO_ERROR ? node.errorSource != oldSource : bitsOf(node.value) != oldBits;
+}
+
+void IncrementalEvaluator::enqueueParents(uint32_t id) {    // 把父节点加入待重算队列
+    for (uint32_t parent : nodes[id].parents) {
+        if (!nodes[parent].queued) {
+            nodes[parent].queued = true;
+            pending.push(parent);
+        }
+    }
+}
+
+size_t IncrementalEvaluator::addFormula(const CompiledExpression& expr) {    // 加入公式
+    if (!expr.isComplete()) throw EvaluationError(INVALID_EXPRESSION, "表达式不完整 (Incomplete expression)");
+    const vector<double>& constants = expr.getConstants();
+    vector<uint32_t> variables;    // 公式内变量下标到本求值器变量下标
+    for (const string& name : expr.getVariables()) variables.push_back(variableId(name));
+
+    vector<uint32_t> stack;
+    stack.reserve(expr.getMaxStackDepth());
+    for (const Instruction& ins : expr.getCode()) {
+        switch (ins.code) {
+            case OpCode::PUSH_CONST: {
+                double constant = constants[ins.index];
+                stack.push_back(intern(OpCode::PUSH_CONST, 0, bitsOf(constant), 0, constant));
+                break;
+            }
+            case OpCode::LOAD_VAR:
+                stack.push_back(variableNodes[variables[ins.index]]);
+                break;
+            case OpCode::BINARY: {
+                uint32_t right = stack.back();
+                stack.pop_back();
+                stack.back() = intern(OpCode::BINARY, ins.op, stack.back(), right, 0.0);
+                break;
+            }
+            case OpCode::UNARY:
+                stack.back() = intern(OpCode::UNARY, ins.op, stack.back(), 0, 0.0);
+                break;
+        }
+    }
+    formulaRoots.push_back(stack[0]);
+    return formulaRoots.size() - 1;
+}
+
+size_t IncrementalEvaluator::addFormula(const string& infix) {    // 编译并加入中缀公式
+    return addFormula(ExpressionCompiler::compileInfix(infix));
+}
+
+void IncrementalEvaluator::setVariable(const string& name, double value) {    // 修改变量
+    uint32_t id = variableId(name);
+    if (variableBound[id] && bitsOf(variableValues[id]) == bitsOf(value)) return;    // 没有变化
+    variableValues[id] = value;
+    variableBound[id] = true;
+    Node& node = nodes[variableNodes[id]];
+    if (!node.queued) {
+        node.queued = true;
+        pending.push(variableNodes[id]);
+    }
+}
+
+void IncrementalEvaluator::refresh() {    // 按编号从小到大重算，结果变化时才继续向上传播
+    recomputed = 0;
+    while (!pending.empty()) {
+        uint32_t id = pending.top();
+        pending.pop();
+        nodes[id].queued = false;
+        recomputed++;
+        if (compute(id)) enqueueParents(id);
+    }
+}
+
+EvaluationResult IncrementalEvaluator::result(size_t formula) {    // 公式当前结果
+    if (formula >= formulaRoots.size()) throw EvaluationError(INVALID_EXPRESSION, "公式编号超出范围 (Formula index out of range)");
+    if (!pending.empty()) refresh();
+    const Node& root = nodes[formulaRoots[formula]];
+    EvaluationResult result;
+    if (root.error == NO_ERROR) {
+        result.value = root.value;
+    } else {
+        result.error = root.error;
+        auto message = errorMessages.find(root.errorSource);
+        if (message != errorMessages.end()) result.message = message->second;
+    }
+    return result;
+}
+
+double IncrementalEvaluator::value(size_t formula) {    // 公式当前值
+    EvaluationResult current = result(formula);
+    if (!current.ok()) throw EvaluationError(current.error, current.message);
+    return current.value;
+}
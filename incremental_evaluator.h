@@ -0,0 +1,87 @@
+#ifndef INCREMENTAL_EVALUATOR_H    // 防止头文件重复包含
+#define INCREMENTAL_EVALUATOR_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include "evaluation_service.h"     // EvaluationResult
+#include "error_type.h"             // 错误类型
+#include <string>                   // 包含字符串处理
+#include <vector>                   // 包含向量容器
+#include <queue>                    // 待重算节点（按编号从小到大）
+#include <unordered_map>            // 节点去重与变量表
+#include <cstdint>                  // 定长整数类型
+using namespace std;                // 使用标准命名空间
+
+/*增量求值：许多公式共享输入、每次只改一个输入的场景（类似电子表格）。
+所有公式的指令序列合并成一张依赖图，每个节点缓存自己的中间结果；相同的子表达式（同一常数、同一变量、
+相同运算和相同子节点）只建一个节点，被多个公式共享。
+setVariable 只把读取该变量的节点的父节点加入待重算队列；刷新时按节点编号从小到大重算
+（子节点编号总是小于父节点，所以每个节点的输入都已是最新值），结果没有变化的节点不再向上传播。
+出错的节点（除零、对数参数非正等）记录错误类型，并像 NaN 一样传给依赖它的节点；变量未赋值也是一种错误。
+不是线程安全的，多线程使用时由调用者加锁。*/
+
+class IncrementalEvaluator {    // 增量求值器
+private:
+    struct Node {                    // 依赖图节点
+        OpCode code;                 // 操作码
+        char op;                     // 运算符（BINARY / UNARY）
+        uint32_t left;               // 左子节点（BINARY）或唯一子节点（UNARY）；LOAD_VAR 时为变量下标
+        uint32_t right;              // 右子节点（BINARY）
+        double value;                // 缓存的结果
+        ErrorType error;             // 缓存的错误（NO_ERROR 表示成功）
+        uint32_t errorSource;        // 错误最初产生的节点（用于取错误信息）
+        bool queued;                 // 是否已在待重算队列中
+        vector<uint32_t> parents;    // 依赖本节点的节点
+    };
+
+    struct NodeKey {    // 节点去重键
+        uint64_t head;  // 操作码、运算符
+        uint64_t a;     // 常数的位模式、变量下标或左子节点
+        uint64_t b;     // 右子节点
+        bool operator==(const NodeKey& other) const { return head == other.head && a == other.a && b == other.b; }
+    };
+
+    struct NodeKeyHash {
+        size_t operator()(const NodeKey& key) const {
+            uint64_t h = key.head * 0x9E3779B97F4A7C15ull;
+            h = (h ^ key.a) * 0xBF58476D1CE4E5B9ull;
+            h = (h ^ key.b) * 0x94D049BB133111EBull;
+            return static_cast<size_t>(h ^ (h >> 31));
+        }
+    };
+
+    vector<Node> nodes;                                      // 所有节点（子节点在前）
+    unordered_map<NodeKey, uint32_t, NodeKeyHash> interned;  // 节点去重表
+    unordered_map<uint32_t, string> errorMessages;           // 出错节点的错误信息
+    vector<string> variableNames;                            // 变量名
+    vector<double> variableValues;                           // 变量取值
+    vector<bool> variableBound;                              // 变量是否已赋值
+    vector<uint32_t> variableNodes;                          // 每个变量对应的节点
+    unordered_map<string, uint32_t> variableIds;             // 变量名到下标
+    vector<uint32_t> formulaRoots;                           // 每个公式的根节点
+    priority_queue<uint32_t, vector<uint32_t>, greater<uint32_t>> pending;    // 待重算节点，编号小的先算
+    size_t recomputed;                                       // 最近一次刷新重算的节点数
+
+    uint32_t variableId(const string& name);                 // 查找或新建变量
+    uint32_t intern(OpCode code, char op, uint64_t a, uint64_t b, double constant);    // 查找或新建节点
+    bool compute(uint32_t id);                               // 重算节点，返回结果是否变化
+    void enqueueParents(uint32_t id);                        // 把父节点加入待重算队列
+    void fail(Node& node, uint32_t id, ErrorType error, const string& message);    // 记录节点自身产生的错误
+
+public:
+    IncrementalEvaluator();    // 构造函数
+
+    size_t addFormula(const CompiledExpression& expr);    // 加入公式，返回公式编号
+    size_t addFormula(const string& infix);               // 编译并加入中缀公式
+
+    void setVariable(const string& name, double value);   // 修改变量，依赖它的节点在下次读取时重算
+    void refresh();                                       // 重算所有待重算节点
+
+    EvaluationResult result(size_t formula);              // 公式当前结果（必要时先刷新）
+    double value(size_t formula);                         // 公式当前值，出错时抛出 EvaluationError
+
+    size_t formulaCount() const { return formulaRoots.size(); }    // 公式数
+    size_t nodeCount() const { return nodes.size(); }              // 去重后的节点数
+    size_t lastRecomputed() const { return recomputed; }           // 最近一次刷新重算的节点数
+};
+
+#endif // INCREMENTAL_EVALUATOR_H    // 结束头文件保护
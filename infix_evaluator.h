@@ -1,26 +1,24 @@
 #ifndef INFIX_EVALUATOR_H    // 防止头文件重复包含
 #define INFIX_EVALUATOR_H    // 定义头文件宏
 
+#include "ExpressionEvaluator.h"    // 求值器框架（共享的工具方法）
+#include "hardened_evaluator.h"     // 默认嵌套深度限制
 #include <string>    // 包含字符串处理
-#include <stack>     // 包含栈数据结构
+#include <vector>    // 包含向量容器（作为栈的底层容器）
 using namespace std; // 使用标准命名空间
 
-class InfixEvaluator {    // 中缀表达式求值器类
+class InfixEvaluator : public ExpressionEvaluator<InfixEvaluator> {    // 中缀表达式求值器类（编译后在数字栈上执行）
 private:
-    stack<double> numberStack;     // 数字栈
-    stack<char> operatorStack;     // 运算符栈
-    
-    double evaluateOperation(double a, double b, char op) const;  // 执行运算操作
-    void displayStacks(const string& remainingExpr) const;  // 显示栈的状态
-    void displayStep(const string& remainingExpr, const string& operation);  // 显示求值步骤
-    int precedence(char op);       // 获取运算符优先级
-    bool isOperator(char c) const; // 判断是否为运算符
-    bool isNumber(char c) const;   // 判断是否为数字
-    bool isFunction(char c) const; // 判断是否为函数
+    size_t maxDepth = EvaluationLimits().maxDepth;    // 编译时的最大嵌套深度（0 表示不限）
+
+    double popNumber();            // 弹出数字，栈空时报错
 
 public:
     double evaluate(const string& expression);  // 求值中缀表达式
     bool validateExpression(const string& expr) const;  // 验证中缀表达式格式
+
+    void setMaxDepth(size_t depth) { maxDepth = depth; }    // 设置最大嵌套深度（括号、一元负号、函数以及求值栈）
+    size_t getMaxDepth() const { return maxDepth; }         // 获取最大嵌套深度
 };
 
 #endif // INFIX_EVALUATOR_H    // 结束头文件保护 
\ No newline at end of file
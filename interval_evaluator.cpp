@@ -0,0 +1,210 @@
+#include "interval_evaluator.h"    // 包含区间求值器头文件
+#include <cmath>
+#include <climits>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const double INF = numeric_limits<double>::infinity();
+const double PI = 3.14159265358979323846;
+
+// 向外舍入：下界向 -inf 移动 ulps 个 ulp，上界向 +inf 移动；NaN 视为无界
+double lower(double x, int ulps = 1) {
+    if (isnan(x)) return -INF;
+    for (int i = 0; i < ulps; i++) x = nextafter(x, -INF);
+    return x;
+}
+
+double upper(double x, int ulps = 1) {
+    if (isnan(x)) return INF;
+    for (int i = 0; i < ulps; i++) x = nextafter(x, INF);
+    return x;
+}
+
+const Interval ENTIRE = {-INF, INF};    // 整个实数轴
+
+// 若干端点值的包络（任何 NaN 都退化为整个实数轴）
+Interval hull(const double* values, int count, int ulps) {
+    double lo = INF, hi = -INF;
+    for (int i = 0; i < count; i++) {
+        if (isnan(values[i])) return ENTIRE;
+        lo = min(lo, values[i]);
+        hi = max(hi, values[i]);
+    }
+    return {lower(lo, ulps), upper(hi, ulps)};
+}
+
+// 端点乘法：0 * inf 取 0（区间端点为 0 时乘积确实为 0）
+double mulEndpoint(double x, double y) {
+    if (x == 0 || y == 0) return 0;
+    return x * y;
+}
+
+/*判断 [lo, hi] 是否可能包含 phase + k * period（k 为整数）。
+计算 k 时留出浮点误差余量，拿不准时返回 true，保证结果只会偏宽不会偏窄。*/
+bool mayContainPeriodicPoint(double lo, double hi, double phase, double period) {
+    if (!isfinite(lo) || !isfinite(hi)) return true;
+    if (hi - lo >= period) return true;
+    double scale = max(fabs(lo), fabs(hi));
+    if (scale > 1e15) return true;    // 参数过大，已无法分辨在周期中的位置
+    double tol = 1e-12 * (1 + scale);
+    double k = ceil((lo - tol - phase) / period);
+    return phase + k * period <= hi + tol;
+}
+
+bool isIntegerPoint(const Interval& b) {    // 是否为整数单点（且可精确表示）
+    return b.isPoint() && isfinite(b.lo) && b.lo == floor(b.lo) && fabs(b.lo) < 9007199254740992.0;
+}
+
+Interval sinCosBounds(const Interval& a, double maxPhase, double minPhase, double (*fn)(double)) {
+    double values[2] = {fn(a.lo), fn(a.hi)};
+    Interval r = hull(values, 2, 2);
+    if (mayContainPeriodicPoint(a.lo, a.hi, maxPhase, 2 * PI)) r.hi = 1;
+    if (mayContainPeriodicPoint(a.lo, a.hi, minPhase, 2 * PI)) r.lo = -1;
+    r.lo = max(r.lo, -1.0);
+    r.hi = min(r.hi, 1.0);
+    return r;
+}
+
+Interval powInterval(const Interval& a, const Interval& b, IntervalReport& report) {
+    if (isIntegerPoint(b)) {    // 整数次幂：在不含 0 的一侧单调
+        double n = b.lo;
+        if (n == 0) return {1, 1};
+        bool even = fmod(n, 2) == 0;
+        if (n > 0 && even && a.contains(0)) {
+            double values[2] = {pow(a.lo, n), pow(a.hi, n)};
+            return {0, hull(values, 2, 2).hi};
+        }
+        if (n < 0 && a.contains(0)) {    // 0 的负数次幂
+            report.powDomain = true;
+            return even ? Interval{0, INF} : ENTIRE;
+        }
+        double values[2] = {pow(a.lo, n), pow(a.hi, n)};
+        return hull(values, 2, 2);
+    }
+    if (a.lo >= 0) {    // 非负底数：pow 对 x、y 分别单调，极值在四个角上
+        if (a.lo == 0 && b.lo < 0) report.powDomain = true;
+        double values[4] = {pow(a.lo, b.lo), pow(a.lo, b.hi), pow(a.hi, b.lo), pow(a.hi, b.hi)};
+        return hull(values, 4, 2);
+    }
+    report.powDomain = true;    // 负底数的非整数次幂无定义
+    return ENTIRE;
+}
+
+Interval bitwiseInterval(const Interval& a, const Interval& b, char op, IntervalReport& report) {
+    const double intMin = INT_MIN, intMax = INT_MAX;
+    const Interval intRange = {intMin, intMax};
+    if (!(a.lo >= intMin && a.hi <= intMax && b.lo >= intMin && b.hi <= intMax)) {
+        report.intOverflow = true;    // static_cast<int> 超出范围
+        return intRange;
+    }
+    if (a.isPoint() && b.isPoint()) {
+        double r = CompiledExpression::evaluateOperation(a.lo, b.lo, op);
+        return {r, r};
+    }
+    double aLo = trunc(a.lo), aHi = trunc(a.hi), bLo = trunc(b.lo), bHi = trunc(b.hi);
+    if (op == '&') {
+        if (aLo >= 0 && bLo >= 0) return {0, min(aHi, bHi)};
+        if (aLo >= 0) return {0, aHi};    // 与非负数按位与，结果在 [0, a]
+        if (bLo >= 0) return {0, bHi};
+        return intRange;
+    }
+    if (aLo >= 0 && bLo >= 0) {    // 按位或：不小于较大的下界，不超过最高位全 1
+        double top = max(aHi, bHi);
+        double mask = 1;
+        while (mask <= top) mask *= 2;
+        return {max(aLo, bLo), mask - 1};
+    }
+    return intRange;
+}
+
+}  // namespace
+
+Interval IntervalEvaluator::applyOperation(const Interval& a, const Interval& b, char op,
+                                           IntervalReport& report) {    // 区间二元运算
+    switch (op) {
+        case '+': return {lower(a.lo + b.lo), upper(a.hi + b.hi)};
+        case '-': return {lower(a.lo - b.hi), upper(a.hi - b.lo)};
+        case '*': {
+            double values[4] = {mulEndpoint(a.lo, b.lo), mulEndpoint(a.lo, b.hi),
+                                mulEndpoint(a.hi, b.lo), mulEndpoint(a.hi, b.hi)};
+            return hull(values, 4, 1);
+        }
+        case '/': {
+            if (b.contains(0)) {
+                report.divisionByZero = true;
+                return ENTIRE;
+            }
+            double values[4] = {a.lo / b.lo, a.lo / b.hi, a.hi / b.lo, a.hi / b.hi};
+            return hull(values, 4, 1);
+        }
+        case '%': {    // fmod：结果与被除数同号，绝对值小于除数绝对值（fmod 本身是精确的）
+            if (b.contains(0)) report.divisionByZero = true;
+            if (!isfinite(a.lo) || !isfinite(a.hi)) return ENTIRE;
+            double bMax = max(fabs(b.lo), fabs(b.hi));
+            double bMin = b.contains(0) ? 0 : min(fabs(b.lo), fabs(b.hi));
+            if (a.lo >= 0 && a.hi < bMin) return a;    // 被除数小于除数，结果就是被除数
+            if (a.hi <= 0 && -a.lo < bMin) return a;
+            return {a.lo >= 0 ? 0 : max(a.lo, -bMax), a.hi <= 0 ? 0 : min(a.hi, bMax)};
+        }
+        case '^': return powInterval(a, b, report);
+        case '&':
+        case '|': return bitwiseInterval(a, b, op, report);
+        default: throw runtime_error("未知运算符 (Unknown operator)");
+    }
+}
+
+Interval IntervalEvaluator::applyUnary(char op, const Interval& b, IntervalReport& report) {    // 区间一元运算
+    switch (op) {
+        case '-': return {-b.hi, -b.lo};
+        case 's': return sinCosBounds(b, PI / 2, -PI / 2, [](double x) { return sin(x); });
+        case 'c': return sinCosBounds(b, 0, PI, [](double x) { return cos(x); });
+        case 't':
+            if (mayContainPeriodicPoint(b.lo, b.hi, PI / 2, PI)) {    // 跨过极点
+                report.tanPole = true;
+                return ENTIRE;
+            }
+            return {lower(tan(b.lo), 2), upper(tan(b.hi), 2)};    // 两极点之间单调递增
+        case 'l':
+            if (b.lo <= 0) report.logDomain = true;
+            return {b.lo > 0 ? lower(log(b.lo), 2) : -INF, b.hi > 0 ? upper(log(b.hi), 2) : -INF};
+        default: throw runtime_error("未知运算符 (Unknown operator)");
+    }
+}
+
+Interval IntervalEvaluator::evaluate(const CompiledExpression& expr, const vector<Interval>& inputs,
+                                     IntervalReport& report) {    // 区间求值
+    if (!expr.isComplete()) throw runtime_error("表达式不完整 (Incomplete expression)");
+    if (inputs.size() < expr.getVariables().size()) throw runtime_error("变量取值不足 (Missing variable values)");
+    for (const Interval& in : inputs) {
+        if (!(in.lo <= in.hi)) throw runtime_error("无效的区间 (Invalid interval)");
+    }
+
+    const vector<double>& constants = expr.getConstants();
+    vector<Interval> stack(expr.getMaxStackDepth());
+    size_t top = 0;
+    for (const Instruction& ins : expr.getCode()) {
+        switch (ins.code) {
+            case OpCode::PUSH_CONST: {
+                double v = constants[ins.index];
+                // 整数常数可以精确表示；0.1、pi 等常数本身已有舍入，放宽 1 ulp
+                bool exact = (v == floor(v) && fabs(v) < 9007199254740992.0);
+                stack[top++] = exact ? Interval{v, v} : Interval{lower(v), upper(v)};
+                break;
+            }
+            case OpCode::LOAD_VAR: stack[top++] = inputs[ins.index]; break;
+            case OpCode::BINARY:
+                top--;
+                stack[top - 1] = applyOperation(stack[top - 1], stack[top], ins.op, report);
+                break;
+            case OpCode::UNARY:
+                stack[top - 1] = applyUnary(ins.op, stack[top - 1], report);
+                break;
+        }
+    }
+    return stack[0];
+}
@@ -0,0 +1,42 @@
+#ifndef INTERVAL_EVALUATOR_H    // 防止头文件重复包含
+#define INTERVAL_EVALUATOR_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include <vector>                   // 包含向量容器
+using namespace std;                // 使用标准命名空间
+
+/*区间求值：给定每个变量的取值范围，计算结果的保证范围。
+每一步都向外舍入（下界向 -inf、上界向 +inf 各放宽若干 ulp），因此真实结果一定落在区间内。
+同时检查定义域：除数区间含 0、对数参数区间含非正数、tan 区间跨过极点等，
+可以在处理大批数据之前一次性发现问题，而不必等到逐行求值时抛出异常。*/
+
+struct Interval {    // 闭区间 [lo, hi]
+    double lo;    // 下界
+    double hi;    // 上界
+
+    bool contains(double x) const { return lo <= x && x <= hi; }    // 是否包含 x
+    bool isPoint() const { return lo == hi; }                        // 是否为单点
+};
+
+struct IntervalReport {    // 定义域检查结果
+    bool divisionByZero = false;    // 除数（/ 或 %）区间可能为 0
+    bool logDomain = false;         // 对数参数可能 <= 0
+    bool powDomain = false;         // 幂运算可能无定义（负底数非整数指数，或 0 的负数次幂）
+    bool tanPole = false;           // tan 的参数区间可能跨过极点
+    bool intOverflow = false;       // 位运算的操作数可能超出 int 范围
+
+    bool isSafe() const {    // 是否不会出现任何定义域错误
+        return !divisionByZero && !logDomain && !powDomain && !tanPole && !intOverflow;
+    }
+};
+
+class IntervalEvaluator {    // 区间求值器
+public:
+    static Interval evaluate(const CompiledExpression& expr, const vector<Interval>& inputs,
+                             IntervalReport& report);                     // 在编译后的表达式上区间求值
+    static Interval applyOperation(const Interval& a, const Interval& b, char op,
+                                   IntervalReport& report);               // 区间二元运算
+    static Interval applyUnary(char op, const Interval& b, IntervalReport& report);    // 区间一元运算
+};
+
+#endif // INTERVAL_EVALUATOR_H    // 结束头文件保护
@@ -1,4 +1,9 @@
 #include "calculator.h"  // 包含计算器头文件
+#include "ExpressionEvaluator.h"  // 表达式类型检测
+#include "expression_simplifier.h"  // 批量求值前化简
+#include "columnar_file.h"        // 列式二进制文件
+#include "csv_evaluator.h"        // CSV 文件批量求值
+#include "metrics.h"              // 错误类型名
 #include <iostream>  
 #include <string>  
 #include <iomanip>     
@@ -25,39 +30,150 @@ void printWelcome() {  // 打印欢迎信息的函数
     cout << "1. 中缀表达式 Infix expression (e.g., 1 3 + 4 * 5)" << endl;    // 中缀
     cout << "2. 前缀表达式 Prefix expression (e.g., 2 + * 2 3 4)" << endl;   // 前缀
     cout << "3. 后缀表达式 Postfix expression (e.g., 3 3 4 * 2 +)" << endl;  // 后缀
+    cout << "省略类型时自动识别 (Type is detected automatically when omitted, e.g., * 3 + 4 5)" << endl;  // 自动识别
+    cout << "数值模式： Numeric mode: mode double | int | rational | decimal [digits]" << endl;  // 数值模式
 }
 
-int main() {  
+// 批处理模式：从标准输入逐行读取不带类型标记的表达式，自动识别记法后编译求值，每行输出一个结果
+int runBatch(Calculator& calc) {
+    ios::sync_with_stdio(false);
+    string line;
+    cout << fixed << setprecision(10);
+    while (getline(cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        try {
+            CompiledExpression compiled = calc.compile(line, ExpressionTypeDetector::detectType(line));
+            if (!compiled.getVariables().empty()) {
+                throw EvaluationError(INVALID_EXPRESSION, "表达式包含未赋值的变量 (Expression contains unbound variables): " + compiled.getVariables()[0]);
+            }
+            cout << compiled.evaluate() << '\n';
+        } catch (const exception& e) {
+            cout << "错误 (Error): " << e.what() << '\n';
+        }
+    }
+    return 0;
+}
+
+// 输出逐行求值的汇总：空值行数和各类错误的行数（全部正常时不输出）
+void printStatus(ostream& out, const BatchStatus& status) {
+    if (status.nullCount) out << "空值 (Nulls): " << status.nullCount << " 行 (rows)" << endl;
+    for (size_t e = 0; e <= IO_ERROR; e++) {
+        if (status.errorCounts[e]) out << "错误 (Errors) " << Metrics::errorName(static_cast<ErrorType>(e)) << ": " << status.errorCounts[e] << " 行 (rows)" << endl;
+    }
+}
+
+// 列式文件模式：公式的变量按名字绑定到输入文件的同名列，逐行求值，结果写入输出文件的 result 列
+int runColumnar(Calculator& calc, const string& formula, const string& input, const string& output) {
+    try {
+        CompiledExpression compiled = ExpressionSimplifier::simplify(calc.compile(formula, ExpressionTypeDetector::detectType(formula)));
+        BatchStatus status;
+        size_t rows = ExpressionUtils::evaluateColumnarFile(compiled, input, output, "result", PrecisionMode::EXACT, &status);
+        cout << "已写入 (Wrote) " << rows << " 行 (rows): " << output << endl;
+        printStatus(cout, status);
+        return 0;
+    } catch (const exception& e) {
+        cerr << "错误 (Error): " << e.what() << endl;
+        return 1;
+    }
+}
+
+// CSV 模式：公式的变量按名字绑定到表头中的同名列，带结果列的 CSV 写到标准输出
+int runCsv(Calculator& calc, const string& formula, const string& input) {
+    ios::sync_with_stdio(false);
+    try {
+        CompiledExpression compiled = ExpressionSimplifier::simplify(calc.compile(formula, ExpressionTypeDetector::detectType(formula)));
+        BatchStatus status;
+        ExpressionUtils::evaluateCsvFile(compiled, input, cout, CsvOptions(), &status);
+        cout.flush();
+        printStatus(cerr, status);
+        return 0;
+    } catch (const exception& e) {
+        cout.flush();
+        cerr << "错误 (Error): " << e.what() << endl;
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {  
     Calculator calc;  
+    if (argc > 1 && string(argv[1]) == "--batch") {  // 批处理模式
+        return runBatch(calc);
+    }
+    if (argc > 1 && string(argv[1]) == "--columnar") {  // 列式文件模式
+        if (argc != 5) {
+            cerr << "用法 (Usage): " << argv[0] << " --columnar <公式 formula> <输入 input.col> <输出 output.col>" << endl;
+            return 2;
+        }
+        return runColumnar(calc, argv[2], argv[3], argv[4]);
+    }
+    if (argc > 1 && string(argv[1]) == "--csv") {  // CSV 文件模式
+        if (argc != 4) {
+            cerr << "用法 (Usage): " << argv[0] << " --csv <公式 formula> <输入 input.csv>" << endl;
+            return 2;
+        }
+        return runCsv(calc, argv[2], argv[3]);
+    }
+
     string input;    // 存储输入的字符串
+    NumericMode mode = NumericMode::DOUBLE;  // 当前数值模式
+    size_t digits = 50;                      // 十进制模式的有效数字位数
     
     printWelcome();  
     
     while (true) {  
         cout << "\n请输入表达式类型和表达式 (或输入 'q' 退出) / Enter expression type and expression (or 'q' to quit): ";  // 提示用户输入
-        getline(cin, input);  
+        if (!getline(cin, input)) {  // 输入结束
+            break;
+        }
         
         if (input == "q" || input == "Q") {  // 退出
             break;  
         }
+
+        if (input.compare(0, 5, "mode ") == 0) {  // 切换数值模式
+            istringstream iss(input.substr(5));
+            string name, digitsStr;
+            iss >> name >> digitsStr;
+            NumericMode newMode;    // 位数合法后才切换
+            if (name == "double") newMode = NumericMode::DOUBLE;
+            else if (name == "int") newMode = NumericMode::INT64;
+            else if (name == "rational") newMode = NumericMode::RATIONAL;
+            else if (name == "decimal") newMode = NumericMode::DECIMAL;
+            else {
+                cout << "\n错误 (Error): 未知的数值模式 / Unknown numeric mode: " << name << endl;
+                continue;
+            }
+            if (!digitsStr.empty()) {
+                long long value = 0;    // 按有符号数解析，0 和负数不会被当作（回绕后的）合法位数
+                size_t used = 0;
+                try {
+                    value = stoll(digitsStr, &used);
+                } catch (...) {
+                    used = 0;
+                }
+                if (used != digitsStr.size() || value <= 0 || static_cast<unsigned long long>(value) > MAX_DECIMAL_DIGITS) {
+                    cout << "\n错误 (Error): 位数必须是 1 到 " << MAX_DECIMAL_DIGITS << " 之间的整数 / Digits must be an integer between 1 and "
+                         << MAX_DECIMAL_DIGITS << endl;
+                    continue;
+                }
+                digits = static_cast<size_t>(value);
+            }
+            mode = newMode;
+            cout << "\n数值模式 (Numeric mode): " << name << endl;
+            continue;
+        }
         
         try {  // 异常处理开始
             // 解析输入
-            size_t pos = input.find(' ');  
-            if (pos == string::npos) {  //未搜索到
-                cout << "\n错误 (Error): 输入格式无效，请使用'类型 表达式'格式 / Invalid input format. Please use 'type expression' format" << endl;
-                continue;
-            }
-            
-            string typeStr = input.substr(0, pos);  // 类型
-            string expr = input.substr(pos + 1);    // 表达式
+            string expr;                            // 表达式
             
             ExpressionType type; 
-            try {
-                type = static_cast<ExpressionType>(stoi(typeStr));  
-            } catch (...) {  // 捕获所有可能的异常
-                cout << "\n错误 (Error): 表达式类型必须是数字 (1-中缀, 2-前缀, 3-后缀) / Expression type must be a number (1-Infix, 2-Prefix, 3-Postfix)" << endl;
-                continue;
+            if (ExpressionTypeDetector::hasTypeTag(input)) {  // 带类型标记（1 + 2、3 4 + 这样只有整行才合法的不算）
+                type = static_cast<ExpressionType>(input[0] - '0');
+                expr = input.substr(2);
+            } else {  // 省略类型：自动识别
+                expr = input;
+                type = ExpressionTypeDetector::detectType(expr);
             }
             
             // 预处理表达式
@@ -83,6 +199,15 @@ int main() {
                     break;
             }
         
+            if (mode != NumericMode::DOUBLE) {  // 整数 / 有理数 / 多精度模式
+                string text = calc.evaluateWithMode(expr, type, mode, digits);
+                if (!calc.hasErrorOccurred()) {
+                    cout << "\n最终结果 (Final result): " << text << endl;
+                }
+                cout << "----------------------------------------" << endl;
+                continue;
+            }
+
             double result = calc.evaluate(expr, type);  // 调用计算器求值
             
             if (!calc.hasErrorOccurred()) {  // 如果没有错误发生
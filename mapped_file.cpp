@@ -0,0 +1,48 @@
+#include "mapped_file.h"    // 包含映射文件头文件
+#include "error_type.h"     // 错误类型
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_MMAP 1
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+using namespace std;
+
+MappedFile::MappedFile(const string& path) : base(nullptr), length(0), mapped(false) {
+#ifdef MAPPED_FILE_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw EvaluationError(IO_ERROR, "无法打开文件 (Cannot open file): " + path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw EvaluationError(IO_ERROR, "无法读取文件 (Cannot read file): " + path);
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) throw EvaluationError(IO_ERROR, "无法映射文件 (Cannot map file): " + path);
+        base = static_cast<const char*>(p);
+        mapped = true;
+    } else {
+        close(fd);
+    }
+#else
+    ifstream in(path, ios::binary);
+    if (!in) throw EvaluationError(IO_ERROR, "无法打开文件 (Cannot open file): " + path);
+    buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    base = buffer.empty() ? nullptr : buffer.data();
+    length = buffer.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef MAPPED_FILE_MMAP
+    if (mapped) munmap(const_cast<char*>(base), length);
+#endif
+}
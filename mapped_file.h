@@ -0,0 +1,27 @@
+#ifndef MAPPED_FILE_H    // 防止头文件重复包含
+#define MAPPED_FILE_H    // 定义头文件宏
+
+#include <string>    // 包含字符串处理
+#include <vector>    // 包含向量容器
+using namespace std; // 使用标准命名空间
+
+/*只读映射整个文件（mmap）；不支持 mmap 的平台上把文件读入内存。打开失败时抛出 IO_ERROR 类型的 EvaluationError。*/
+
+class MappedFile {    // 只读映射的文件
+public:
+    explicit MappedFile(const string& path);    // 打开并映射
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return base; }    // 文件内容（空文件时为 nullptr）
+    size_t size() const { return length; }       // 文件长度
+
+private:
+    const char* base;       // 文件内容
+    size_t length;          // 文件长度
+    bool mapped;            // base 是否来自 mmap
+    vector<char> buffer;    // 不支持 mmap 时的文件内容
+};
+
+#endif // MAPPED_FILE_H    // 结束头文件保护
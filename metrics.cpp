@@ -0,0 +1,187 @@
+#include "metrics.h"    // 包含运行指标头文件
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define METRICS_UNIX_SOCKET 1
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL    // 对端提前关闭时不产生 SIGPIPE
+#else
+#define SEND_FLAGS 0
+#endif
+#endif
+
+using namespace std;
+
+namespace Metrics {
+
+namespace {
+
+mutex registryLock;                               // 保护下面两个列表
+vector<unique_ptr<ThreadCounters>> allCounters;   // 所有计数块（从不释放）
+vector<ThreadCounters*> freeCounters;             // 已退出线程留下的计数块
+
+const char* TYPE_NAMES[TYPE_COUNT] = {"infix", "prefix", "postfix"};
+
+const char* ERROR_NAMES[ERROR_COUNT] = {
+    "none", "mismatched_parentheses", "invalid_character", "consecutive_operators",
+    "division_by_zero", "invalid_expression", "empty_expression", "invalid_negative_number",
+    "insufficient_operands", "function_argument_error", "missing_operator", "limit_exceeded",
+    "cancelled", "io_error"
+};
+
+struct Totals {    // 汇总后的计数
+    uint64_t requests[TYPE_COUNT] = {};
+    uint64_t errors[ERROR_COUNT] = {};
+    uint64_t latency[TYPE_COUNT][BUCKET_COUNT] = {};
+    uint64_t latencySum[TYPE_COUNT] = {};
+    uint64_t cacheHits = 0;
+    uint64_t cacheMisses = 0;
+};
+
+Totals collect() {    // 加锁遍历所有计数块求和
+    Totals totals;
+    lock_guard<mutex> guard(registryLock);
+    for (const unique_ptr<ThreadCounters>& c : allCounters) {
+        for (size_t t = 0; t < TYPE_COUNT; t++) {
+            totals.requests[t] += c->requests[t].load(memory_order_relaxed);
+            totals.latencySum[t] += c->latencySum[t].load(memory_order_relaxed);
+            for (size_t b = 0; b < BUCKET_COUNT; b++) totals.latency[t][b] += c->latency[t][b].load(memory_order_relaxed);
+        }
+        for (size_t e = 0; e < ERROR_COUNT; e++) totals.errors[e] += c->errors[e].load(memory_order_relaxed);
+        totals.cacheHits += c->cacheHits.load(memory_order_relaxed);
+        totals.cacheMisses += c->cacheMisses.load(memory_order_relaxed);
+    }
+    return totals;
+}
+
+}  // namespace
+
+ThreadCounters* acquireCounters() {    // 分配计数块
+    lock_guard<mutex> guard(registryLock);
+    if (!freeCounters.empty()) {
+        ThreadCounters* counters = freeCounters.back();
+        freeCounters.pop_back();
+        return counters;
+    }
+    allCounters.push_back(make_unique<ThreadCounters>());
+    return allCounters.back().get();
+}
+
+void releaseCounters(ThreadCounters* counters) {    // 归还计数块，计数保留
+    lock_guard<mutex> guard(registryLock);
+    freeCounters.push_back(counters);
+}
+
+const char* errorName(ErrorType error) {    // 错误类型的导出名
+    return static_cast<size_t>(error) < ERROR_COUNT ? ERROR_NAMES[error] : "unknown";
+}
+
+string render() {    // 生成 Prometheus 文本格式
+    Totals totals = collect();
+    ostringstream out;
+
+    out << "# HELP expression_requests_total Evaluated requests by expression type.\n";
+    out << "# TYPE expression_requests_total counter\n";
+    for (size_t t = 0; t < TYPE_COUNT; t++) {
+        out << "expression_requests_total{type=\"" << TYPE_NAMES[t] << "\"} " << totals.requests[t] << "\n";
+    }
+
+    out << "# HELP expression_errors_total Failed requests by error type.\n";
+    out << "# TYPE expression_errors_total counter\n";
+    for (size_t e = 1; e < ERROR_COUNT; e++) {
+        out << "expression_errors_total{error=\"" << ERROR_NAMES[e] << "\"} " << totals.errors[e] << "\n";
+    }
+
+    out << "# HELP expression_latency_seconds Time from submission to result ready (queue wait plus evaluation, excluding callbacks) by expression type.\n";
+    out << "# TYPE expression_latency_seconds histogram\n";
+    for (size_t t = 0; t < TYPE_COUNT; t++) {
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b < BUCKET_COUNT; b++) {
+            cumulative += totals.latency[t][b];
+            out << "expression_latency_seconds_bucket{type=\"" << TYPE_NAMES[t] << "\",le=\"";
+            if (b < BUCKET_COUNT - 1) out << BUCKET_BOUNDS[b] / 1e9; else out << "+Inf";
+            out << "\"} " << cumulative << "\n";
+        }
+        out << "expression_latency_seconds_sum{type=\"" << TYPE_NAMES[t] << "\"} " << totals.latencySum[t] / 1e9 << "\n";
+        out << "expression_latency_seconds_count{type=\"" << TYPE_NAMES[t] << "\"} " << cumulative << "\n";
+    }
+
+    out << "# HELP expression_cache_hits_total Compile cache hits.\n";
+    out << "# TYPE expression_cache_hits_total counter\n";
+    out << "expression_cache_hits_total " << totals.cacheHits << "\n";
+    out << "# HELP expression_cache_misses_total Compile cache misses.\n";
+    out << "# TYPE expression_cache_misses_total counter\n";
+    out << "expression_cache_misses_total " << totals.cacheMisses << "\n";
+    return out.str();
+}
+
+bool writeFile(const string& path) {    // 写入文件
+    string text = render();
+    string temp = path + ".tmp";
+    FILE* file = fopen(temp.c_str(), "wb");
+    if (!file) return false;
+    bool ok = fwrite(text.data(), 1, text.size(), file) == text.size();
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+        remove(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+SocketExporter::SocketExporter(const string& socketPath) : path(socketPath), listenFd(-1), stopping(false) {
+#ifdef METRICS_UNIX_SOCKET
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) return;
+    path.copy(address.sun_path, path.size());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return;
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 8) != 0) {
+        close(fd);
+        return;
+    }
+    listenFd = fd;
+    server = thread([this] { serve(); });
+#endif
+}
+
+SocketExporter::~SocketExporter() {
+    stopping = true;
+    if (server.joinable()) server.join();
+#ifdef METRICS_UNIX_SOCKET
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(path.c_str());
+    }
+#endif
+}
+
+void SocketExporter::serve() {    // 接受连接并写出指标；每 100ms 检查一次是否停止
+#ifdef METRICS_UNIX_SOCKET
+    while (!stopping) {
+        pollfd waiting = {listenFd, POLLIN, 0};
+        if (poll(&waiting, 1, 100) <= 0) continue;
+        int client = accept(listenFd, nullptr, nullptr);
+        if (client < 0) continue;
+        string text = render();
+        size_t written = 0;
+        while (written < text.size()) {
+            ssize_t n = send(client, text.data() + written, text.size() - written, SEND_FLAGS);
+            if (n <= 0) break;
+            written += static_cast<size_t>(n);
+        }
+        close(client);
+    }
+#endif
+}
+
+}  // namespace Metrics
@@ -0,0 +1,93 @@
+#ifndef METRICS_H    // 防止头文件重复包含
+#define METRICS_H    // 定义头文件宏
+
+#include "expression_type.h"    // 表达式类型
+#include "error_type.h"         // 错误类型
+#include <atomic>               // 原子计数
+#include <cstdint>              // uint64_t
+#include <string>               // 包含字符串处理
+#include <thread>               // 导出线程
+using namespace std;            // 使用标准命名空间
+
+/*求值服务的运行指标：请求数、按 ErrorType 分类的错误数、按 ExpressionType 分类的延迟直方图、编译缓存命中数。
+延迟是请求从提交（入队）到结果就绪的时间，包括队列满时的阻塞、排队和求值，不包括回调或 future 取值方的处理时间。
+每个线程写自己的计数块（按缓存行对齐），只有本线程写，所以用 relaxed 的读加写即可，不需要加锁也没有原子读改写；
+导出时加锁遍历所有计数块求和。线程退出后计数块留给下一个线程复用，计数不会丢失。
+导出格式为 Prometheus 文本格式，可写入文件（配合 node_exporter 的 textfile 收集器），或通过本地 Unix 套接字读取。*/
+
+namespace Metrics {
+
+constexpr size_t TYPE_COUNT = 3;                  // 表达式类型数
+constexpr size_t ERROR_COUNT = IO_ERROR + 1;      // 错误类型数
+constexpr size_t BUCKET_COUNT = 12;               // 延迟直方图桶数（最后一个为 +Inf）
+constexpr uint64_t BUCKET_BOUNDS[BUCKET_COUNT - 1] = {    // 各桶上界（纳秒）
+    1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000, 10000000
+};
+
+struct alignas(64) ThreadCounters {    // 单个线程的计数块
+    atomic<uint64_t> requests[TYPE_COUNT] = {};
+    atomic<uint64_t> errors[ERROR_COUNT] = {};
+    atomic<uint64_t> latency[TYPE_COUNT][BUCKET_COUNT] = {};
+    atomic<uint64_t> latencySum[TYPE_COUNT] = {};    // 纳秒
+    atomic<uint64_t> cacheHits{0};
+    atomic<uint64_t> cacheMisses{0};
+};
+
+ThreadCounters* acquireCounters();    // 为当前线程分配计数块（优先复用已退出线程的）
+void releaseCounters(ThreadCounters* counters);    // 线程退出时归还计数块
+
+inline ThreadCounters& local() {    // 当前线程的计数块
+    struct Holder {
+        ThreadCounters* counters = acquireCounters();
+        ~Holder() { releaseCounters(counters); }
+    };
+    thread_local Holder holder;
+    return *holder.counters;
+}
+
+inline void add(atomic<uint64_t>& counter, uint64_t value) {    // 单写者递增，无原子读改写
+    counter.store(counter.load(memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+inline void recordRequest(ExpressionType type, ErrorType error, uint64_t nanoseconds) {    // 记录一次请求
+    ThreadCounters& counters = local();
+    size_t t = static_cast<size_t>(type) - 1;
+    size_t bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && nanoseconds > BUCKET_BOUNDS[bucket]) bucket++;
+    add(counters.requests[t], 1);
+    add(counters.latency[t][bucket], 1);
+    add(counters.latencySum[t], nanoseconds);
+    if (error != NO_ERROR) add(counters.errors[error], 1);
+}
+
+inline void recordCache(bool hit) {    // 记录一次编译缓存查找
+    ThreadCounters& counters = local();
+    add(hit ? counters.cacheHits : counters.cacheMisses, 1);
+}
+
+string render();                          // 汇总所有线程，生成 Prometheus 文本
+const char* errorName(ErrorType error);   // 错误类型的导出名（如 division_by_zero）
+bool writeFile(const string& path);       // 写入文件（先写临时文件再改名，读者不会读到一半）
+
+class SocketExporter {    // 在本地 Unix 套接字上导出，每个连接写一次当前指标后关闭
+private:
+    string path;               // 套接字路径
+    int listenFd;              // 监听描述符，-1 表示未打开
+    atomic<bool> stopping;     // 是否正在停止
+    thread server;             // 接受连接的线程
+
+    void serve();              // 接受连接并写出指标
+
+public:
+    explicit SocketExporter(const string& socketPath);
+    ~SocketExporter();
+
+    SocketExporter(const SocketExporter&) = delete;
+    SocketExporter& operator=(const SocketExporter&) = delete;
+
+    bool isOpen() const { return listenFd >= 0; }    // 是否成功监听（非 POSIX 平台总是 false）
+};
+
+}  // namespace Metrics
+
+#endif // METRICS_H    // 结束头文件保护
@@ -0,0 +1,248 @@
+#ifndef NUMERIC_ENGINE_H    // 防止头文件重复包含
+#define NUMERIC_ENGINE_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include "big_number.h"             // 任意精度数值类型
+#include <string>                   // 包含字符串处理
+#include <vector>                   // 包含向量容器
+#include <cstdint>                  // 定长整数类型
+#include <stdexcept>                // 标准异常
+#include <cctype>                   // isdigit
+using namespace std;                // 使用标准命名空间
+
+/*以数值类型为模板参数的求值引擎：
+NumericEngine<double>       原有的 double 快速路径（完全特化，直接调用 CompiledExpression::evaluate）
+NumericEngine<int64_t>      64 位整数：溢出检查，/ 向零截断，% 与被除数同号，^ 快速幂，& | 为原生 64 位运算
+NumericEngine<BigRational>  精确有理数：+ - * / % 精确，^ 要求整数指数，不支持三角和对数函数
+NumericEngine<BigFloat>     十进制多精度浮点数（默认 50 位有效数字），支持全部运算符和函数
+新的数值类型只需提供 NumericTraits<T> 特化。*/
+
+enum class NumericMode {    // 数值模式
+    DOUBLE,      // 双精度浮点（默认）
+    INT64,       // 64 位整数
+    RATIONAL,    // 精确有理数
+    DECIMAL      // 多精度十进制浮点
+};
+
+constexpr size_t MAX_DECIMAL_DIGITS = 10000;    // 十进制模式允许的最大有效数字位数（再多的乘除与超越函数耗时过长）
+
+template<typename T>
+struct NumericTraits;    // 各数值类型的运算，由特化提供
+
+// 64 位整数运算（带溢出检查）
+template<>
+struct NumericTraits<int64_t> {
+    static int64_t fromLiteral(const string& text) {
+        BigRational r = BigRational::fromLiteral(text);
+        if (!r.isInteger()) throw runtime_error("整数模式不支持小数 (Non-integer literal in integer mode): " + text);
+        if (!r.numerator().fitsInt64()) throw runtime_error("整数溢出 (Integer overflow): " + text);
+        return r.numerator().toInt64();
+    }
+
+    static int64_t power(int64_t base, int64_t exp) {    // 快速幂
+        if (exp < 0) {
+            if (base == 0) throw runtime_error("除数不能为零 (Division by zero)");
+            if (base == 1) return 1;
+            if (base == -1) return (exp % 2 == 0) ? 1 : -1;
+            throw runtime_error("整数模式下指数不能为负 (Negative exponent in integer mode)");
+        }
+        int64_t result;
+        if (!CompiledExpression::checkedPower(base, exp, result)) throw runtime_error("整数溢出 (Integer overflow)");
+        return result;
+    }
+
+    static int64_t applyOperation(int64_t a, int64_t b, char op) {
+        int64_t r = 0;
+        switch (op) {
+            case '+': if (__builtin_add_overflow(a, b, &r)) break; return r;
+            case '-': if (__builtin_sub_overflow(a, b, &r)) break; return r;
+            case '*': if (__builtin_mul_overflow(a, b, &r)) break; return r;
+            case '/':
+                if (b == 0) throw runtime_error("除数不能为零 (Division by zero)");
+                if (a == INT64_MIN && b == -1) break;
+                return a / b;
+            case '%':
+                if (b == 0) throw runtime_error("除数不能为零 (Division by zero)");
+                if (b == -1) return 0;    // 避免 INT64_MIN % -1 的未定义行为
+                return a % b;
+            case '^': return power(a, b);
+            case '&': return a & b;
+            case '|': return a | b;
+            default: throw runtime_error("未知运算符 (Unknown operator)");
+        }
+        throw runtime_error("整数溢出 (Integer overflow)");
+    }
+
+    static int64_t applyUnary(char op, int64_t b) {
+        if (op != '-') throw runtime_error("整数模式不支持函数 (Functions are not supported in integer mode)");
+        if (b == INT64_MIN) throw runtime_error("整数溢出 (Integer overflow)");
+        return -b;
+    }
+
+    static string toString(int64_t v) { return to_string(v); }
+};
+
+// 精确有理数运算
+template<>
+struct NumericTraits<BigRational> {
+    static BigRational fromLiteral(const string& text) { return BigRational::fromLiteral(text); }
+
+    static BigRational applyOperation(const BigRational& a, const BigRational& b, char op) {
+        switch (op) {
+            case '+': return a + b;
+            case '-': return a - b;
+            case '*': return a * b;
+            case '/': return a / b;
+            case '%': {
+                if (b.isZero()) throw runtime_error("除数不能为零 (Division by zero)");
+                return a - BigRational((a / b).truncate()) * b;
+            }
+            case '^': {
+                if (!b.isInteger() || !b.numerator().fitsInt64()) {
+                    throw runtime_error("有理数模式下指数必须为整数 (Exponent must be an integer in rational mode)");
+                }
+                int64_t e = b.numerator().toInt64();
+                if (e > 1000000 || e < -1000000) throw runtime_error("指数过大 (Exponent too large)");
+                BigRational base = a, result(BigInt(1));
+                for (int64_t k = e < 0 ? -e : e; k > 0; k >>= 1) {
+                    if (k & 1) result = result * base;
+                    if (k > 1) base = base * base;
+                }
+                return e < 0 ? BigRational(BigInt(1)) / result : result;
+            }
+            case '&':
+            case '|': return BigRational(BigInt::bitwise(a.truncate(), b.truncate(), op));
+            default: throw runtime_error("未知运算符 (Unknown operator)");
+        }
+    }
+
+    static BigRational applyUnary(char op, const BigRational& b) {
+        if (op != '-') throw runtime_error("有理数模式不支持函数 (Functions are not exact in rational mode)");
+        return -b;
+    }
+
+    static string toString(const BigRational& v) { return v.toString(); }
+};
+
+// 多精度十进制浮点运算
+template<>
+struct NumericTraits<BigFloat> {
+    static BigFloat fromLiteral(const string& text) { return BigFloat::fromLiteral(text); }
+
+    static BigFloat applyOperation(const BigFloat& a, const BigFloat& b, char op) {
+        switch (op) {
+            case '+': return a + b;
+            case '-': return a - b;
+            case '*': return a * b;
+            case '/': return a / b;
+            case '%': return a.fmod(b);
+            case '^': return BigFloat::pow(a, b);
+            case '&':
+            case '|': return BigFloat::fromInteger(BigInt::bitwise(a.truncate(), b.truncate(), op));
+            default: throw runtime_error("未知运算符 (Unknown operator)");
+        }
+    }
+
+    static BigFloat applyUnary(char op, const BigFloat& b) {
+        switch (op) {
+            case '-': return -b;
+            case 's': return BigFloat::sin(b);
+            case 'c': return BigFloat::cos(b);
+            case 't': return BigFloat::tan(b);
+            case 'l': return BigFloat::log(b);
+            default: throw runtime_error("未知运算符 (Unknown operator)");
+        }
+    }
+
+    static string toString(const BigFloat& v) { return v.toString(); }
+};
+
+template<typename T>
+class NumericEngine {    // 通用求值引擎
+public:
+    // 按常数原文转换常数表：前 n 个为原值，后 n 个为紧跟一元负号时取负后的值，只转换实际用到的形式。
+    // 负号与数字字面量一起转换，整数模式下 -9223372036854775808 才能表示（其绝对值本身超出范围）
+    static vector<T> prepareConstants(const CompiledExpression& expr) {
+        const vector<string>& literals = expr.getLiterals();
+        const vector<Instruction>& code = expr.getCode();
+        size_t n = literals.size();
+        vector<T> constants(2 * n);
+        vector<bool> converted(2 * n, false);
+        for (size_t i = 0; i < code.size(); i++) {
+            if (code[i].code != OpCode::PUSH_CONST) continue;
+            size_t index = code[i].index;
+            if (negatedConstant(code, i)) {
+                const string& literal = literals[index];
+                if (!converted[n + index]) {
+                    constants[n + index] = isdigit(static_cast<unsigned char>(literal[0])) || literal[0] == '.'
+                        ? NumericTraits<T>::fromLiteral("-" + literal)
+                        : NumericTraits<T>::applyUnary('-', NumericTraits<T>::fromLiteral(literal));
+                }
+                converted[n + index] = true;
+            } else {
+                if (!converted[index]) constants[index] = NumericTraits<T>::fromLiteral(literals[index]);
+                converted[index] = true;
+            }
+        }
+        return constants;
+    }
+
+    static T evaluate(const CompiledExpression& expr, const vector<T>& constants, const vector<T>& values) {
+        if (!expr.isComplete()) throw runtime_error("表达式不完整 (Incomplete expression)");
+        if (values.size() < expr.getVariables().size()) throw runtime_error("变量取值不足 (Missing variable values)");
+        const vector<Instruction>& code = expr.getCode();
+        size_t n = expr.getLiterals().size();
+        vector<T> stack;
+        stack.reserve(expr.getMaxStackDepth());
+        for (size_t i = 0; i < code.size(); i++) {
+            const Instruction& ins = code[i];
+            switch (ins.code) {
+                case OpCode::PUSH_CONST:
+                    if (negatedConstant(code, i)) {    // 取负后的常数，跳过紧跟的负号
+                        stack.push_back(constants[n + ins.index]);
+                        i++;
+                    } else {
+                        stack.push_back(constants[ins.index]);
+                    }
+                    break;
+                case OpCode::LOAD_VAR:   stack.push_back(values[ins.index]); break;
+                case OpCode::BINARY: {
+                    T b = stack.back();
+                    stack.pop_back();
+                    stack.back() = NumericTraits<T>::applyOperation(stack.back(), b, ins.op);
+                    break;
+                }
+                case OpCode::UNARY:
+                    stack.back() = NumericTraits<T>::applyUnary(ins.op, stack.back());
+                    break;
+            }
+        }
+        return stack.back();
+    }
+
+    static T evaluate(const CompiledExpression& expr, const vector<T>& values = vector<T>()) {
+        return evaluate(expr, prepareConstants(expr), values);
+    }
+
+private:
+    static bool negatedConstant(const vector<Instruction>& code, size_t i) {    // 第 i 条常数指令是否紧跟一元负号
+        return i + 1 < code.size() && code[i + 1].code == OpCode::UNARY && code[i + 1].op == '-';
+    }
+};
+
+template<>
+class NumericEngine<double> {    // double 快速路径：直接使用编译后表达式自身的求值循环
+public:
+    static vector<double> prepareConstants(const CompiledExpression& expr) { return expr.getConstants(); }
+
+    static double evaluate(const CompiledExpression& expr, const vector<double>& constants, const vector<double>& values) {
+        (void)constants;    // 常数表已在编译时转换为 double
+        return expr.evaluate(values);
+    }
+
+    static double evaluate(const CompiledExpression& expr, const vector<double>& values = vector<double>()) {
+        return expr.evaluate(values);
+    }
+};
+
+#endif // NUMERIC_ENGINE_H    // 结束头文件保护
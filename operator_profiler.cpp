@@ -0,0 +1,197 @@
+#include "operator_profiler.h"    // 包含运算分析器头文件
+#include "error_type.h"           // 错误类型
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_RDTSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define PROFILER_RDTSC 1
+#endif
+
+using namespace std;
+
+namespace {
+const char* SLOT_NAMES[OperatorProfiler::SLOT_COUNT] = {
+    "const", "var", "+", "-", "*", "/", "%", "^", "&", "|", "neg", "sin", "cos", "tan", "log"
+};
+}  // namespace
+
+OperatorProfiler::OperatorProfiler(size_t sampleInterval)
+    : sampleInterval(sampleInterval ? sampleInterval : 1), overhead(0) {
+    // 标定：取多次连续读取计数器的最小差值作为固有开销
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t start = readCycles();
+        uint64_t end = readCycles();
+        best = min(best, end - start);
+    }
+    overhead = best;
+}
+
+uint64_t OperatorProfiler::readCycles() {    // 读取周期计数器
+#ifdef PROFILER_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+size_t OperatorProfiler::slotOf(const Instruction& ins) {    // 指令对应的统计槽
+    switch (ins.code) {
+        case OpCode::PUSH_CONST: return 0;
+        case OpCode::LOAD_VAR:   return 1;
+        case OpCode::BINARY:
+            switch (ins.op) {
+                case '+': return 2;
+                case '-': return 3;
+                case '*': return 4;
+                case '/': return 5;
+                case '%': return 6;
+                case '^': return 7;
+                case '&': return 8;
+                default:  return 9;    // '|'
+            }
+        case OpCode::UNARY:
+            switch (ins.op) {
+                case '-': return 10;
+                case 's': return 11;
+                case 'c': return 12;
+                case 't': return 13;
+                default:  return 14;   // 'l'
+            }
+    }
+    return 0;
+}
+
+const char* OperatorProfiler::slotName(size_t slot) {    // 统计槽名称
+    return slot < SLOT_COUNT ? SLOT_NAMES[slot] : "?";
+}
+
+double OperatorProfiler::profile(const CompiledExpression& expr, const vector<double>& values, Slots& slots) const {    // 逐条指令计时求值
+    if (!expr.isComplete()) throw EvaluationError(INVALID_EXPRESSION, "表达式不完整 (Incomplete expression)");
+    if (values.size() < expr.getVariables().size()) throw EvaluationError(INVALID_EXPRESSION, "变量取值不足 (Missing variable values)");
+
+    const vector<double>& constants = expr.getConstants();
+    vector<double> stack(expr.getMaxStackDepth());
+    size_t top = 0;
+    for (const Instruction& ins : expr.getCode()) {
+        uint64_t start = readCycles();
+        switch (ins.code) {
+            case OpCode::PUSH_CONST: stack[top++] = constants[ins.index]; break;
+            case OpCode::LOAD_VAR:   stack[top++] = values[ins.index]; break;
+            case OpCode::BINARY:
+                top--;
+                stack[top - 1] = CompiledExpression::evaluateOperation(stack[top - 1], stack[top], ins.op);
+                break;
+            case OpCode::UNARY:
+                stack[top - 1] = CompiledExpression::evaluateUnary(ins.op, stack[top - 1]);
+                break;
+        }
+        uint64_t elapsed = readCycles() - start;
+        OperatorStats& stats = slots[slotOf(ins)];
+        stats.count++;
+        stats.cycles += elapsed > overhead ? elapsed - overhead : 0;
+    }
+    return stack[0];
+}
+
+double OperatorProfiler::evaluate(const string& formula, const CompiledExpression& expr, const vector<double>& values) {    // 求值并按采样记录
+    // 伪随机抽样，避免固定间隔与周期性的请求序列同步而总抽到同一个公式
+    thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(&state);
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    if (sampleInterval > 1 && state % sampleInterval != 0) return expr.evaluate(values);
+
+    Slots slots;
+    double result = profile(expr, values, slots);
+    lock_guard<mutex> guard(lock);
+    Aggregate& aggregate = profiles[formula];
+    aggregate.evaluations++;
+    for (size_t i = 0; i < SLOT_COUNT; i++) {
+        aggregate.slots[i].count += slots[i].count;
+        aggregate.slots[i].cycles += slots[i].cycles;
+    }
+    return result;
+}
+
+vector<pair<string, OperatorStats>> OperatorProfiler::rank(const Slots& slots) {    // 按总周期排序，省略未出现的运算
+    vector<pair<string, OperatorStats>> ranked;
+    for (size_t i = 0; i < SLOT_COUNT; i++) {
+        if (slots[i].count > 0) ranked.emplace_back(SLOT_NAMES[i], slots[i]);
+    }
+    stable_sort(ranked.begin(), ranked.end(), [](const pair<string, OperatorStats>& a, const pair<string, OperatorStats>& b) {
+        return a.second.cycles > b.second.cycles;
+    });
+    return ranked;
+}
+
+vector<FormulaProfile> OperatorProfiler::formulas() const {    // 各公式的统计
+    vector<FormulaProfile> result;
+    lock_guard<mutex> guard(lock);
+    for (const auto& entry : profiles) {
+        FormulaProfile profile;
+        profile.formula = entry.first;
+        profile.evaluations = entry.second.evaluations;
+        for (const OperatorStats& stats : entry.second.slots) profile.cycles += stats.cycles;
+        profile.operators = rank(entry.second.slots);
+        result.push_back(move(profile));
+    }
+    sort(result.begin(), result.end(), [](const FormulaProfile& a, const FormulaProfile& b) {
+        return a.cycles != b.cycles ? a.cycles > b.cycles : a.formula < b.formula;
+    });
+    return result;
+}
+
+vector<pair<string, OperatorStats>> OperatorProfiler::operators() const {    // 所有公式合计
+    Slots total;
+    lock_guard<mutex> guard(lock);
+    for (const auto& entry : profiles) {
+        for (size_t i = 0; i < SLOT_COUNT; i++) {
+            total[i].count += entry.second.slots[i].count;
+            total[i].cycles += entry.second.slots[i].cycles;
+        }
+    }
+    return rank(total);
+}
+
+string OperatorProfiler::report(size_t topFormulas) const {    // 文本报告
+    ostringstream out;
+    vector<pair<string, OperatorStats>> ops = operators();
+    uint64_t totalCycles = 0;
+    for (const auto& op : ops) totalCycles += op.second.cycles;
+
+    out << "运算开销排名 (Operators by total cost):" << endl;
+    out << left << setw(8) << "op" << right << setw(14) << "count" << setw(18) << "cycles"
+        << setw(12) << "avg" << setw(9) << "share" << endl;
+    for (const auto& op : ops) {
+        double share = totalCycles ? 100.0 * op.second.cycles / totalCycles : 0.0;
+        out << left << setw(8) << op.first << right << setw(14) << op.second.count << setw(18) << op.second.cycles
+            << setw(12) << fixed << setprecision(1) << static_cast<double>(op.second.cycles) / op.second.count
+            << setw(8) << setprecision(1) << share << "%" << endl;
+    }
+
+    vector<FormulaProfile> profiles = formulas();
+    out << endl << "公式开销排名 (Formulas by total cost):" << endl;
+    for (size_t i = 0; i < profiles.size() && i < topFormulas; i++) {
+        const FormulaProfile& profile = profiles[i];
+        out << setw(3) << i + 1 << ". " << profile.cycles << " cycles, " << profile.evaluations << " samples: " << profile.formula << endl;
+        out << "     ";
+        for (size_t j = 0; j < profile.operators.size() && j < 3; j++) {    // 每个公式列出开销最大的三种运算
+            double share = profile.cycles ? 100.0 * profile.operators[j].second.cycles / profile.cycles : 0.0;
+            out << (j ? ", " : "") << profile.operators[j].first << " " << setprecision(1) << share << "%";
+        }
+        out << endl;
+    }
+    return out.str();
+}
+
+void OperatorProfiler::reset() {    // 清空统计
+    lock_guard<mutex> guard(lock);
+    profiles.clear();
+}
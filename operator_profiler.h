@@ -0,0 +1,66 @@
+#ifndef OPERATOR_PROFILER_H    // 防止头文件重复包含
+#define OPERATOR_PROFILER_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include <array>                    // 每种运算的统计
+#include <cstdint>                  // uint64_t
+#include <mutex>                    // 合并统计
+#include <string>                   // 包含字符串处理
+#include <unordered_map>            // 按公式聚合
+#include <utility>                  // pair
+#include <vector>                   // 包含向量容器
+using namespace std;                // 使用标准命名空间
+
+/*按运算符统计求值开销的采样分析器（需显式使用）。
+平均每 sampleInterval 次求值随机抽取一次，逐条指令读取周期计数器（x86 上为 rdtsc，其他平台为纳秒时钟），
+扣除计数器本身的开销后累加到该公式对应运算符的统计中；未被抽中的求值直接走 CompiledExpression::evaluate，没有额外开销。
+一次求值的统计先在局部累加，结束后加锁合并一次，可在多个线程中共用同一个分析器。*/
+
+struct OperatorStats {       // 单种运算的统计
+    uint64_t count = 0;      // 执行次数
+    uint64_t cycles = 0;     // 总周期数
+};
+
+struct FormulaProfile {               // 单个公式的统计
+    string formula;                   // 公式文本
+    uint64_t evaluations = 0;         // 被采样的求值次数
+    uint64_t cycles = 0;              // 总周期数
+    vector<pair<string, OperatorStats>> operators;    // 各运算的统计，按总周期降序
+};
+
+class OperatorProfiler {    // 按运算符统计开销的分析器
+public:
+    static constexpr size_t SLOT_COUNT = 15;    // 常数、变量、8 种二元运算、负号和 4 个函数
+
+    explicit OperatorProfiler(size_t sampleInterval = 1);    // sampleInterval 为 0 或 1 时每次都记录
+
+    // 求值；被抽中时记录每条指令的开销，formula 为聚合用的公式名（通常就是表达式文本）
+    double evaluate(const string& formula, const CompiledExpression& expr, const vector<double>& values = vector<double>());
+
+    vector<FormulaProfile> formulas() const;                   // 各公式的统计，按总周期降序
+    vector<pair<string, OperatorStats>> operators() const;     // 所有公式合计的运算统计，按总周期降序
+    string report(size_t topFormulas = 10) const;              // 文本报告：运算排名与开销最大的公式
+    void reset();                                              // 清空统计
+
+    static uint64_t readCycles();                              // 读取周期计数器
+    static size_t slotOf(const Instruction& ins);              // 指令对应的统计槽
+    static const char* slotName(size_t slot);                  // 统计槽名称
+
+private:
+    using Slots = array<OperatorStats, SLOT_COUNT>;
+
+    struct Aggregate {           // 单个公式的累计统计
+        uint64_t evaluations = 0;
+        Slots slots;
+    };
+
+    size_t sampleInterval;                       // 采样间隔
+    uint64_t overhead;                           // 读取两次计数器的固有开销（周期）
+    mutable mutex lock;                          // 保护 profiles
+    unordered_map<string, Aggregate> profiles;   // 按公式聚合的统计
+
+    double profile(const CompiledExpression& expr, const vector<double>& values, Slots& slots) const;    // 逐条指令计时求值
+    static vector<pair<string, OperatorStats>> rank(const Slots& slots);    // 按总周期排序
+};
+
+#endif // OPERATOR_PROFILER_H    // 结束头文件保护
@@ -0,0 +1,255 @@
+#include "parallel_evaluator.h"    // 包含并行求值器头文件
+#include "error_type.h"            // 错误类型
+#include <atomic>
+#include <exception>
+#include <memory>
+
+using namespace std;
+
+namespace {
+
+// 计算每个结点的子树大小和求值所需的最大栈深度
+vector<size_t> computeSizes(const vector<Instruction>& code, size_t& maxStackDepth) {
+    vector<size_t> sizes(code.size());
+    vector<size_t> stack;    // 子树大小栈
+    maxStackDepth = 0;
+    for (size_t i = 0; i < code.size(); i++) {
+        size_t size = 1;
+        if (code[i].code == OpCode::BINARY) {
+            size += stack.back(); stack.pop_back();
+            size += stack.back(); stack.pop_back();
+        } else if (code[i].code == OpCode::UNARY) {
+            size += stack.back(); stack.pop_back();
+        }
+        stack.push_back(size);
+        sizes[i] = size;
+        if (stack.size() > maxStackDepth) maxStackDepth = stack.size();
+    }
+    return sizes;
+}
+
+struct Tree {    // 后缀指令序列表示的语法树
+    const vector<Instruction>& code;
+    const vector<double>& constants;
+    const vector<double>& values;
+    vector<size_t> sizes;       // 子树大小
+    size_t maxStackDepth;       // 最大栈深度
+    size_t grainSize;           // 顺序求值的阈值
+    vector<char> forkable;      // 子树中是否存在两个孩子都超过阈值的结点
+};
+
+void markForkPoints(Tree& tree) {    // 标记可以分叉的子树，其余子树直接顺序求值
+    const vector<Instruction>& code = tree.code;
+    tree.forkable.assign(code.size(), 0);
+    for (size_t i = 0; i < code.size(); i++) {    // 孩子总在父结点之前
+        if (code[i].code == OpCode::UNARY) {
+            tree.forkable[i] = tree.forkable[i - 1];
+        } else if (code[i].code == OpCode::BINARY) {
+            size_t right = i - 1;
+            size_t left = right - tree.sizes[right];
+            tree.forkable[i] = (tree.sizes[left] > tree.grainSize && tree.sizes[right] > tree.grainSize)
+                || tree.forkable[left] || tree.forkable[right];
+        }
+    }
+}
+
+double evaluateRange(const Tree& tree, size_t root) {    // 在指令区间上顺序求值结点 root 的子树
+    thread_local vector<double> stack;    // 每个线程复用的求值栈
+    if (stack.size() < tree.maxStackDepth) stack.resize(tree.maxStackDepth);
+    size_t top = 0;
+    for (size_t i = root + 1 - tree.sizes[root]; i <= root; i++) {
+        const Instruction& ins = tree.code[i];
+        switch (ins.code) {
+            case OpCode::PUSH_CONST: stack[top++] = tree.constants[ins.index]; break;
+            case OpCode::LOAD_VAR:   stack[top++] = tree.values[ins.index]; break;
+            case OpCode::BINARY:
+                top--;
+                stack[top - 1] = CompiledExpression::evaluateOperation(stack[top - 1], stack[top], ins.op);
+                break;
+            case OpCode::UNARY:
+                stack[top - 1] = CompiledExpression::evaluateUnary(ins.op, stack[top - 1]);
+                break;
+        }
+    }
+    return stack[0];
+}
+
+struct Pending {    // 交给线程池的子树
+    atomic<bool> done{false};
+    double value = 0;
+    exception_ptr error;
+};
+
+double evaluateNode(const Tree& tree, size_t node, WorkStealingPool& pool);
+
+Pending* forkSubtree(const Tree& tree, size_t node, WorkStealingPool& pool, unique_ptr<Pending>& holder) {    // 把子树交给线程池
+    holder = make_unique<Pending>();
+    Pending* pending = holder.get();
+    pool.submit([&tree, node, &pool, pending] {
+        try {
+            pending->value = evaluateNode(tree, node, pool);
+        } catch (...) {
+            pending->error = current_exception();
+        }
+        pending->done.store(true, memory_order_release);
+    });
+    return pending;
+}
+
+/*沿树向下走：只有一个孩子较大时顺序求出小的一个，继续走大的一个；两个孩子都较大时把较小的交给线程池。
+走到不超过阈值或无处分叉的子树后顺序求值，再沿记录的路径自底向上合并。整个过程是循环，不随树高递归。*/
+double evaluateNode(const Tree& tree, size_t node, WorkStealingPool& pool) {
+    enum Kind { UNARY_FRAME, LEFT_KNOWN, RIGHT_KNOWN, LEFT_FORKED, RIGHT_FORKED };
+    struct Frame {
+        size_t node;
+        Kind kind;
+        double value;                // LEFT_KNOWN / RIGHT_KNOWN 时已求出的孩子
+        unique_ptr<Pending> task;    // LEFT_FORKED / RIGHT_FORKED 时交出的孩子
+    };
+    vector<Frame> spine;
+
+    try {
+        double result = 0;
+        while (true) {
+            if (tree.sizes[node] <= tree.grainSize || !tree.forkable[node]) {
+                result = evaluateRange(tree, node);
+                break;
+            }
+            if (tree.code[node].code == OpCode::UNARY) {
+                spine.push_back({node, UNARY_FRAME, 0, nullptr});
+                node = node - 1;
+                continue;
+            }
+            size_t right = node - 1;
+            size_t left = right - tree.sizes[right];
+            bool bigLeft = tree.sizes[left] > tree.grainSize;
+            bool bigRight = tree.sizes[right] > tree.grainSize;
+            if (bigLeft && bigRight) {
+                bool forkLeft = tree.sizes[left] <= tree.sizes[right];
+                spine.push_back({node, forkLeft ? LEFT_FORKED : RIGHT_FORKED, 0, nullptr});
+                forkSubtree(tree, forkLeft ? left : right, pool, spine.back().task);
+                node = forkLeft ? right : left;
+            } else if (bigLeft) {
+                spine.push_back({node, RIGHT_KNOWN, evaluateRange(tree, right), nullptr});
+                node = left;
+            } else {
+                spine.push_back({node, LEFT_KNOWN, evaluateRange(tree, left), nullptr});
+                node = right;
+            }
+        }
+
+        for (auto it = spine.rbegin(); it != spine.rend(); ++it) {    // 自底向上合并
+            const Instruction& ins = tree.code[it->node];
+            if (it->kind == UNARY_FRAME) {
+                result = CompiledExpression::evaluateUnary(ins.op, result);
+                continue;
+            }
+            double other = it->value;
+            if (it->task) {
+                Pending* pending = it->task.get();
+                pool.helpUntil([pending] { return pending->done.load(memory_order_acquire); });
+                if (pending->error) rethrow_exception(pending->error);
+                other = pending->value;
+            }
+            bool otherIsLeft = (it->kind == LEFT_KNOWN || it->kind == LEFT_FORKED);
+            result = otherIsLeft ? CompiledExpression::evaluateOperation(other, result, ins.op)
+                                 : CompiledExpression::evaluateOperation(result, other, ins.op);
+        }
+        return result;
+    } catch (...) {
+        // 出错时也要等所有交出的子树结束，它们引用着树和 Pending
+        for (Frame& frame : spine) {
+            if (!frame.task) continue;
+            Pending* pending = frame.task.get();
+            pool.helpUntil([pending] { return pending->done.load(memory_order_acquire); });
+        }
+        throw;
+    }
+}
+
+}  // namespace
+
+ParallelEvaluator::ParallelEvaluator(const ParallelOptions& options) : options(options), pool(options.threads) {}
+
+double ParallelEvaluator::evaluate(const CompiledExpression& expr, const vector<double>& values) {    // 并行求值
+    if (!expr.isComplete()) throw EvaluationError(INVALID_EXPRESSION, "表达式不完整 (Incomplete expression)");
+    if (values.size() < expr.getVariables().size()) throw EvaluationError(INVALID_EXPRESSION, "变量取值不足 (Missing variable values)");
+
+    vector<Instruction> reordered;
+    if (options.reassociate) reordered = reassociate(expr.getCode());
+    const vector<Instruction>& code = options.reassociate ? reordered : expr.getCode();
+
+    size_t maxStackDepth = 0;
+    vector<size_t> sizes = computeSizes(code, maxStackDepth);
+    Tree tree{code, expr.getConstants(), values, move(sizes), maxStackDepth, options.grainSize > 0 ? options.grainSize : 1, {}};
+    markForkPoints(tree);
+    return evaluateNode(tree, code.size() - 1, pool);
+}
+
+double ParallelEvaluator::evaluate(const string& infix) {    // 编译中缀表达式并并行求值
+    return evaluate(ExpressionCompiler::compileInfix(infix));
+}
+
+/*重排用显式动作栈代替递归：
+SUBTREE 输出一棵子树；遇到 + 或 * 时先按从左到右的顺序收集整条同运算符链的操作数，
+再用 RANGE 二分输出平衡的归约树；EMIT 直接复制一条原指令。*/
+vector<Instruction> ParallelEvaluator::reassociate(const vector<Instruction>& code) {
+    vector<Instruction> out;
+    if (code.empty()) return out;
+    size_t maxStackDepth = 0;
+    vector<size_t> sizes = computeSizes(code, maxStackDepth);
+    out.reserve(code.size());
+
+    enum Kind { SUBTREE, RANGE, EMIT };
+    struct Action {
+        Kind kind;
+        size_t node;     // SUBTREE / EMIT：结点；RANGE：链顶的运算符结点
+        size_t begin;    // RANGE：操作数区间 [begin, end)
+        size_t end;
+    };
+    vector<Action> actions{{SUBTREE, code.size() - 1, 0, 0}};
+    vector<size_t> operands;    // 所有链的操作数（子树根结点），各链占一段连续区间
+    vector<size_t> work;        // 收集链操作数用的栈
+
+    while (!actions.empty()) {
+        Action action = actions.back();
+        actions.pop_back();
+        const Instruction& ins = code[action.node];
+        if (action.kind == EMIT) {
+            out.push_back(ins);
+        } else if (action.kind == RANGE) {
+            if (action.end - action.begin == 1) {
+                actions.push_back({SUBTREE, operands[action.begin], 0, 0});
+            } else {
+                size_t mid = action.begin + (action.end - action.begin) / 2;
+                actions.push_back({EMIT, action.node, 0, 0});
+                actions.push_back({RANGE, action.node, mid, action.end});
+                actions.push_back({RANGE, action.node, action.begin, mid});
+            }
+        } else if (ins.code == OpCode::BINARY && (ins.op == '+' || ins.op == '*')) {
+            size_t begin = operands.size();
+            work.assign(1, action.node);
+            while (!work.empty()) {
+                size_t j = work.back();
+                work.pop_back();
+                if (code[j].code == OpCode::BINARY && code[j].op == ins.op) {
+                    work.push_back(j - 1);                    // 右孩子后处理
+                    work.push_back(j - 1 - sizes[j - 1]);     // 左孩子先处理
+                } else {
+                    operands.push_back(j);
+                }
+            }
+            actions.push_back({RANGE, action.node, begin, operands.size()});
+        } else if (ins.code == OpCode::BINARY) {
+            actions.push_back({EMIT, action.node, 0, 0});
+            actions.push_back({SUBTREE, action.node - 1, 0, 0});
+            actions.push_back({SUBTREE, action.node - 1 - sizes[action.node - 1], 0, 0});
+        } else if (ins.code == OpCode::UNARY) {
+            actions.push_back({EMIT, action.node, 0, 0});
+            actions.push_back({SUBTREE, action.node - 1, 0, 0});
+        } else {
+            out.push_back(ins);
+        }
+    }
+    return out;
+}
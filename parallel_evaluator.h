@@ -0,0 +1,42 @@
+#ifndef PARALLEL_EVALUATOR_H    // 防止头文件重复包含
+#define PARALLEL_EVALUATOR_H    // 定义头文件宏
+
+#include "expression_compiler.h"    // 编译后的表达式
+#include "work_stealing_pool.h"     // 工作窃取线程池
+#include <string>                   // 包含字符串处理
+#include <vector>                   // 包含向量容器
+using namespace std;                // 使用标准命名空间
+
+/*单个超大表达式的并行求值。
+语法树直接用后缀指令序列表示：每条指令就是一个结点，再记录每个结点的子树大小，
+结点 i 的子树恰好是指令区间 [i - size + 1, i]，右孩子为 i - 1，左孩子为 i - 1 - size[i - 1]。
+子树不超过 grainSize 条指令时在区间上顺序求值；两个孩子都较大时，较小的一个作为任务交给线程池，
+当前线程沿较大的一个继续向下（循环而非递归），最后自底向上合并。
+默认不改变运算顺序，结果与顺序求值逐位相同；但 1+1+...+1 这样的左深链没有可并行的子树，
+开启 reassociate 后把 + 和 * 的连续链重排为平衡的归约树，才能用满所有核，代价是浮点舍入可能不同。
+多个子树同时出错时，报告的错误可能与顺序求值报告的不同。*/
+
+struct ParallelOptions {         // 并行求值选项
+    size_t threads = 0;          // 工作线程数，0 表示硬件线程数
+    size_t grainSize = 1 << 14;  // 子树指令数不超过该值时顺序求值
+    bool reassociate = false;    // 是否把 + / * 链重排为平衡归约树（改变浮点舍入，需显式开启）
+};
+
+class ParallelEvaluator {    // 并行求值器
+private:
+    ParallelOptions options;    // 选项
+    WorkStealingPool pool;      // 线程池
+
+public:
+    explicit ParallelEvaluator(const ParallelOptions& options = ParallelOptions());    // 构造函数
+
+    double evaluate(const CompiledExpression& expr, const vector<double>& values = vector<double>());    // 并行求值
+    double evaluate(const string& infix);    // 编译中缀表达式并并行求值
+
+    // 把 + 和 * 的连续链重排为平衡归约树，返回新的后缀指令序列（常数和变量下标不变）
+    static vector<Instruction> reassociate(const vector<Instruction>& code);
+
+    const ParallelOptions& getOptions() const { return options; }    // 获取选项
+};
+
+#endif // PARALLEL_EVALUATOR_H    // 结束头文件保护
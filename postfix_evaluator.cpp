@@ -8,51 +8,9 @@
 
 using namespace std;        
 
-double PostfixEvaluator::evaluateOperation(double a, double b, char op) {    // 执行运算操作
-    switch (op) {
-        case '+': return a + b;                
-        case '-': return a - b;                
-        case '*': return a * b;                
-        case '/':                             
-            if (b == 0) throw runtime_error("除数不能为零 (Division by zero)");    
-            return a / b;
-        case '%': return fmod(a, b);           
-        case '^': return pow(a, b);           
-        case '&': return static_cast<int>(a) & static_cast<int>(b);    
-        case '|': return static_cast<int>(a) | static_cast<int>(b);   
-        case 's': return sin(b);               
-        case 'c': return cos(b);              
-        case 't': return tan(b);               
-        case 'l': return log(b);               
-        default: throw runtime_error("未知运算符 (Unknown operator)");    
-    }
-}
-
-void PostfixEvaluator::displayStack(const string& remainingExpr) const {    // 显示栈的状态
-    cout << "剩余表达式（Remaining expression）: " << remainingExpr << endl;    
-    
-    cout << "数字栈（Number stack）: " << endl;    // 显示数字栈
-    stack<double> tempNum = numberStack;
-    vector<double> nums;
-    while (!tempNum.empty()) {    // 将栈中元素复制到向量中
-        nums.push_back(tempNum.top());
-        tempNum.pop();
-    }
-    for (auto it = nums.begin(); it != nums.end(); ++it) {    // 从栈顶到栈底显示
-        cout << "|" << fixed << setprecision(2) << *it << "|" << endl;
-    }
-    cout << endl;
-    cout << "----------------------------------------" << endl;
-}
-
-void PostfixEvaluator::displayStep(const string& remainingExpr, const string& operation) {    // 显示计算步骤
-    cout << "执行操作 (Operation)： " << operation << endl;
-    displayStack(remainingExpr);
-}
-
 double PostfixEvaluator::evaluate(const string& expression) {    // 求值后缀表达式
     // 清空栈
-    while (!numberStack.empty()) numberStack.pop();
+    clearStack();
     string expr = expression;
     string remainingExpr = expr;
     
@@ -62,8 +20,9 @@ double PostfixEvaluator::evaluate(const string& expression) {    // 求值后缀
         
         if (isspace(c)) continue;
         
-        // 处理数字（包括负数和小数）
-        if (isdigit(c) || c == '-' || c == '.') {
+        // 处理数字（包括负数和小数）；负号后不是数字时为减号，交给运算符分支
+        if (isdigit(c) || c == '.' ||
+            (c == '-' && i + 1 < expr.length() && (isdigit(expr[i + 1]) || expr[i + 1] == '.'))) {
             string numStr;
             bool isNegative = false;
             
@@ -71,9 +30,6 @@ double PostfixEvaluator::evaluate(const string& expression) {    // 求值后缀
             if (c == '-') {
                 isNegative = true;
                 i++;
-                if (i >= expr.length() || (!isdigit(expr[i]) && expr[i] != '.')) {
-                    throw runtime_error("无效的负数格式 (Invalid negative number format)");
-                }
             }
             
             // 收集数字
@@ -111,20 +67,6 @@ double PostfixEvaluator::evaluate(const string& expression) {    // 求值后缀
     return result;
 }
 
-bool PostfixEvaluator::isOperator(char c) const {
-    return c == '+' || c == '-' || c == '*' || c == '/' || c == '%' || 
-           c == '^' || c == '&' || c == '|' || c == 's' || c == 'c' || 
-           c == 't' || c == 'l';
-}
-
-bool PostfixEvaluator::isNumber(char c) const {
-    return (c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E';
-}
-
-bool PostfixEvaluator::isFunction(char c) const {
-    return c == 's' || c == 'c' || c == 't' || c == 'l';
-}
-
 bool PostfixEvaluator::validateExpression(const string& expr) const {
     int numCount = 0;
     int opCount = 0;
@@ -138,12 +80,10 @@ bool PostfixEvaluator::validateExpression(const string& expr) const {
         // 检查负数或小数
         bool isNegative = false;
         if (expr[i] == '-') {
-            // 负号后必须是数字或小数点
+            // 负号后紧跟数字或小数点时为负数，否则为减号，按运算符处理
             if (i + 1 < expr.length() && (isdigit(expr[i + 1]) || expr[i + 1] == '.')) {
                 isNegative = true;
                 i++;
-            } else {
-                return false;
             }
         }
 
@@ -10,47 +10,6 @@
 
 using namespace std;         
 
-double PrefixEvaluator::evaluateOperation(double a, double b, char op) {    // 执行运算操作
-    switch (op) {
-        case '+': return a + b;                
-        case '-': return a - b;                
-        case '*': return a * b;                
-        case '/':                              
-            if (b == 0) throw runtime_error("除数不能为零 (Division by zero)");    
-            return a / b;
-        case '%': return fmod(a, b);           
-        case '^': return pow(a, b);         
-        case '&': return static_cast<int>(a) & static_cast<int>(b);   
-        case '|': return static_cast<int>(a) | static_cast<int>(b);    
-        case 's': return sin(b);               
-        case 'c': return cos(b);               
-        case 't': return tan(b);               
-        case 'l': return log(b);               
-        default: throw runtime_error("未知运算符 (Unknown operator)");    
-    }
-}
-
-void PrefixEvaluator::displayStack(const string& remainingExpr) const {    // 显示栈的状态
-    cout << "剩余表达式（Remaining expression）: " << remainingExpr << endl;    
-    
-    cout << "数字栈（Number stack）: " << endl;    // 显示数字栈
-    stack<double> tempNum = numberStack;
-    vector<double> nums;
-    while (!tempNum.empty()) {    // 将栈中元素复制到向量中
-        nums.push_back(tempNum.top());
-        tempNum.pop();
-    }
-    for (auto it = nums.begin(); it != nums.end(); ++it) {    // 从栈顶到栈底显示
-        cout << "|" << fixed << setprecision(2) << *it << "|" << endl;
-    }
-    cout << endl;
-    cout << "----------------------------------------" << endl;
-}
-
-void PrefixEvaluator::displayStep(const string& remainingExpr, const string& operation) {    // 显示计算步骤
-    cout << "执行操作 (Operation)： " << operation << endl;
-    displayStack(remainingExpr);
-}
 /*从右向左扫描表达式。（这是与前缀计算的关键区别）
 如果遇到操作数，则将其压入栈中。
 如果遇到运算符：
@@ -61,7 +20,7 @@ void PrefixEvaluator::displayStep(const string& remainingExpr, const string& ope
 栈中最后剩下的唯一元素就是整个表达式的最终结果。*/
 double PrefixEvaluator::evaluate(const string& expression) {    // 求值前缀表达式
     // 清空栈
-    while (!numberStack.empty()) numberStack.pop();
+    clearStack();
     // 按空格分割token
     vector<string> tokens;
     istringstream iss(expression);
@@ -79,15 +38,15 @@ double PrefixEvaluator::evaluate(const string& expression) {    // 求值前缀
         if (!tk.empty()) {
             size_t idx = 0;
             if (tk[0] == '-') idx = 1;
-            bool hasDot = false, hasE = false;
+            bool hasDot = false, hasE = false, hasDigit = false;
             for (; idx < tk.size(); ++idx) {
-                if (isdigit(tk[idx])) continue;
+                if (isdigit(tk[idx])) { hasDigit = true; continue; }
                 if (tk[idx] == '.' && !hasDot) { hasDot = true; continue; }
                 if ((tk[idx] == 'e' || tk[idx] == 'E') && !hasE) { hasE = true; continue; }
                 if ((tk[idx] == '+' || tk[idx] == '-') && idx > 0 && (tk[idx-1] == 'e' || tk[idx-1] == 'E')) continue;
                 break;
             }
-            if (idx == tk.size()) isNum = true;
+            if (idx == tk.size() && hasDigit) isNum = true;    // 单独的 "-" 是减号
         }
         if (isNum) {
             double num = stod(tk);
@@ -113,20 +72,6 @@ double PrefixEvaluator::evaluate(const string& expression) {    // 求值前缀
     return result;
 }
 
-bool PrefixEvaluator::isOperator(char c) const {
-    return c == '+' || c == '-' || c == '*' || c == '/' || c == '%' || 
-           c == '^' || c == '&' || c == '|' || c == 's' || c == 'c' || 
-           c == 't' || c == 'l';
-}
-
-bool PrefixEvaluator::isNumber(char c) const {
-    return (c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E';
-}
-
-bool PrefixEvaluator::isFunction(char c) const {
-    return c == 's' || c == 'c' || c == 't' || c == 'l';
-}
-
 bool PrefixEvaluator::validateExpression(const string& expr) const {
     int numCount = 0;
     int opCount = 0;
@@ -140,12 +85,10 @@ bool PrefixEvaluator::validateExpression(const string& expr) const {
         // 检查负数或小数
         bool isNegative = false;
         if (expr[i] == '-') {
-            // 负号后必须是数字或小数点
+            // 负号后紧跟数字或小数点时为负数，否则为减号，按运算符处理
             if (i + 1 < expr.length() && (isdigit(expr[i + 1]) || expr[i + 1] == '.')) {
                 isNegative = true;
                 i++;
-            } else {
-                return false;
             }
         }
 
@@ -0,0 +1,207 @@
+#include "prescan.h"       // 包含预扫描头文件
+#include "char_table.h"    // 共享的字符分类表
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PRESCAN_HAS_AVX2_PATH 1
+#include <immintrin.h>    // AVX2 指令（按函数启用，运行时检测）
+#endif
+
+using namespace std;
+
+namespace {
+
+bool isLegal(char c) {    // 是否为任一求值器可接受的字符
+    unsigned char u = static_cast<unsigned char>(c);
+    return CharTable::classOf(c) != 0 || (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || c == '_';
+}
+
+char matchingOpen(char close) {    // 右括号对应的左括号
+    return close == ')' ? '(' : (close == ']' ? '[' : '{');
+}
+
+/*括号状态：只出现一种括号时只需记录深度；出现第二种括号后才展开成真正的括号栈，
+此前的深度全部是第一种括号，直接填充即可。*/
+struct BracketState {
+    size_t depth = 0;       // 当前深度
+    size_t maxDepth = 0;    // 最大深度
+    char kind = 0;          // 第一种出现的左括号，0 表示还没有括号
+    bool mixed = false;     // 是否出现了多种括号
+    string stack;           // 括号栈（mixed 时有效）
+
+    void open(char c) {    // 处理左括号
+        if (!mixed) {
+            if (kind == 0) kind = c;
+            else if (c != kind) { mixed = true; stack.assign(depth, kind); }
+        }
+        if (mixed) stack.push_back(c);
+        if (++depth > maxDepth) maxDepth = depth;
+    }
+
+    bool close(char c) {    // 处理右括号，不匹配时返回 false
+        char open = matchingOpen(c);
+        if (depth == 0) return false;
+        if (mixed) {
+            if (stack.back() != open) return false;
+            stack.pop_back();
+        } else if (open != kind) {
+            return false;
+        }
+        depth--;
+        return true;
+    }
+
+    // 处理一个字符，遇到错误时写入 result 并返回 false
+    bool step(char c, size_t pos, PrescanResult& result, bool checkIllegal = true) {
+        if (checkIllegal && !isLegal(c)) { result.illegalPos = pos; return false; }
+        if (CharTable::isOpenBracket(c)) open(c);
+        else if (CharTable::isCloseBracket(c) && !close(c)) { result.mismatchPos = pos; return false; }
+        return true;
+    }
+};
+
+PrescanResult finish(const BracketState& state, PrescanResult result) {    // 写入括号统计
+    result.openBrackets = state.depth;
+    result.maxDepth = state.maxDepth;
+    return result;
+}
+
+#ifdef PRESCAN_HAS_AVX2_PATH
+
+__attribute__((target("avx2")))
+__m256i inRange(__m256i v, char lo, char hi) {    // 每个字节是否在 [lo, hi] 内（有符号比较，非 ASCII 字节为负，不在任何范围内）
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), v));
+}
+
+__attribute__((target("avx2")))
+__m256i equals(__m256i v, char c) {
+    return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+
+__attribute__((target("avx2")))
+PrescanResult scanAvx2(const string& expr, bool checkIllegal) {
+    PrescanResult result;
+    BracketState state;
+    const char* p = expr.data();
+    size_t n = expr.size();
+    size_t pos = 0;
+
+    for (; pos + 32 <= n; pos += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + pos));
+
+        // 1. 字符分类
+        __m256i paren = _mm256_or_si256(equals(v, '('), equals(v, ')'));
+        __m256i square = _mm256_or_si256(equals(v, '['), equals(v, ']'));
+        __m256i curly = _mm256_or_si256(equals(v, '{'), equals(v, '}'));
+        __m256i open = _mm256_or_si256(_mm256_or_si256(equals(v, '('), equals(v, '[')), equals(v, '{'));
+        __m256i close = _mm256_or_si256(_mm256_or_si256(equals(v, ')'), equals(v, ']')), equals(v, '}'));
+        __m256i legal = _mm256_or_si256(inRange(v, '0', '9'),
+                        _mm256_or_si256(inRange(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 'z'),
+                        _mm256_or_si256(inRange(v, '\t', '\r'), _mm256_or_si256(open, close))));
+        for (char c : {' ', '_', '.', '+', '-', '*', '/', '%', '^', '&', '|'}) legal = _mm256_or_si256(legal, equals(v, c));
+
+        uint32_t illegalBits = checkIllegal ? ~static_cast<uint32_t>(_mm256_movemask_epi8(legal)) : 0;
+        uint32_t parenBits = static_cast<uint32_t>(_mm256_movemask_epi8(paren));
+        uint32_t squareBits = static_cast<uint32_t>(_mm256_movemask_epi8(square));
+        uint32_t curlyBits = static_cast<uint32_t>(_mm256_movemask_epi8(curly));
+        uint32_t bracketBits = parenBits | squareBits | curlyBits;
+
+        // 2. 没有括号也没有非法字符：整块跳过
+        if (bracketBits == 0 && illegalBits == 0) continue;
+
+        // 3. 块内有非法字符、多种括号，或与之前的括号种类不同：只逐个处理括号位
+        int kinds = (parenBits != 0) + (squareBits != 0) + (curlyBits != 0);
+        char blockKind = parenBits ? '(' : (squareBits ? '[' : '{');
+        if (illegalBits != 0 || state.mixed || kinds > 1 || (state.kind != 0 && state.kind != blockKind)) {
+            uint32_t limit = illegalBits ? static_cast<uint32_t>(__builtin_ctz(illegalBits)) : 32;
+            for (uint32_t bits = bracketBits; bits != 0; bits &= bits - 1) {
+                uint32_t k = static_cast<uint32_t>(__builtin_ctz(bits));
+                if (k >= limit) break;
+                if (!state.step(p[pos + k], pos + k, result)) return finish(state, result);
+            }
+            if (illegalBits != 0) {
+                result.illegalPos = pos + limit;
+                return finish(state, result);
+            }
+            continue;
+        }
+
+        // 4. 单一种类括号：左括号 +1、右括号 -1，块内前缀和得到相对深度
+        if (state.kind == 0) state.kind = blockKind;
+        __m256i depth = _mm256_sub_epi8(close, open);    // 比较结果为 -1，相减得到 +1 / -1
+        depth = _mm256_add_epi8(depth, _mm256_slli_si256(depth, 1));    // 两个 128 位通道内分别做前缀和
+        depth = _mm256_add_epi8(depth, _mm256_slli_si256(depth, 2));
+        depth = _mm256_add_epi8(depth, _mm256_slli_si256(depth, 4));
+        depth = _mm256_add_epi8(depth, _mm256_slli_si256(depth, 8));
+        char lowTotal = static_cast<char>(_mm256_extract_epi8(depth, 15));    // 低通道总和加到高通道
+        depth = _mm256_add_epi8(depth, _mm256_set_m128i(_mm_set1_epi8(lowTotal), _mm_setzero_si128()));
+
+        alignas(32) int8_t prefix[32];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(prefix), depth);
+        uint32_t end = 32;    // 块内有效前缀的长度（多余的右括号之前）
+        if (state.depth < 32) {    // 深度可能变负：找第一个多余的右括号
+            __m256i floor = _mm256_set1_epi8(static_cast<char>(-static_cast<int>(state.depth)));
+            uint32_t negative = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(floor, depth)));
+            if (negative != 0) {
+                end = static_cast<uint32_t>(__builtin_ctz(negative));
+                result.mismatchPos = pos + end;
+            }
+        }
+        if (state.depth + 32 > state.maxDepth) {    // 可能刷新最大深度
+            __m256i best = _mm256_set1_epi8(static_cast<char>(static_cast<int>(state.maxDepth - state.depth)));
+            if (_mm256_movemask_epi8(_mm256_cmpgt_epi8(depth, best)) != 0) {
+                for (uint32_t k = 0; k < end; k++) {
+                    size_t d = state.depth + prefix[k];
+                    if (d > state.maxDepth) state.maxDepth = d;
+                }
+            }
+        }
+        if (end < 32) {    // 与标量实现一致：深度和最大深度只计到多余的右括号之前
+            if (end > 0) state.depth += prefix[end - 1];
+            return finish(state, result);
+        }
+        state.depth += prefix[31];
+    }
+
+    for (; pos < n; pos++) {    // 不足 32 字节的尾部
+        if (!state.step(p[pos], pos, result, checkIllegal)) break;
+    }
+    return finish(state, result);
+}
+
+#endif  // PRESCAN_HAS_AVX2_PATH
+
+}  // namespace
+
+bool Prescan::hasAvx2() {    // 当前 CPU 是否支持 AVX2
+#ifdef PRESCAN_HAS_AVX2_PATH
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+PrescanResult Prescan::scanScalar(const string& expr, bool checkIllegal) {    // 标量实现
+    PrescanResult result;
+    BracketState state;
+    for (size_t i = 0; i < expr.size(); i++) {
+        if (!state.step(expr[i], i, result, checkIllegal)) break;
+    }
+    return finish(state, result);
+}
+
+PrescanResult Prescan::scan(const string& expr) {    // 自动选择实现
+#ifdef PRESCAN_HAS_AVX2_PATH
+    if (hasAvx2()) return scanAvx2(expr, true);
+#endif
+    return scanScalar(expr, true);
+}
+
+PrescanResult Prescan::scanBrackets(const string& expr) {    // 只检查括号
+#ifdef PRESCAN_HAS_AVX2_PATH
+    if (hasAvx2()) return scanAvx2(expr, false);
+#endif
+    return scanScalar(expr, false);
+}
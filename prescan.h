@@ -0,0 +1,39 @@
+#ifndef PRESCAN_H    // 防止头文件重复包含
+#define PRESCAN_H    // 定义头文件宏
+
+#include <string>     // 包含字符串处理
+#include <cstddef>    // size_t
+using namespace std;  // 使用标准命名空间
+
+/*完整解析之前的快速预扫描：一次遍历同时完成字符分类、非法字符查找和括号检查。
+AVX2 实现每次处理 32 字节：
+  1. 用比较指令把 32 个字符分为合法 / 非法、左括号 / 右括号；
+  2. 没有括号的块只检查非法字符，直接跳过；
+  3. 有括号的块把左括号记为 +1、右括号记为 -1，块内做前缀和得到每个位置的相对深度，
+     一次比较即可判断深度是否变负（多余的右括号）并更新最大深度；
+  4. 只有出现多种括号时才需要括号栈检查类型匹配，此时只逐个处理括号所在的位（movemask + ctz）。
+CPU 不支持 AVX2 时自动退回逐字符查表的标量实现，两者结果完全相同。
+合法字符为所有求值器可接受字符的并集：数字、字母、下划线、小数点、运算符、括号和空白。*/
+
+struct PrescanResult {    // 预扫描结果
+    static const size_t npos = string::npos;
+
+    size_t illegalPos = npos;     // 第一个非法字符的位置（npos 表示没有）
+    size_t mismatchPos = npos;    // 第一个多余或类型不匹配的右括号位置（npos 表示没有）
+    size_t openBrackets = 0;      // 扫描结束时尚未闭合的左括号数
+    size_t maxDepth = 0;          // 最大括号嵌套深度
+
+    bool bracketsMatch() const { return mismatchPos == npos && openBrackets == 0; }    // 括号是否完全匹配
+    bool ok() const { return illegalPos == npos && bracketsMatch(); }                  // 是否通过预扫描
+};
+
+class Prescan {    // 预扫描器
+public:
+    // 扫描表达式，遇到第一个错误（非法字符或不匹配的右括号）即停止
+    static PrescanResult scan(const string& expr);            // 自动选择 AVX2 或标量实现
+    static PrescanResult scanBrackets(const string& expr);    // 只检查括号，忽略非法字符
+    static PrescanResult scanScalar(const string& expr, bool checkIllegal = true);    // 标量实现（参考实现与回退）
+    static bool hasAvx2();                                  // 当前 CPU 是否支持 AVX2
+};
+
+#endif // PRESCAN_H    // 结束头文件保护
@@ -1,7 +1,12 @@
 #include "utils.h"       // 包含工具类头文件
+#include "char_table.h"       // 共享的字符分类与优先级表
+#include "prescan.h"          // 向量化括号预扫描
+#include "expression_compiler.h"  // 函数名表
+#include "error_type.h"           // 错误类型
 #include <stack>          
 #include <algorithm>      
 #include <stdexcept>     // 标准异常
+#include <cctype>        // 标识符字符
 
 using namespace std;     
 //采用静态成员，不需要实例化对象，直接可以使用
@@ -10,35 +15,34 @@ const map<string, double> Utils::CONSTANTS = {    // 定义数学常量
     {"e", 2.71828182845904523536}      // 自然对数的底
 };
 
-const map<char, int> Utils::PRECEDENCE = {    //优先级
-    {'+', 1}, {'-', 1},               
-    {'*', 2}, {'/', 2}, {'%', 2},      
-    {'^', 3},                          
-    {'&', 1}, {'|', 1},               
-    {'s', 4}, {'c', 4}, {'t', 4}, {'l', 4},  // 函数（sin, cos, tan, log）
-    {'(', 0}, {')', 0}               
-};
+const map<char, int> Utils::PRECEDENCE = [] {    // 优先级，由共享优先级表生成（内部直接查表）
+    map<char, int> result;
+    for (int c = 0; c < 256; c++) {
+        if (CharTable::PRECEDENCE[c] > 0) result[static_cast<char>(c)] = CharTable::PRECEDENCE[c];
+    }
+    result['('] = 0;
+    result[')'] = 0;
+    return result;
+}();
 
 bool Utils::isOperator(char c) {    
-    return c == '+' || c == '-' || c == '*' || c == '/' || c == '%' || 
-           c == '^' || c == '&' || c == '|' || c == 's' || c == 'c' || 
-           c == 't' || c == 'l';
+    return CharTable::isOperator(c);
 }
 
 bool Utils::isNumber(char c) {   
-    return (c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E';
+    return CharTable::isNumber(c);
 }
 
 bool Utils::isFunction(char c) {  
-    return c == 's' || c == 'c' || c == 't' || c == 'l';
+    return CharTable::isFunction(c);
 }
 
 bool Utils::isSpace(char c) {  
-    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    return CharTable::isSpace(c);
 }
 
 bool Utils::isBracket(char c) {  
-    return c == '(' || c == ')' || c == '[' || c == ']' || c == '{' || c == '}';
+    return CharTable::isBracket(c);
 }
 
 string Utils::standardizeBrackets(const string& expr) {   
@@ -51,25 +55,8 @@ string Utils::standardizeBrackets(const string& expr) {
     return result;
 }
 
-bool Utils::checkBracketMatch(const string& expr) {    // 检查括号匹配
-    stack<char> brackets;    // 括号栈
-    for (char c : expr) {
-        if (c == '(' || c == '[' || c == '{') {    // 入栈
-            brackets.push(c);
-        } else if (c == ')' || c == ']' || c == '}') {    
-            if (brackets.empty()) return false;    // 右括号多余
-            
-            char left = brackets.top();
-            brackets.pop();
-            
-            if ((c == ')' && left != '(') ||      // 检查类型是否匹配
-                (c == ']' && left != '[') ||
-                (c == '}' && left != '{')) {
-                return false;
-            }
-        }
-    }
-    return brackets.empty();    // 都匹配
+bool Utils::checkBracketMatch(const string& expr) {    // 检查括号匹配（向量化预扫描，只看括号）
+    return Prescan::scanBrackets(expr).bracketsMatch();
 }
 
 bool Utils::validateExpression(const string& expr) {    // 验证表达式合法性
@@ -101,76 +88,152 @@ bool Utils::validateExpression(const string& expr) {    // 验证表达式合法
     
     return !lastWasOperator;  // 表达式不能以运算符结尾
 }
-/*用栈保存运算符，遇到数字直接输出。
-遇到运算符，弹出栈中优先级高或相等的运算符，最后将当前运算符入栈。
-遇到括号，左括号入栈，遇到右括号将两括号间符号弹出栈。
-最后把栈中剩余运算符输出。*/
-string Utils::infixToPostfix(const string& expr) {    // 中缀转后缀表达式
-    string result;
-    stack<char> operators;    // 运算符栈
-    
-    for (size_t i = 0; i < expr.length(); i++) {
+/*中缀转前缀 / 后缀用调度场算法（Dijkstra shunting-yard）：运算符栈加子表达式栈，运算符出栈时把操作数拼成前缀或后缀记号串。
+它与 ExpressionCompiler 的 Pratt 解析器相互独立（只共用优先级表），差分测试（fuzz_harness）靠它核对 Pratt 解析的结果。
+规则与求值一致：^ 右结合，其余左结合；期待操作数时的 '-' 是一元负号，优先级介于乘除和 ^ 之间（-2^2 = -(2^2)）；
+三种括号都支持，函数名后跟括号为函数调用。前缀 / 后缀没有一元负号：作用于数字时写成负数（-3），否则写成乘以 -1。
+表达式不合法时抛出 EvaluationError。*/
+namespace {
+
+const char NEGATE = '~';    // 运算符栈中的一元负号
+
+int shuntingPrecedence(char op) {    // 调度场比较用的优先级：二元运算符为 2p，一元负号为 5（介于 * 的 4 与 ^ 的 6 之间）
+    return op == NEGATE ? 5 : 2 * CharTable::precedence(op);
+}
+
+struct Operand {     // 已转换的子表达式
+    string text;     // 前缀或后缀记号串
+    bool literal;    // 是否为单个数字字面量（一元负号直接写成负数）
+};
+
+size_t scanLiteral(const string& expr, size_t pos) {    // 数字字面量的长度（小数点、科学计数法指数），不是数字时为 0
+    size_t i = pos;
+    bool digits = false;
+    while (i < expr.length() && (CharTable::isDigit(expr[i]) || expr[i] == '.')) {
+        digits = digits || expr[i] != '.';
+        i++;
+    }
+    if (!digits) return 0;
+    if (i < expr.length() && (expr[i] == 'e' || expr[i] == 'E')) {
+        size_t j = i + 1;
+        if (j < expr.length() && (expr[j] == '+' || expr[j] == '-')) j++;
+        if (j < expr.length() && CharTable::isDigit(expr[j])) {
+            i = j;
+            while (i < expr.length() && CharTable::isDigit(expr[i])) i++;
+        }
+    }
+    return i - pos;
+}
+
+void apply(vector<Operand>& operands, char op, bool prefix) {    // 弹出运算符 op 的操作数，压入拼好的子表达式
+    if (op == NEGATE || CharTable::isFunction(op)) {
+        if (operands.empty()) throw EvaluationError(INSUFFICIENT_OPERANDS, "表达式有误，操作数不足 (Insufficient operands)");
+        Operand& a = operands.back();
+        if (op == NEGATE && a.literal) a.text = "-" + a.text;    // 负数
+        else if (op == NEGATE) a.text = prefix ? "* -1 " + a.text : a.text + " -1 *";
+        else a.text = prefix ? string(1, op) + " " + a.text : a.text + " " + op;
+        a.literal = false;
+        return;
+    }
+    if (operands.size() < 2) throw EvaluationError(INSUFFICIENT_OPERANDS, "表达式有误，操作数不足 (Insufficient operands)");
+    Operand b = move(operands.back());
+    operands.pop_back();
+    Operand& a = operands.back();
+    a.text = prefix ? string(1, op) + " " + a.text + " " + b.text : a.text + " " + b.text + " " + op;
+    a.literal = false;
+}
+
+string shuntingYard(const string& expr, bool prefix) {    // 调度场转换
+    vector<Operand> operands;    // 子表达式栈
+    string operators;            // 运算符栈：二元运算符、一元负号、函数和左括号
+    bool expectOperand = true;
+
+    size_t i = 0;
+    while ((i = CharTable::skipSpaces(expr, i)) < expr.length()) {
         char c = expr[i];
-        
-        if (isSpace(c)) continue;    // 跳过空白字符
-        
-        if (isNumber(c)) {    // 处理数字
-            while (i < expr.length() && (isNumber(expr[i]) || expr[i] == '.')) {
-                result += expr[i++];    // 收集完整的数字
+        if (expectOperand) {
+            size_t len = scanLiteral(expr, i);
+            if (len > 0) {
+                operands.push_back({expr.substr(i, len), true});
+                i += len;
+                expectOperand = false;
+            } else if (c == '-') {
+                operators.push_back(NEGATE);
+                i++;
+            } else if (CharTable::isOpenBracket(c)) {
+                operators.push_back(c);
+                i++;
+            } else if (isalpha(static_cast<unsigned char>(c)) || c == '_') {
+                size_t start = i;
+                while (i < expr.length() && (isalnum(static_cast<unsigned char>(expr[i])) || expr[i] == '_')) i++;
+                string name = expr.substr(start, i - start);
+                size_t next = CharTable::skipSpaces(expr, i);
+                char func = 0;
+                if (next < expr.length() && CharTable::isOpenBracket(expr[next]) && ExpressionCompiler::isFunctionName(name, func)) {
+                    operators.push_back(func);    // 随后的左括号在下一轮压入
+                } else {
+                    operands.push_back({name, false});    // 常量或变量
+                    expectOperand = false;
+                }
+            } else if (CharTable::isBinaryOperator(c)) {
+                throw EvaluationError(CONSECUTIVE_OPERATORS, "连续运算符错误 (Consecutive operators error)");
+            } else if (CharTable::isCloseBracket(c)) {
+                throw EvaluationError(INSUFFICIENT_OPERANDS, "括号内缺少操作数 (Missing operand in brackets)");
+            } else {
+                throw EvaluationError(INVALID_CHARACTER, string("非法字符 (Invalid character): ") + c);
             }
-            result += ' ';    // 数字之间用空格分隔
-            i--;
-        }
-        else if (isOperator(c)) {    // 处理运算符
-            while (!operators.empty() && operators.top() != '(' &&
-                   PRECEDENCE.at(operators.top()) >= PRECEDENCE.at(c)) {
-                result += operators.top();    // 将优先级高的运算符加入结果
-                result += ' ';
-                operators.pop();
+        } else if (CharTable::isBinaryOperator(c)) {
+            int current = shuntingPrecedence(c);
+            bool rightAssociative = c == '^';
+            while (!operators.empty() && !CharTable::isOpenBracket(operators.back()) && !CharTable::isFunction(operators.back())) {
+                int top = shuntingPrecedence(operators.back());
+                if (top < current || (top == current && rightAssociative)) break;
+                apply(operands, operators.back(), prefix);
+                operators.pop_back();
             }
-            operators.push(c);    // 当前运算符入栈
-        }
-        else if (c == '(') {    // 左括号直接入栈
-            operators.push(c);
-        }
-        else if (c == ')') {    // 处理右括号
-            while (!operators.empty() && operators.top() != '(') {
-                result += operators.top();    // 将括号内的运算符加入结果
-                result += ' ';
-                operators.pop();
+            operators.push_back(c);
+            expectOperand = true;
+            i++;
+        } else if (CharTable::isCloseBracket(c)) {
+            char match = (c == ')') ? '(' : (c == ']') ? '[' : '{';
+            while (!operators.empty() && !CharTable::isOpenBracket(operators.back())) {
+                apply(operands, operators.back(), prefix);
+                operators.pop_back();
             }
-            if (!operators.empty()) operators.pop();  // 弹出左括号
+            if (operators.empty() || operators.back() != match) {
+                throw EvaluationError(MISMATCHED_PARENTHESES, "括号不匹配错误 (Mismatched parentheses)");
+            }
+            operators.pop_back();
+            if (!operators.empty() && CharTable::isFunction(operators.back())) {    // 函数调用
+                apply(operands, operators.back(), prefix);
+                operators.pop_back();
+            }
+            i++;
+        } else {
+            throw EvaluationError(MISSING_OPERATOR, "缺少运算符错误 (Missing operator)");
         }
     }
-    
-    while (!operators.empty()) {    // 处理剩余的运算符
-        result += operators.top();
-        result += ' ';
-        operators.pop();
+
+    if (expectOperand) {
+        if (operands.empty() && operators.empty()) throw EvaluationError(EMPTY_EXPRESSION, "表达式为空 (Empty expression)");
+        throw EvaluationError(INSUFFICIENT_OPERANDS, "表达式不能以运算符结尾 (Expression ends with an operator)");
     }
-    
-    return result;
+    while (!operators.empty()) {
+        if (CharTable::isOpenBracket(operators.back())) throw EvaluationError(MISMATCHED_PARENTHESES, "括号不匹配错误 (Mismatched parentheses)");
+        apply(operands, operators.back(), prefix);
+        operators.pop_back();
+    }
+    return operands.back().text;
 }
-/*先反转表达式，左右括号互换。
-按后缀转换方法处理（即调用 infixToPostfix）。
-得到的后缀表达式再反转，就是前缀表达式。逆向后缀转换处理*/
+
+}  // namespace
+
+string Utils::infixToPostfix(const string& expr) {    // 中缀转后缀表达式
+    return shuntingYard(expr, false);
+}
+
 string Utils::infixToPrefix(const string& expr) {    // 中缀转前缀表达式
-    // 1. 反转表达式
-    string reversed = expr;
-    reverse(reversed.begin(), reversed.end());
-    
-    // 2. 交换括号
-    for (char& c : reversed) {
-        if (c == '(') c = ')';
-        else if (c == ')') c = '(';
-    }
-    
-    // 3. 转换为后缀表达式
-    string postfix = infixToPostfix(reversed);
-    
-    // 4. 再次反转得到前缀表达式
-    reverse(postfix.begin(), postfix.end());
-    return postfix;
+    return shuntingYard(expr, true);
 }
 /*后缀转中缀（postfixToInfix）：遇到数字入栈，遇到运算符弹出两个操作数，拼成(a op b)再入栈。*/
 string Utils::postfixToInfix(const string& expr) {    // 后缀转中缀表达式
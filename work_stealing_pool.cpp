@@ -0,0 +1,81 @@
+#include "work_stealing_pool.h"    // 包含工作窃取线程池头文件
+
+using namespace std;
+
+namespace {
+// 当前线程所属的线程池和队列下标（非工作线程为 nullptr）
+thread_local WorkStealingPool* currentPool = nullptr;
+thread_local size_t currentIndex = 0;
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(size_t threads) : stopping(false), nextQueue(0), pending(0) {
+    if (threads == 0) threads = thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; i++) queues.push_back(make_unique<Queue>());
+    for (size_t i = 0; i < threads; i++) workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (thread& worker : workers) worker.join();
+}
+
+void WorkStealingPool::submit(Task task) {    // 提交任务
+    // 工作线程放入自己的队列，外部线程轮流分配到各个队列
+    size_t index = (currentPool == this) ? currentIndex : nextQueue.fetch_add(1) % queues.size();
+    {
+        lock_guard<mutex> guard(sleepLock);
+        pending++;    // 先计数再入队，取走任务时计数不会先于入队减少
+    }
+    {
+        lock_guard<mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(move(task));
+    }
+    wakeUp.notify_one();
+}
+
+bool WorkStealingPool::popTask(Task& task) {    // 取任务：先自己的队列尾部，再窃取其他队列头部
+    size_t self = (currentPool == this) ? currentIndex : 0;
+    size_t count = queues.size();
+    for (size_t k = 0; k < count; k++) {
+        size_t index = (self + k) % count;
+        Queue& queue = *queues[index];
+        lock_guard<mutex> guard(queue.lock);
+        if (queue.tasks.empty()) continue;
+        if (k == 0 && currentPool == this) {
+            task = move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+
+bool WorkStealingPool::runPendingTask() {    // 取出并执行一个任务
+    Task task;
+    if (!popTask(task)) return false;
+    {
+        lock_guard<mutex> guard(sleepLock);
+        pending--;
+    }
+    task();
+    return true;
+}
+
+void WorkStealingPool::workerLoop(size_t index) {    // 工作线程主循环
+    currentPool = this;
+    currentIndex = index;
+    while (true) {
+        if (runPendingTask()) continue;
+        unique_lock<mutex> guard(sleepLock);
+        wakeUp.wait(guard, [this] { return stopping || pending > 0; });
+        if (stopping) return;
+    }
+}
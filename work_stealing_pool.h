@@ -0,0 +1,59 @@
+#ifndef WORK_STEALING_POOL_H    // 防止头文件重复包含
+#define WORK_STEALING_POOL_H    // 定义头文件宏
+
+#include <functional>            // 任务类型
+#include <vector>                // 包含向量容器
+#include <deque>                 // 双端队列
+#include <memory>                // unique_ptr
+#include <thread>                // 工作线程
+#include <mutex>                 // 互斥锁
+#include <condition_variable>    // 空闲线程休眠
+#include <atomic>                // 原子计数
+using namespace std;             // 使用标准命名空间
+
+/*工作窃取线程池：每个工作线程有自己的任务队列。
+工作线程提交的任务放在自己队列的尾部，自己也从尾部取（后进先出，缓存友好）；
+自己的队列空了就从其他线程队列的头部窃取（先进先出，偷到的通常是较大的任务）。
+等待子任务完成的线程不阻塞，而是用 helpUntil 继续执行队列中的任务，因此嵌套的分叉-合并不会死锁。
+析构时丢弃尚未开始的任务，调用者应在析构前等待自己提交的任务完成。*/
+
+class WorkStealingPool {    // 工作窃取线程池
+public:
+    using Task = function<void()>;    // 任务（不得抛出异常，异常应由任务自行捕获）
+
+    explicit WorkStealingPool(size_t threads = 0);    // threads 为 0 时使用硬件线程数
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task);       // 提交任务
+    bool runPendingTask();        // 取出并执行一个任务，没有任务时返回 false
+    size_t size() const { return workers.size(); }    // 工作线程数
+
+    template<typename Predicate>
+    void helpUntil(Predicate done) {    // 等待条件成立，等待期间帮助执行其他任务
+        while (!done()) {
+            if (!runPendingTask()) this_thread::yield();
+        }
+    }
+
+private:
+    struct Queue {          // 单个工作线程的任务队列
+        mutex lock;
+        deque<Task> tasks;
+    };
+
+    vector<unique_ptr<Queue>> queues;    // 每个工作线程一个队列
+    vector<thread> workers;              // 工作线程
+    atomic<bool> stopping;               // 是否正在停止
+    atomic<size_t> nextQueue;            // 外部线程提交任务时轮流选择的队列
+    mutex sleepLock;                     // 保护 pending 与休眠
+    condition_variable wakeUp;           // 有新任务时唤醒空闲线程
+    size_t pending;                      // 尚未被取走的任务数（受 sleepLock 保护）
+
+    bool popTask(Task& task);            // 从自己的队列尾部取，或从其他队列头部窃取
+    void workerLoop(size_t index);       // 工作线程主循环
+};
+
+#endif // WORK_STEALING_POOL_H    // 结束头文件保护